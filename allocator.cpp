@@ -0,0 +1,251 @@
+#include "allocator.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cpu_features.h"
+#include "timer.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace {
+
+constexpr size_t HUGE_2M = size_t(2) << 20;
+constexpr size_t HUGE_1G = size_t(1) << 30;
+
+size_t round_up(size_t value, size_t align) {
+    return (value + align - 1) / align * align;
+}
+
+bool is_power_of_two(size_t value) {
+    return value && (value & (value - 1)) == 0;
+}
+
+} // namespace
+
+const char* page_mode_name(PageMode mode) {
+    switch (mode) {
+        case PageMode::Default: return "default";
+        case PageMode::Transparent: return "thp";
+        case PageMode::Huge2M: return "2m";
+        case PageMode::Huge1G: return "1g";
+    }
+    return "?";
+}
+
+bool parse_page_mode(const std::string& text, PageMode& mode) {
+    for (PageMode m : {PageMode::Default, PageMode::Transparent, PageMode::Huge2M, PageMode::Huge1G}) {
+        if (text == page_mode_name(m)) {
+            mode = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t default_alignment() {
+    return std::max<size_t>(64, cpu_features().sve_vector_bytes);
+}
+
+Allocation::Allocation(size_t bytes, const AllocPolicy& policy)
+    : bytes_(bytes),
+      alignment_(policy.alignment ? policy.alignment : default_alignment()),
+      requested_(policy.pages),
+      effective_(policy.pages) {
+    if (!is_power_of_two(alignment_)) {
+        throw std::invalid_argument("Allocation alignment must be a power of two");
+    }
+    const size_t request = std::max<size_t>(bytes, 1);
+
+    // 1. 显式大页：hugetlbfs 预留池不够时 mmap 返回 ENOMEM，退回 THP
+    if (effective_ == PageMode::Huge2M || effective_ == PageMode::Huge1G) {
+        const bool is_1g = effective_ == PageMode::Huge1G;
+        const size_t page = is_1g ? HUGE_1G : HUGE_2M;
+        const size_t length = round_up(request, page);
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (is_1g ? MAP_HUGE_1GB : MAP_HUGE_2MB), -1, 0);
+        if (p != MAP_FAILED) {
+            map_base_ = data_ = p;
+            map_bytes_ = length;
+        } else {
+            note_ = std::string("MAP_HUGETLB ") + page_mode_name(effective_) + " failed (" + std::strerror(errno) +
+                    "), using thp";
+            effective_ = PageMode::Transparent;
+        }
+    }
+
+    // 2. THP：多映射 2MB 以便把起点对齐到大页边界，再 madvise
+    if (effective_ == PageMode::Transparent) {
+        const size_t length = round_up(request, HUGE_2M) + HUGE_2M;
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        map_base_ = p;
+        map_bytes_ = length;
+        data_ = reinterpret_cast<void*>(round_up(reinterpret_cast<uintptr_t>(p), HUGE_2M));
+        if (madvise(data_, round_up(request, HUGE_2M), MADV_HUGEPAGE) != 0) {
+            note_ += std::string(note_.empty() ? "" : "; ") + "madvise(MADV_HUGEPAGE) failed: " + std::strerror(errno);
+        }
+    }
+
+    // 3. 普通对齐分配
+    if (effective_ == PageMode::Default) {
+        data_ = std::aligned_alloc(alignment_, round_up(request, alignment_));
+        if (data_ == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+
+    if (policy.lock) {
+        if (mlock(data_, request) == 0) {
+            locked_ = true;
+        } else {
+            note_ += std::string(note_.empty() ? "" : "; ") + "mlock failed: " + std::strerror(errno);
+        }
+    }
+}
+
+Allocation::Allocation(size_t bytes, const AllocPolicy& policy, const std::string& path, bool populate)
+    : bytes_(bytes),
+      alignment_(static_cast<size_t>(sysconf(_SC_PAGESIZE))),
+      requested_(policy.pages),
+      effective_(PageMode::Default),
+      path_(path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open input file " + path + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < bytes) {
+        close(fd);
+        throw std::runtime_error("Input file " + path + " is smaller than " + std::to_string(bytes) + " bytes");
+    }
+    const size_t length = std::max<size_t>(bytes, 1);
+    const PageFaults faults0 = process_page_faults();
+    const uint64_t t0 = read_ticks();
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+    const int map_errno = errno;
+    map_seconds_ = timer_info().seconds(read_ticks() - t0);
+    map_faults_ = process_page_faults() - faults0;
+    close(fd); // 映射建立后文件描述符不再需要
+    if (p == MAP_FAILED) {
+        throw std::runtime_error("mmap " + path + " failed: " + std::strerror(map_errno));
+    }
+    map_base_ = data_ = p;
+    map_bytes_ = length;
+
+    if (requested_ == PageMode::Huge2M || requested_ == PageMode::Huge1G) {
+        note_ = std::string(page_mode_name(requested_)) + " pages are not available for file mappings, using thp hint";
+    }
+    if (requested_ != PageMode::Default) {
+        effective_ = PageMode::Transparent;
+        if (madvise(data_, length, MADV_HUGEPAGE) != 0) {
+            note_ += std::string(note_.empty() ? "" : "; ") + "madvise(MADV_HUGEPAGE) failed: " + std::strerror(errno);
+        }
+    }
+    if (policy.lock) {
+        if (mlock(data_, length) == 0) {
+            locked_ = true;
+        } else {
+            note_ += std::string(note_.empty() ? "" : "; ") + "mlock failed: " + std::strerror(errno);
+        }
+    }
+}
+
+Allocation::~Allocation() {
+    if (locked_) {
+        munlock(data_, std::max<size_t>(bytes_, 1));
+    }
+    if (map_base_) {
+        munmap(map_base_, map_bytes_);
+    } else {
+        std::free(data_);
+    }
+}
+
+size_t Allocation::huge_page_bytes() const {
+    if (effective_ == PageMode::Huge2M || effective_ == PageMode::Huge1G) {
+        return bytes_;
+    }
+
+    // 在 smaps 里找与 [data, data + bytes) 重叠的 VMA，累加其 AnonHugePages。
+    // 相邻的匿名映射可能被内核合并成一个 VMA，此时按重叠比例折算，结果是估计值
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(data_);
+    const uintptr_t end = begin + bytes_;
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    uintptr_t vma_begin = 0, vma_end = 0;
+    double total = 0.0;
+    while (std::getline(smaps, line)) {
+        unsigned long long lo, hi;
+        if (std::sscanf(line.c_str(), "%llx-%llx ", &lo, &hi) == 2 && line.find(':') > line.find(' ')) {
+            vma_begin = lo;
+            vma_end = hi;
+            continue;
+        }
+        unsigned long long kb;
+        // 私有文件映射被写过的页是匿名页，其余的是页缓存（tmpfs 为 Shmem）
+        if ((std::sscanf(line.c_str(), "AnonHugePages: %llu kB", &kb) == 1 ||
+             std::sscanf(line.c_str(), "FilePmdMapped: %llu kB", &kb) == 1 ||
+             std::sscanf(line.c_str(), "ShmemPmdMapped: %llu kB", &kb) == 1) && kb > 0) {
+            uintptr_t lo_overlap = std::max(begin, vma_begin);
+            uintptr_t hi_overlap = std::min(end, vma_end);
+            if (lo_overlap < hi_overlap) {
+                double fraction = static_cast<double>(hi_overlap - lo_overlap) / (vma_end - vma_begin);
+                total += kb * 1024.0 * fraction;
+            }
+        }
+    }
+    return std::min(static_cast<size_t>(total), bytes_);
+}
+
+PageFaults process_page_faults() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return {};
+    }
+    return {usage.ru_minflt, usage.ru_majflt};
+}
+
+size_t file_float_count(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        throw std::runtime_error("Cannot open input file " + path + ": " + std::strerror(errno));
+    }
+    return static_cast<size_t>(st.st_size) / sizeof(float);
+}
+
+std::string transparent_hugepage_setting() {
+    // 格式形如 "always [madvise] never"
+    std::ifstream in("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string text;
+    std::getline(in, text);
+    size_t open = text.find('[');
+    size_t close = text.find(']', open);
+    if (open == std::string::npos || close == std::string::npos) {
+        return "unknown";
+    }
+    return text.substr(open + 1, close - open - 1);
+}
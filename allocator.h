@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief 向量内存使用的页面类型
+ *
+ * - Default:     aligned_alloc，页面大小由系统 THP 全局设置决定
+ * - Transparent: mmap 匿名映射，按 2MB 对齐后 madvise(MADV_HUGEPAGE)
+ * - Huge2M:      mmap(MAP_HUGETLB | MAP_HUGE_2MB)，需要预留的 hugetlbfs 页面
+ * - Huge1G:      mmap(MAP_HUGETLB | MAP_HUGE_1GB)
+ *
+ * 显式大页分配失败（没有预留页面）时退回 Transparent，并在 note 中说明。
+ */
+enum class PageMode {
+    Default,
+    Transparent,
+    Huge2M,
+    Huge1G,
+};
+
+const char* page_mode_name(PageMode mode);
+
+// 接受 default | thp | 2m | 1g，失败返回 false
+bool parse_page_mode(const std::string& text, PageMode& mode);
+
+struct AllocPolicy {
+    PageMode pages = PageMode::Default;
+    size_t alignment = 0;   // 字节，2 的幂；0 表示自动：max(64, SVE 向量长度)
+    bool lock = false;      // mlock 整个缓冲区，避免被换出
+};
+
+// 自动对齐：缓存行和向量长度中较大的一个
+size_t default_alignment();
+
+/**
+ * @brief 进程累计的缺页次数（getrusage）：minor 不需要 I/O，major 需要从磁盘读入
+ */
+struct PageFaults {
+    long long minor = 0;
+    long long major = 0;
+
+    PageFaults operator-(const PageFaults& other) const { return {minor - other.minor, major - other.major}; }
+};
+
+PageFaults process_page_faults();
+
+/**
+ * @brief 按 AllocPolicy 分配的一块内存；析构时按对应方式释放
+ *
+ * 内容不做初始化：由调用方按 NUMA 划分做首次访问。
+ * 也可以是一个文件的前 bytes 字节的私有映射（MAP_PRIVATE，写入只改本进程的副本）。
+ */
+class Allocation {
+public:
+    Allocation(size_t bytes, const AllocPolicy& policy);
+
+    /**
+     * @brief 映射文件 path 的前 bytes 字节
+     *
+     * populate 时加 MAP_POPULATE，在 mmap 内预先读入并建立全部页表；
+     * pages 为 thp 时对映射做 madvise(MADV_HUGEPAGE)（只对 tmpfs 或开启了 READ_ONLY_THP_FOR_FS
+     * 的文件系统有效），显式大页对普通文件不可用，退回 thp 提示并在 note 中说明。
+     * 文件打不开或不足 bytes 字节时抛出 std::runtime_error。
+     */
+    Allocation(size_t bytes, const AllocPolicy& policy, const std::string& path, bool populate);
+    ~Allocation();
+
+    Allocation(const Allocation&) = delete;
+    Allocation& operator=(const Allocation&) = delete;
+
+    template <typename T>
+    T* as() const { return static_cast<T*>(data_); }
+
+    size_t size() const { return bytes_; }
+    size_t alignment() const { return alignment_; }
+    PageMode requested() const { return requested_; }
+    PageMode effective() const { return effective_; }
+    bool locked() const { return locked_; }
+    const std::string& note() const { return note_; }
+    // 映射的文件；匿名内存为空
+    const std::string& path() const { return path_; }
+    // 文件映射时 mmap（含 MAP_POPULATE 预读）的耗时和期间的缺页；匿名内存为 0
+    double map_seconds() const { return map_seconds_; }
+    const PageFaults& map_faults() const { return map_faults_; }
+
+    /**
+     * @brief 当前实际落在大页上的字节数（读 /proc/self/smaps；显式大页按整个映射计，
+     *        文件映射统计 FilePmdMapped / ShmemPmdMapped）
+     *
+     * 只在首次访问之后才有意义。
+     */
+    size_t huge_page_bytes() const;
+
+private:
+    void* data_ = nullptr;
+    size_t bytes_ = 0;
+    void* map_base_ = nullptr;   // mmap 返回的地址；aligned_alloc 时为 nullptr
+    size_t map_bytes_ = 0;
+    size_t alignment_ = 0;
+    PageMode requested_ = PageMode::Default;
+    PageMode effective_ = PageMode::Default;
+    bool locked_ = false;
+    std::string note_;
+    std::string path_;
+    double map_seconds_ = 0.0;
+    PageFaults map_faults_;
+};
+
+/**
+ * @brief 文件能容纳的 float 个数（文件大小 / 4）；打不开时抛出 std::runtime_error
+ */
+size_t file_float_count(const std::string& path);
+
+/**
+ * @brief 系统 THP 设置（/sys/kernel/mm/transparent_hugepage/enabled 中被选中的值）
+ */
+std::string transparent_hugepage_setting();
@@ -0,0 +1,387 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include "batch_backends.h"
+#include "cpu_features.h"
+#include "saxpy.h"
+#include "timer.h"
+#include "trace.h"
+
+namespace {
+
+// percall 基线使用的单向量内核：与不指定 --kernel 时的默认 SAXPY 内核相同
+SaxpyFn percall_fn = nullptr;
+
+// 逐个调用：每个向量都经过一次间接调用、对齐检查和循环准备，相当于应用层把 saxpy 放在循环里
+void percall_items(const SaxpyBatchItem* items, size_t count) {
+    const SaxpyFn fn = percall_fn;
+    for (size_t k = 0; k < count; ++k) {
+        fn(items[k].a, items[k].x, items[k].y_in, items[k].y_out, items[k].n);
+    }
+}
+
+void percall_strided(const float* a, const float* x, const float* y_in, float* y_out,
+                     uint64_t n, uint64_t stride, size_t count) {
+    const SaxpyFn fn = percall_fn;
+    for (size_t k = 0; k < count; ++k) {
+        fn(a[k], x + k * stride, y_in + k * stride, y_out + k * stride, n);
+    }
+}
+
+// 向量起点按 64 字节（16 个 float）对齐
+constexpr size_t ALIGN_ELEMS = 64 / sizeof(float);
+
+size_t round_up(size_t n) {
+    return (n + ALIGN_ELEMS - 1) / ALIGN_ELEMS * ALIGN_ELEMS;
+}
+
+// 不规则批的长度：固定种子的 LCG，保证每次运行的形状相同
+std::vector<size_t> batch_lengths(const BatchShape& shape) {
+    std::vector<size_t> lengths(shape.count, shape.min_n);
+    if (shape.uniform()) {
+        return lengths;
+    }
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    const uint64_t span = shape.max_n - shape.min_n + 1;
+    for (size_t& n : lengths) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        n = shape.min_n + static_cast<size_t>((state >> 33) % span);
+    }
+    return lengths;
+}
+
+size_t total_padded(const BatchShape& shape) {
+    size_t total = 0;
+    for (size_t n : batch_lengths(shape)) {
+        total += round_up(n);
+    }
+    return std::max<size_t>(total, 1);
+}
+
+inline float reference(float a, float x, float y0) {
+    return static_cast<float>(static_cast<double>(a) * x + y0);
+}
+
+// 工作窃取的任务：把每个线程的描述符区间切成元素数约为 grain 的连续小段，不拆开向量
+std::shared_ptr<WorkStealingScheduler> batch_scheduler(const SaxpyBatchItem* items, const std::vector<Range>& chunks,
+                                                       size_t grain) {
+    grain = std::max<size_t>(grain, 1);
+    std::vector<Range> tasks;
+    std::vector<uint64_t> sizes;
+    std::vector<Range> owned;
+    for (const Range& chunk : chunks) {
+        const size_t first = tasks.size();
+        size_t begin = chunk.begin;
+        uint64_t elements = 0;
+        for (size_t k = chunk.begin; k < chunk.end; ++k) {
+            elements += items[k].n;
+            if (elements >= grain || k + 1 == chunk.end) {
+                tasks.push_back({begin, k + 1});
+                sizes.push_back(elements);
+                begin = k + 1;
+                elements = 0;
+            }
+        }
+        owned.push_back({first, tasks.size()});
+    }
+    return std::make_shared<WorkStealingScheduler>(std::move(tasks), std::move(sizes), owned);
+}
+
+} // namespace
+
+const std::vector<SaxpyBatchKernel>& saxpy_batch_kernels() {
+    static const std::vector<SaxpyBatchKernel> kernels = [] {
+        const CpuFeatures& cpu = cpu_features();
+        std::vector<SaxpyBatchKernel> out;
+        if (cpu.sve) {
+            out.insert(out.end(), sve_batch_table().begin(), sve_batch_table().end());
+        }
+        if (cpu.avx512f) {
+            out.insert(out.end(), avx512_batch_table().begin(), avx512_batch_table().end());
+        }
+        out.insert(out.end(), autovec_batch_table().begin(), autovec_batch_table().end());
+        percall_fn = saxpy_kernels().front().fn;
+        out.push_back({"percall", saxpy_kernels().front().backend,
+                       "one call of the default SAXPY kernel per vector", percall_items, percall_strided});
+        return out;
+    }();
+    return kernels;
+}
+
+void saxpy_batch(const SaxpyBatchItem* items, size_t count) {
+    saxpy_batch_kernels().front().items(items, count);
+}
+
+void saxpy_batch_strided(const float* a, const float* x, const float* y_in, float* y_out,
+                         uint64_t n, uint64_t stride, size_t count) {
+    saxpy_batch_kernels().front().strided(a, x, y_in, y_out, n, stride, count);
+}
+
+std::vector<Range> partition_batch(const SaxpyBatchItem* items, size_t count, size_t parts) {
+    std::vector<Range> ranges;
+    if (parts == 0) {
+        return ranges;
+    }
+    uint64_t total = 0;
+    for (size_t k = 0; k < count; ++k) {
+        total += items[k].n;
+    }
+    // 第 p 段在累计元素数越过 total * (p + 1) / parts 时结束
+    size_t begin = 0;
+    uint64_t done = 0;
+    for (size_t p = 0; p < parts; ++p) {
+        const uint64_t target = total * (p + 1) / parts;
+        size_t end = begin;
+        while (end < count && (done < target || p + 1 == parts)) {
+            done += items[end].n;
+            ++end;
+        }
+        ranges.push_back({begin, end});
+        begin = end;
+    }
+    return ranges;
+}
+
+void saxpy_batch_parallel(ThreadPool& pool, const SaxpyBatchKernel& kernel,
+                          const SaxpyBatchItem* items, size_t count, Schedule schedule, size_t steal_grain) {
+    const std::vector<Range> parts = partition_batch(items, count, pool.size());
+    if (schedule == Schedule::Steal) {
+        const auto scheduler = batch_scheduler(items, parts, steal_grain);
+        pool.run([&](size_t tid) {
+            scheduler->run(tid, [&](const Range& r) { kernel.items(items + r.begin, r.size()); });
+        });
+        return;
+    }
+    pool.run([&](size_t tid) {
+        const Range& r = parts[tid];
+        if (r.size() > 0) {
+            kernel.items(items + r.begin, r.size());
+        }
+    });
+}
+
+std::string BatchShape::name() const {
+    std::string out = std::to_string(count) + "x" + std::to_string(min_n);
+    if (!uniform()) {
+        out += "-" + std::to_string(max_n);
+    }
+    return out;
+}
+
+std::vector<BatchShape> parse_batch_shapes(const std::string& list) {
+    // 默认形状：极短和几百个元素的向量，各有一组留在 L2 内（看调用开销）、
+    // 一组大几十倍的（看带宽），外加一个不规则批
+    const std::string spec = list == "default" || list == "1"
+                                 ? "4096x16,512x256,65536x16,16384x256,16384x64-512" : list;
+
+    std::vector<BatchShape> shapes;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        BatchShape shape;
+        char* end = nullptr;
+        const unsigned long long count = std::strtoull(item.c_str(), &end, 10);
+        bool ok = end != item.c_str() && (*end == 'x' || *end == 'X') && count > 0;
+        if (ok) {
+            const char* len = end + 1;
+            const unsigned long long lo = std::strtoull(len, &end, 10);
+            unsigned long long hi = lo;
+            ok = end != len && lo > 0;
+            if (ok && *end == '-') {
+                const char* upper = end + 1;
+                hi = std::strtoull(upper, &end, 10);
+                ok = end != upper && hi >= lo;
+            }
+            ok = ok && *end == '\0';
+            shape.count = static_cast<size_t>(count);
+            shape.min_n = static_cast<size_t>(lo);
+            shape.max_n = static_cast<size_t>(hi);
+        }
+        if (!ok) {
+            throw std::runtime_error("Invalid batch shape '" + item + "' (expected COUNTxN or COUNTxMIN-MAX, e.g. 16384x256)");
+        }
+        shapes.push_back(shape);
+    }
+    if (shapes.empty()) {
+        throw std::runtime_error("Batch shape list must not be empty.");
+    }
+    return shapes;
+}
+
+const char* batch_layout_name(BatchLayout layout) {
+    return layout == BatchLayout::Items ? "items" : "strided";
+}
+
+BatchWorkspace::BatchWorkspace(ThreadPool& pool, const BatchShape& shape, float a, const AllocPolicy& policy)
+    : shape_(shape),
+      x_(total_padded(shape) * sizeof(float), policy),
+      y_(total_padded(shape) * sizeof(float), policy),
+      y_original_(total_padded(shape) * sizeof(float), policy) {
+    const std::vector<size_t> lengths = batch_lengths(shape);
+    stride_ = shape.uniform() ? round_up(shape.min_n) : 0;
+    offsets_.resize(shape.count + 1, 0);
+    scalars_.resize(shape.count);
+    in_place_.resize(shape.count);
+    out_of_place_.resize(shape.count);
+    for (size_t k = 0; k < shape.count; ++k) {
+        offsets_[k + 1] = offsets_[k] + round_up(lengths[k]);
+        elements_ += lengths[k];
+        // 每个向量有自己的系数，确认内核没有把第一个向量的 a 用到整批
+        scalars_[k] = a + static_cast<float>(k % 3) - 1.0f;
+        float* xk = x() + offsets_[k];
+        float* yk = y() + offsets_[k];
+        in_place_[k] = {scalars_[k], xk, yk, yk, lengths[k]};
+        out_of_place_[k] = {scalars_[k], xk, y_original() + offsets_[k], yk, lengths[k]};
+    }
+    chunks_ = partition_batch(in_place_.data(), shape.count, pool.size());
+
+    // 与 Workspace 相同的首次访问策略：负责这段向量的线程写入初始值（含对齐填充）
+    const uint64_t t0 = read_ticks();
+    pool.run([&](size_t tid) {
+        TraceScope scope("first touch", "setup");
+        const Range& r = chunks_[tid];
+        float* xs = x();
+        float* ys = y();
+        float* y0 = y_original();
+        for (size_t k = r.begin; k < r.end; ++k) {
+            for (size_t i = offsets_[k], j = 0; i < offsets_[k + 1]; ++i, ++j) {
+                xs[i] = static_cast<float>(j);
+                y0[i] = static_cast<float>(k % 1024);
+                ys[i] = y0[i];
+            }
+        }
+    });
+    init_seconds_ = timer_info().seconds(read_ticks() - t0);
+}
+
+std::vector<Range> BatchWorkspace::element_chunks() const {
+    // 起点是该段在数组中的位置，size() 是其中的有效元素数（不含对齐填充）
+    std::vector<Range> out;
+    for (const Range& r : chunks_) {
+        size_t elems = 0;
+        for (size_t k = r.begin; k < r.end; ++k) {
+            elems += in_place_[k].n;
+        }
+        out.push_back({offsets_[r.begin], offsets_[r.begin] + elems});
+    }
+    return out;
+}
+
+MemoryInfo BatchWorkspace::memory() const {
+    return describe_memory({&x_, &y_, &y_original_}, init_seconds_);
+}
+
+Workload batch_workload(BatchWorkspace& ws, const SaxpyBatchKernel& kernel, BatchLayout layout,
+                        const BenchConfig& config) {
+    Workload work;
+    work.elements = ws.elements();
+    work.flops_per_element = 2.0;
+    work.bytes_per_element = SAXPY_BYTES_PER_ELEMENT;
+    work.footprint_bytes_per_element = static_cast<double>(footprint_bytes_per_element(config.mode));
+    const MeasureMode mode = config.mode;
+    if (mode == MeasureMode::Kernel) {
+        work.reset_bytes_per_element = 2.0 * sizeof(float);
+        work.reset = [&ws](size_t tid) {
+            const Range& r = ws.chunks()[tid];
+            const size_t begin = ws.offset(r.begin), end = ws.offset(r.end);
+            std::memcpy(ws.y() + begin, ws.y_original() + begin, (end - begin) * sizeof(float));
+        };
+    } else {
+        work.write_allocate_bytes_per_element = sizeof(float);
+    }
+
+    // 处理描述符区间 r（向量编号）上的 reps 次调用；静态划分时 r 是线程的整段，工作窃取时是一个任务
+    std::function<void(const Range& r, size_t reps)> process;
+    if (layout == BatchLayout::Strided) {
+        const SaxpyStridedFn fn = kernel.strided;
+        process = [&ws, fn, mode](const Range& r, size_t reps) {
+            const size_t base = ws.offset(r.begin);
+            const float* x = ws.x() + base;
+            float* y = ws.y() + base;
+            const float* src = mode == MeasureMode::Kernel ? y : ws.y_original() + base;
+            for (size_t rep = 0; rep < reps; ++rep) {
+                fn(ws.scalars() + r.begin, x, src, y, ws.shape().min_n, ws.stride(), r.size());
+            }
+        };
+    } else {
+        const SaxpyBatchFn fn = kernel.items;
+        process = [&ws, fn, mode](const Range& r, size_t reps) {
+            const SaxpyBatchItem* items = ws.items(mode) + r.begin;
+            for (size_t rep = 0; rep < reps; ++rep) {
+                fn(items, r.size());
+            }
+        };
+    }
+
+    if (config.schedule == Schedule::Steal) {
+        auto scheduler = batch_scheduler(ws.items(mode), ws.chunks(), config.steal_grain);
+        work.scheduler = scheduler;
+        work.body = [scheduler, process](size_t tid, size_t reps) {
+            scheduler->run(tid, [&](const Range& r) { process(r, reps); });
+        };
+    } else {
+        work.body = [&ws, process](size_t tid, size_t reps) {
+            const Range& r = ws.chunks()[tid];
+            if (r.size() > 0) {
+                process(r, reps);
+            }
+        };
+    }
+    return work;
+}
+
+BenchResult run_batch(ThreadPool& pool, BatchWorkspace& ws, const SaxpyBatchKernel& kernel,
+                      BatchLayout layout, const BenchConfig& config) {
+    if (layout == BatchLayout::Strided && !ws.shape().uniform()) {
+        throw std::runtime_error("Strided layout requires a uniform batch shape: " + ws.shape().name());
+    }
+    return run_workload(pool, batch_workload(ws, kernel, layout, config), config);
+}
+
+size_t calibrate_batch_reps(ThreadPool& pool, BatchWorkspace& ws, const SaxpyBatchKernel& kernel,
+                            BatchLayout layout, const BenchConfig& config, double min_batch_seconds) {
+    return calibrate_workload_reps(pool, batch_workload(ws, kernel, layout, config), min_batch_seconds);
+}
+
+VerifyResult verify_batch(ThreadPool& pool, const BatchWorkspace& ws, uint32_t tolerance_ulp) {
+    const uint64_t t0 = read_ticks();
+    std::vector<UlpScan> partial(pool.size());
+    const SaxpyBatchItem* items = ws.items(MeasureMode::Kernel);
+
+    pool.run([&](size_t tid) {
+        TraceScope scope("verify", "verify");
+        const Range& r = ws.chunks()[tid];
+        const float* x = ws.x();
+        const float* y = ws.y();
+        const float* y0 = ws.y_original();
+        for (size_t k = r.begin; k < r.end; ++k) {
+            const float a = items[k].a;
+            const size_t begin = ws.offset(k);
+            partial[tid].scan(begin, begin + items[k].n, tolerance_ulp,
+                              [&](size_t i) { return ulp_distance(reference(a, x[i], y0[i]), y[i]); });
+        }
+    });
+
+    VerifyResult result;
+    result.checked = ws.elements();
+    result.tolerance_ulp = tolerance_ulp;
+    const size_t first = merge_ulp_scans(partial, result);
+    if (first != SIZE_MAX) {
+        // 找到出错元素所在的向量，取它的系数
+        size_t k = 0;
+        while (k + 1 < ws.count() && ws.offset(k + 1) <= first) {
+            ++k;
+        }
+        result.first_expected = reference(items[k].a, ws.x()[first], ws.y_original()[first]);
+        result.first_got = ws.y()[first];
+    }
+    result.seconds = timer_info().seconds(read_ticks() - t0);
+    return result;
+}
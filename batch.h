@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "allocator.h"
+#include "benchmark.h"
+#include "thread_pool.h"
+#include "verify.h"
+
+/**
+ * @brief 批量 SAXPY 中的一个向量：y_out[0, n) = a * x[0, n) + y_in[0, n)
+ *
+ * 原地计算时 y_in 与 y_out 相同。
+ */
+struct SaxpyBatchItem {
+    float a;
+    const float* x;
+    const float* y_in;
+    float* y_out;
+    uint64_t n;
+};
+
+/**
+ * @brief 描述符形式：依次处理 items[0, count)，长度可以各不相同（ragged）
+ */
+using SaxpyBatchFn = void (*)(const SaxpyBatchItem* items, size_t count);
+
+/**
+ * @brief 等长跨步形式：第 k 个向量从 x / y_in / y_out + k * stride 开始，长度都是 n，系数为 a[k]
+ *
+ * 长度相同，尾部谓词 / 掩码和整向量步数只需计算一次，对所有向量复用。
+ */
+using SaxpyStridedFn = void (*)(const float* a, const float* x, const float* y_in, float* y_out,
+                                uint64_t n, uint64_t stride, size_t count);
+
+/**
+ * @brief 一个批量 SAXPY 内核：同一后端的两种数据布局
+ */
+struct SaxpyBatchKernel {
+    const char* name;
+    const char* backend;
+    const char* description;
+    SaxpyBatchFn items;
+    SaxpyStridedFn strided;
+};
+
+/**
+ * @brief 本机可用的批量内核，融合内核按后端优先级排列（sve > avx512 > autovec），
+ *        最后是逐个调用默认 SAXPY 内核的 percall 基线；第一个是默认内核
+ */
+const std::vector<SaxpyBatchKernel>& saxpy_batch_kernels();
+
+/**
+ * @brief 用默认批量内核处理一批向量（单线程）
+ */
+void saxpy_batch(const SaxpyBatchItem* items, size_t count);
+
+void saxpy_batch_strided(const float* a, const float* x, const float* y_in, float* y_out,
+                         uint64_t n, uint64_t stride, size_t count);
+
+/**
+ * @brief 把 items 按元素数均衡地划分成 parts 段连续的描述符区间
+ *
+ * 每段的元素总数接近 总数 / parts，不会把一个向量拆开；
+ * 短向量很多时按个数均分会因长度不均而失衡。
+ */
+std::vector<Range> partition_batch(const SaxpyBatchItem* items, size_t count, size_t parts);
+
+/**
+ * @brief 在线程池上并行处理一批向量：每个线程按 partition_batch 负责一段，阻塞直到全部完成
+ *
+ * schedule 为 Steal 时每段再切成元素数约为 steal_grain 的连续小段，先做完的线程窃取其他线程剩下的小段；
+ * 适合核心速度不一（big.LITTLE、降频）或批内长度差异大到按元素数均分也不准的情况。
+ */
+void saxpy_batch_parallel(ThreadPool& pool, const SaxpyBatchKernel& kernel,
+                          const SaxpyBatchItem* items, size_t count, Schedule schedule = Schedule::Static,
+                          size_t steal_grain = DEFAULT_STEAL_GRAIN);
+
+/**
+ * @brief 基准测试的批形状：count 个向量，长度在 [min_n, max_n] 内
+ *
+ * min_n == max_n 时为等长批，同时测量描述符和跨步两种布局；否则长度按固定种子均匀抽取，
+ * 只能用描述符布局。
+ */
+struct BatchShape {
+    size_t count = 0;
+    size_t min_n = 0;
+    size_t max_n = 0;
+
+    bool uniform() const { return min_n == max_n; }
+    std::string name() const;   // "16384x256" 或 "16384x64-512"
+};
+
+/**
+ * @brief 解析逗号分隔的形状列表：COUNTxN 或 COUNTxMIN-MAX，"default" 为内置的一组形状
+ *
+ * 格式错误时抛出 std::runtime_error。
+ */
+std::vector<BatchShape> parse_batch_shapes(const std::string& list);
+
+/**
+ * @brief 批量测量的数据布局
+ */
+enum class BatchLayout {
+    Items,     // SaxpyBatchItem 描述符数组
+    Strided,   // 等长跨步
+};
+
+const char* batch_layout_name(BatchLayout layout);
+
+/**
+ * @brief 一个批形状的 X / Y / Y_original 和两组描述符（原地 / 非原地）
+ *
+ * 每个向量的起点按 64 字节对齐，向量之间不共享缓存行；等长批的跨步就是对齐后的长度。
+ * 线程划分由 partition_batch 给出，首次访问由负责该段的线程完成。
+ */
+class BatchWorkspace {
+public:
+    BatchWorkspace(ThreadPool& pool, const BatchShape& shape, float a, const AllocPolicy& policy = AllocPolicy{});
+
+    const BatchShape& shape() const { return shape_; }
+    size_t count() const { return shape_.count; }
+    size_t elements() const { return elements_; }
+    uint64_t stride() const { return stride_; }
+    // 每个线程负责的向量区间（下标是向量编号，不是元素）
+    const std::vector<Range>& chunks() const { return chunks_; }
+    // 每个线程负责的元素数，用于报告
+    std::vector<Range> element_chunks() const;
+
+    // Kernel 模式：y_in == y_out == Y；DoubleBuffer 模式：y_in = Y_original
+    const SaxpyBatchItem* items(MeasureMode mode) const {
+        return mode == MeasureMode::Kernel ? in_place_.data() : out_of_place_.data();
+    }
+    const float* scalars() const { return scalars_.data(); }
+    // 第 k 个向量在数组中的起点
+    size_t offset(size_t k) const { return offsets_[k]; }
+
+    float* x() const { return x_.as<float>(); }
+    float* y() const { return y_.as<float>(); }
+    float* y_original() const { return y_original_.as<float>(); }
+
+    MemoryInfo memory() const;
+
+private:
+    BatchShape shape_;
+    size_t elements_ = 0;
+    uint64_t stride_ = 0;
+    std::vector<size_t> offsets_;       // count + 1 个，最后一个是数组总长度
+    std::vector<float> scalars_;
+    std::vector<SaxpyBatchItem> in_place_;
+    std::vector<SaxpyBatchItem> out_of_place_;
+    std::vector<Range> chunks_;
+    Allocation x_;
+    Allocation y_;
+    Allocation y_original_;
+    double init_seconds_ = 0.0;
+};
+
+/**
+ * @brief 批量内核的 Workload：每次调用处理整个批，使用 config 中的 mode
+ *
+ * 与 SAXPY 一样，Kernel 模式原地计算并在每次分发前恢复 Y；flops / 字节数按实际元素计。
+ * config.schedule 为 Steal 时按 saxpy_batch_parallel 的方式切分任务窃取，拷贝阶段仍按线程的整段进行。
+ */
+Workload batch_workload(BatchWorkspace& ws, const SaxpyBatchKernel& kernel, BatchLayout layout,
+                        const BenchConfig& config);
+
+/**
+ * @brief 运行一个批量内核；返回时 Y 恰好是一次调用的结果
+ */
+BenchResult run_batch(ThreadPool& pool, BatchWorkspace& ws, const SaxpyBatchKernel& kernel,
+                      BatchLayout layout, const BenchConfig& config);
+
+size_t calibrate_batch_reps(ThreadPool& pool, BatchWorkspace& ws, const SaxpyBatchKernel& kernel,
+                            BatchLayout layout, const BenchConfig& config, double min_batch_seconds);
+
+/**
+ * @brief 逐元素检查每个向量是否等于 a_k * X + Y_original，方法同 verify_saxpy
+ *
+ * first_index 是出错元素在数组中的位置（含对齐填充）。
+ */
+VerifyResult verify_batch(ThreadPool& pool, const BatchWorkspace& ws, uint32_t tolerance_ulp);
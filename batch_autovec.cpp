@@ -0,0 +1,39 @@
+#include "batch_backends.h"
+
+// 本文件与 saxpy_autovec.cpp 一样用 -O3 -ftree-vectorize 编译。
+// 内层循环内联在批循环里，省掉了逐个调用的函数调用和参数检查；向量化的尾部由编译器生成
+
+namespace {
+
+void batch_items(const SaxpyBatchItem* items, size_t count) {
+    for (size_t k = 0; k < count; ++k) {
+        const SaxpyBatchItem& item = items[k];
+        const float a = item.a;
+        const float* x = item.x;
+        const float* y_in = item.y_in;
+        float* y_out = item.y_out;
+        for (uint64_t i = 0; i < item.n; ++i) {
+            y_out[i] = a * x[i] + y_in[i];
+        }
+    }
+}
+
+void batch_strided(const float* a, const float* x, const float* y_in, float* y_out,
+                   uint64_t n, uint64_t stride, size_t count) {
+    for (size_t k = 0; k < count; ++k) {
+        const uint64_t base = k * stride;
+        const float ak = a[k];
+        for (uint64_t i = 0; i < n; ++i) {
+            y_out[base + i] = ak * x[base + i] + y_in[base + i];
+        }
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyBatchKernel>& autovec_batch_table() {
+    static const std::vector<SaxpyBatchKernel> kernels = {
+        {"autovec", "autovec", "one pass over the batch, compiler auto-vectorized", batch_items, batch_strided},
+    };
+    return kernels;
+}
@@ -0,0 +1,84 @@
+#include "batch_backends.h"
+
+// 本文件用 -mavx512f 单独编译
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+namespace {
+
+inline __mmask16 tail_mask(uint64_t left) {
+    return static_cast<__mmask16>((1u << left) - 1);
+}
+
+// 一个向量：4 倍展开的主体、逐向量的剩余部分、最多一次掩码尾部
+inline void saxpy_one(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    const __m512 va = _mm512_set1_ps(a);
+    uint64_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m512 r0 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i),      _mm512_loadu_ps(y_in + i));
+        __m512 r1 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y_in + i + 16));
+        __m512 r2 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(y_in + i + 32));
+        __m512 r3 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(y_in + i + 48));
+        _mm512_storeu_ps(y_out + i,      r0);
+        _mm512_storeu_ps(y_out + i + 16, r1);
+        _mm512_storeu_ps(y_out + i + 32, r2);
+        _mm512_storeu_ps(y_out + i + 48, r3);
+    }
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(y_out + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y_in + i)));
+    }
+    if (i < n) {
+        const __mmask16 m = tail_mask(n - i);
+        __m512 vx = _mm512_maskz_loadu_ps(m, x + i);
+        __m512 vy = _mm512_maskz_loadu_ps(m, y_in + i);
+        _mm512_mask_storeu_ps(y_out + i, m, _mm512_fmadd_ps(va, vx, vy));
+    }
+}
+
+void batch_items(const SaxpyBatchItem* items, size_t count) {
+    for (size_t k = 0; k < count; ++k) {
+        const SaxpyBatchItem& item = items[k];
+        saxpy_one(item.a, item.x, item.y_in, item.y_out, item.n);
+    }
+}
+
+// 等长跨步形式：整向量步数和尾部掩码只计算一次
+void batch_strided(const float* a, const float* x, const float* y_in, float* y_out,
+                   uint64_t n, uint64_t stride, size_t count) {
+    const uint64_t full = n & ~uint64_t(15);
+    const __mmask16 tail = tail_mask(n - full);
+    for (size_t k = 0; k < count; ++k) {
+        const uint64_t base = k * stride;
+        const float* xk = x + base;
+        const float* yk = y_in + base;
+        float* ok = y_out + base;
+        const __m512 va = _mm512_set1_ps(a[k]);
+        for (uint64_t i = 0; i < full; i += 16) {
+            _mm512_storeu_ps(ok + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(xk + i), _mm512_loadu_ps(yk + i)));
+        }
+        if (tail) {
+            __m512 vx = _mm512_maskz_loadu_ps(tail, xk + full);
+            __m512 vy = _mm512_maskz_loadu_ps(tail, yk + full);
+            _mm512_mask_storeu_ps(ok + full, tail, _mm512_fmadd_ps(va, vx, vy));
+        }
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyBatchKernel>& avx512_batch_table() {
+    static const std::vector<SaxpyBatchKernel> kernels = {
+        {"avx512", "avx512", "one pass over the batch, 512-bit FMA + single masked tail", batch_items, batch_strided},
+    };
+    return kernels;
+}
+
+#else
+
+const std::vector<SaxpyBatchKernel>& avx512_batch_table() {
+    static const std::vector<SaxpyBatchKernel> kernels;
+    return kernels;
+}
+
+#endif // __AVX512F__
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <vector>
+
+#include "batch.h"
+
+// 批量 SAXPY 各后端的内核表；约定同 saxpy_backends.h：
+// 每个表定义在对应 ISA 的翻译单元里，只能在 cpu_features() 确认 CPU 支持后才能调用。
+const std::vector<SaxpyBatchKernel>& sve_batch_table();
+const std::vector<SaxpyBatchKernel>& avx512_batch_table();
+const std::vector<SaxpyBatchKernel>& autovec_batch_table();
@@ -0,0 +1,83 @@
+#include "batch_backends.h"
+
+// 本文件用 -march=...+sve 单独编译；编译器不支持 SVE 时表为空
+#if defined(__ARM_FEATURE_SVE)
+
+#include <arm_sve.h>
+
+namespace {
+
+// 一个向量：主体用全真谓词，最多一次 whilelt 处理尾部。
+// 几百个元素只有十几步，逐步 whilelt 的依赖链和循环判断占了相当大的比例
+inline void saxpy_one(svbool_t all, uint64_t vl, float a, const float* x, const float* y_in,
+                      float* y_out, uint64_t n) {
+    const svfloat32_t va = svdup_n_f32(a);
+    uint64_t i = 0;
+    for (; i + 2 * vl <= n; i += 2 * vl) {
+        svfloat32_t x0 = svld1_vnum_f32(all, x + i, 0);
+        svfloat32_t x1 = svld1_vnum_f32(all, x + i, 1);
+        svfloat32_t y0 = svld1_vnum_f32(all, y_in + i, 0);
+        svfloat32_t y1 = svld1_vnum_f32(all, y_in + i, 1);
+        svst1_vnum_f32(all, y_out + i, 0, svmla_f32_x(all, y0, x0, va));
+        svst1_vnum_f32(all, y_out + i, 1, svmla_f32_x(all, y1, x1, va));
+    }
+    for (; i < n; i += vl) {
+        svbool_t pg = svwhilelt_b32(i, n);
+        svfloat32_t vec_x = svld1_f32(pg, x + i);
+        svfloat32_t vec_y = svld1_f32(pg, y_in + i);
+        svst1_f32(pg, y_out + i, svmla_f32_m(pg, vec_y, vec_x, va));
+    }
+}
+
+// 描述符形式：svptrue 和 svcntw 对整批只取一次
+void batch_items(const SaxpyBatchItem* items, size_t count) {
+    const svbool_t all = svptrue_b32();
+    const uint64_t vl = svcntw();
+    for (size_t k = 0; k < count; ++k) {
+        const SaxpyBatchItem& item = items[k];
+        saxpy_one(all, vl, item.a, item.x, item.y_in, item.y_out, item.n);
+    }
+}
+
+// 等长跨步形式：整向量步数和尾部谓词只计算一次，所有向量共用
+void batch_strided(const float* a, const float* x, const float* y_in, float* y_out,
+                   uint64_t n, uint64_t stride, size_t count) {
+    const svbool_t all = svptrue_b32();
+    const uint64_t vl = svcntw();
+    const uint64_t full = n / vl * vl;
+    const svbool_t tail = svwhilelt_b32(full, n);
+    const bool has_tail = full < n;
+    for (size_t k = 0; k < count; ++k) {
+        const uint64_t base = k * stride;
+        const float* xk = x + base;
+        const float* yk = y_in + base;
+        float* ok = y_out + base;
+        const svfloat32_t va = svdup_n_f32(a[k]);
+        for (uint64_t i = 0; i < full; i += vl) {
+            svst1_f32(all, ok + i, svmla_f32_x(all, svld1_f32(all, yk + i), svld1_f32(all, xk + i), va));
+        }
+        if (has_tail) {
+            svfloat32_t vec_x = svld1_f32(tail, xk + full);
+            svfloat32_t vec_y = svld1_f32(tail, yk + full);
+            svst1_f32(tail, ok + full, svmla_f32_m(tail, vec_y, vec_x, va));
+        }
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyBatchKernel>& sve_batch_table() {
+    static const std::vector<SaxpyBatchKernel> kernels = {
+        {"sve", "sve", "one pass over the batch, svptrue body + single whilelt tail", batch_items, batch_strided},
+    };
+    return kernels;
+}
+
+#else
+
+const std::vector<SaxpyBatchKernel>& sve_batch_table() {
+    static const std::vector<SaxpyBatchKernel> kernels;
+    return kernels;
+}
+
+#endif // __ARM_FEATURE_SVE
@@ -0,0 +1,463 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <ostream>
+
+#include <unistd.h>
+
+#include "timer.h"
+#include "trace.h"
+
+const char* measure_mode_name(MeasureMode mode) {
+    return mode == MeasureMode::Kernel ? "kernel" : "double-buffer";
+}
+
+size_t footprint_bytes_per_element(MeasureMode mode) {
+    return mode == MeasureMode::Kernel ? 2 * sizeof(float) : 3 * sizeof(float);
+}
+
+Workspace::Workspace(ThreadPool& pool, size_t elements, const AllocPolicy& policy, const InputFiles& inputs)
+    : elements_(elements),
+      // 按缓存行（16 个 float）对齐划分数据块，每个线程负责一块
+      chunks_(static_partition(elements, pool.size(), 64 / sizeof(float))),
+      x_(inputs.x_path.empty() ? Allocation(elements * sizeof(float), policy)
+                               : Allocation(elements * sizeof(float), policy, inputs.x_path, inputs.populate)),
+      y_(elements * sizeof(float), policy),
+      y_original_(inputs.y_path.empty() ? Allocation(elements * sizeof(float), policy)
+                                        : Allocation(elements * sizeof(float), policy, inputs.y_path, inputs.populate)) {
+    // 首次访问(first-touch)：由将来计算这一块的线程直接写入初始值，
+    // 内核把页面分配到该线程所在的 NUMA 节点，初始化时间也随线程数缩短。
+    // 文件映射的数组不能覆盖，只按页读一个元素把页面调入（页缓存的 NUMA 位置由读入文件的进程决定）
+    const bool x_file = !inputs.x_path.empty();
+    const bool y_file = !inputs.y_path.empty();
+    const size_t page_floats = std::max<size_t>(static_cast<size_t>(sysconf(_SC_PAGESIZE)) / sizeof(float), 1);
+    const PageFaults faults0 = process_page_faults();
+    const uint64_t t0 = read_ticks();
+    pool.run([&](size_t tid) {
+        TraceScope scope("first touch", "setup");
+        const Range& r = chunks_[tid];
+        float* xs = x();
+        float* ys = y();
+        float* y0 = y_original();
+        if (x_file) {
+            volatile float sink = 0.0f;
+            for (size_t i = r.begin; i < r.end; i += page_floats) {
+                sink = xs[i];
+            }
+            (void)sink;
+        }
+        for (size_t i = r.begin; i < r.end; ++i) {
+            if (!x_file) {
+                xs[i] = static_cast<float>(i);            // x = {0.0, 1.0, 2.0, ...}
+            }
+            if (!y_file) {
+                y0[i] = static_cast<float>(elements_ - i);
+            }
+            ys[i] = y0[i];
+        }
+    });
+    init_seconds_ = timer_info().seconds(read_ticks() - t0);
+    init_faults_ = process_page_faults() - faults0;
+}
+
+MemoryInfo describe_memory(const std::vector<const Allocation*>& arrays, double init_seconds,
+                           const PageFaults& init_faults) {
+    MemoryInfo info;
+    info.requested = arrays.front()->requested();
+    info.effective = arrays.front()->effective();
+    info.alignment = arrays.front()->alignment();
+    info.locked = true;
+    info.init_seconds = init_seconds;
+    info.init_faults = init_faults;
+    for (const Allocation* a : arrays) {
+        if (!a->path().empty()) {
+            info.source = "file";
+            info.map_seconds += a->map_seconds();
+            info.map_faults.minor += a->map_faults().minor;
+            info.map_faults.major += a->map_faults().major;
+        }
+        info.locked = info.locked && a->locked();
+        info.bytes += a->size();
+        info.huge_page_bytes += a->huge_page_bytes();
+        if (info.note.empty()) {
+            info.note = a->note();
+        }
+    }
+    return info;
+}
+
+MemoryInfo Workspace::memory() const {
+    return describe_memory({&x_, &y_, &y_original_}, init_seconds_, init_faults_);
+}
+
+double BenchResult::gflops() const {
+    return kernel_seconds > 0 ? flops_per_element * elements * kernel_calls() / kernel_seconds / 1e9 : 0.0;
+}
+
+double BenchResult::bandwidth_gbs() const {
+    return kernel_seconds > 0 ? bytes_moved() / kernel_seconds / 1e9 : 0.0;
+}
+
+double BenchResult::traffic_gbs() const {
+    return kernel_seconds > 0 ? traffic_bytes() / kernel_seconds / 1e9 : 0.0;
+}
+
+double BenchResult::reset_bandwidth_gbs() const {
+    // 拷贝每个元素读一次、写一次
+    return reset_seconds > 0 ? reset_bytes() / reset_seconds / 1e9 : 0.0;
+}
+
+LatencySummary BenchResult::latency() const {
+    LatencySummary summary;
+    if (dispatch_ns.count() == 0) {
+        return summary;
+    }
+    const double per_call = 1.0 / inner_reps;
+    summary.samples = dispatch_ns.count();
+    summary.min_ns = dispatch_ns.min() * per_call;
+    summary.median_ns = dispatch_ns.percentile(0.5) * per_call;
+    summary.p90_ns = dispatch_ns.percentile(0.9) * per_call;
+    summary.p99_ns = dispatch_ns.percentile(0.99) * per_call;
+    summary.p999_ns = dispatch_ns.percentile(0.999) * per_call;
+    summary.max_ns = dispatch_ns.max() * per_call;
+    return summary;
+}
+
+std::vector<double> BenchResult::window_bandwidth_gbs() const {
+    std::vector<double> out;
+    for (const WindowSample& w : windows) {
+        const double calls = static_cast<double>(w.iterations) * inner_reps;
+        out.push_back(w.kernel_seconds > 0 ? bytes_per_element * elements * calls / w.kernel_seconds / 1e9 : 0.0);
+    }
+    return out;
+}
+
+std::vector<double> BenchResult::window_gflops() const {
+    std::vector<double> out;
+    for (const WindowSample& w : windows) {
+        const double calls = static_cast<double>(w.iterations) * inner_reps;
+        out.push_back(w.kernel_seconds > 0 ? flops_per_element * elements * calls / w.kernel_seconds / 1e9 : 0.0);
+    }
+    return out;
+}
+
+double BenchResult::thread_elements(size_t tid, size_t chunk_elements) const {
+    if (schedule == Schedule::Steal) {
+        return iterations > 0 ? static_cast<double>(threads[tid].task_elements) / iterations : 0.0;
+    }
+    return static_cast<double>(chunk_elements);
+}
+
+const CounterValue* BenchResult::counter(const char* name) const {
+    for (const CounterValue& c : counters) {
+        if (c.available && std::strcmp(c.name, name) == 0) {
+            return &c;
+        }
+    }
+    return nullptr;
+}
+
+double BenchResult::ipc() const {
+    const CounterValue* cycles = counter("cycles");
+    const CounterValue* instructions = counter("instructions");
+    return cycles && instructions && cycles->value > 0 ? instructions->value / cycles->value : 0.0;
+}
+
+namespace {
+
+using CounterGroups = std::vector<std::unique_ptr<PerfCounterGroup>>;
+
+// 一次测量中复用的两个阶段任务：在 Workload 的回调外面包上计时和计数器
+struct PhaseTasks {
+    std::function<void(size_t)> reset;
+    std::function<void(size_t)> kernel;
+};
+
+// iteration 非空时指向主线程当前的迭代序号（预热为负），作为跟踪事件的参数
+PhaseTasks make_tasks(const Workload& work, size_t inner_reps, std::vector<ThreadStats>& stats,
+                      CounterGroups* groups = nullptr, const long long* iteration = nullptr) {
+    const TimerInfo& timer = timer_info();
+    PhaseTasks tasks;
+    if (work.reset) {
+        tasks.reset = [&work, &stats, &timer, iteration](size_t tid) {
+            TraceScope scope("reset", "reset", iteration ? *iteration : TRACE_NO_ARG);
+            uint64_t t0 = read_ticks();
+            work.reset(tid);
+            stats[tid].reset_seconds += timer.seconds(timer.net_ticks(t0, read_ticks()));
+        };
+    }
+    tasks.kernel = [&work, &stats, &timer, inner_reps, groups, iteration](size_t tid) {
+        TraceScope scope("kernel", "kernel", iteration ? *iteration : TRACE_NO_ARG);
+        // 计数器只在计算期间打开；ioctl 放在计时区间之外
+        PerfCounterGroup* counters = groups ? (*groups)[tid].get() : nullptr;
+        if (counters) {
+            counters->enable();
+        }
+        uint64_t t0 = read_ticks();
+        work.body(tid, inner_reps);
+        uint64_t t1 = read_ticks();
+        if (counters) {
+            counters->disable();
+        }
+        stats[tid].last_start_ticks = t0;
+        stats[tid].last_end_ticks = t1;
+        stats[tid].kernel_seconds += timer.seconds(timer.net_ticks(t0, t1));
+    };
+    return tasks;
+}
+
+// 执行一次计算阶段：工作窃取的队列在任何线程开始之前全部恢复
+void dispatch_kernel(ThreadPool& pool, const Workload& work, const std::function<void(size_t)>& kernel) {
+    if (work.scheduler) {
+        work.scheduler->prepare();
+    }
+    pool.run(kernel);
+}
+
+// 本次分发计算阶段的跨度：最早开始的线程到最晚结束的线程（已扣除读数开销）。
+// 只取最慢线程自身的耗时会漏掉线程错开启动、共用一个核时的排队，高估吞吐量。
+// pool.run() 返回时所有线程都已写完
+uint64_t critical_path_ticks(const std::vector<ThreadStats>& stats) {
+    uint64_t first_start = UINT64_MAX;
+    uint64_t last_end = 0;
+    for (const ThreadStats& t : stats) {
+        first_start = std::min(first_start, t.last_start_ticks);
+        last_end = std::max(last_end, t.last_end_ticks);
+    }
+    return stats.empty() ? 0 : timer_info().net_ticks(first_start, last_end);
+}
+
+} // namespace
+
+Workload saxpy_workload(Workspace& ws, const BenchConfig& config) {
+    Workload work;
+    work.elements = ws.size();
+    work.flops_per_element = 2.0;
+    work.bytes_per_element = SAXPY_BYTES_PER_ELEMENT;
+    work.footprint_bytes_per_element = static_cast<double>(footprint_bytes_per_element(config.mode));
+    if (config.mode == MeasureMode::Kernel) {
+        // 拷贝每个元素读一次、写一次
+        work.reset_bytes_per_element = 2.0 * sizeof(float);
+        work.reset = [&ws](size_t tid) {
+            const Range& r = ws.chunks()[tid];
+            // 每次迭代前重置 y，以确保计算负载恒定
+            std::copy(ws.y_original() + r.begin, ws.y_original() + r.end, ws.y() + r.begin);
+        };
+    } else if (!config.kernel->non_temporal) {
+        // 非原地写 Y：Y 的行不是刚读过的，普通存储要先读入
+        work.write_allocate_bytes_per_element = sizeof(float);
+    }
+    const SaxpyFn fn = config.kernel->fn;
+    const float a = config.a;
+    const MeasureMode mode = config.mode;
+    if (config.schedule == Schedule::Steal) {
+        // 任务边界按缓存行对齐，相邻任务不共享缓存行
+        auto scheduler = WorkStealingScheduler::for_chunks(ws.chunks(), config.steal_grain, 64 / sizeof(float));
+        work.scheduler = scheduler;
+        work.body = [&ws, fn, a, mode, scheduler](size_t tid, size_t reps) {
+            scheduler->run(tid, [&](const Range& r) {
+                const float* x = ws.x() + r.begin;
+                float* y = ws.y() + r.begin;
+                const float* src = mode == MeasureMode::Kernel ? y : ws.y_original() + r.begin;
+                for (size_t rep = 0; rep < reps; ++rep) {
+                    fn(a, x, src, y, r.size());
+                }
+            });
+        };
+        return work;
+    }
+    work.body = [&ws, fn, a, mode](size_t tid, size_t reps) {
+        const Range& r = ws.chunks()[tid];
+        const float* x = ws.x() + r.begin;
+        float* y = ws.y() + r.begin;
+        // 执行核心计算：Kernel 模式原地更新 Y，DoubleBuffer 模式从 Y_original 读取
+        const float* src = mode == MeasureMode::Kernel ? y : ws.y_original() + r.begin;
+        for (size_t rep = 0; rep < reps; ++rep) {
+            fn(a, x, src, y, r.size());
+        }
+    };
+    return work;
+}
+
+BenchResult run_workload(ThreadPool& pool, const Workload& work, const BenchConfig& config) {
+    const TimerInfo& timer = timer_info();
+    BenchResult result;
+    result.elements = work.elements;
+    result.flops_per_element = work.flops_per_element;
+    result.bytes_per_element = work.bytes_per_element;
+    result.footprint_bytes_per_element = work.footprint_bytes_per_element;
+    result.reset_bytes_per_element = work.reset ? work.reset_bytes_per_element : 0.0;
+    result.write_allocate_bytes_per_element = work.write_allocate_bytes_per_element;
+    result.inner_reps = std::max<size_t>(config.inner_reps, 1);
+    result.schedule = work.scheduler ? Schedule::Steal : Schedule::Static;
+    result.threads.assign(pool.size(), ThreadStats{});
+
+    // 每个工作线程在自己身上打开一组计数器
+    CounterGroups groups;
+    if (!config.counters.empty()) {
+        groups.resize(pool.size());
+        pool.run([&](size_t tid) { groups[tid].reset(new PerfCounterGroup(config.counters)); });
+        if (!groups[0]->ok()) {
+            result.counters_error = groups[0]->error();
+            groups.clear();
+        }
+    }
+
+    // 拷贝和计算分成两次 pool.run()，拷贝开销单独报告。
+    // 计算时间在工作线程内部取时间戳，取最早开始到最晚结束的跨度，不含线程池唤醒的开销；
+    // 主线程看到的墙钟时间另记为 dispatch_seconds
+    // 跟踪事件的迭代序号：主线程在每次分发前写入，线程池的分发保证工作线程看到新值
+    long long iteration = 0;
+    PhaseTasks tasks =
+        make_tasks(work, result.inner_reps, result.threads, groups.empty() ? nullptr : &groups, &iteration);
+
+    // 预热：让频率、页表和缓存进入稳态；这段时间不计入任何统计
+    {
+        TraceScope scope("warmup", "run", config.warmup_iterations);
+        for (long long i = 0; i < config.warmup_iterations; ++i) {
+            iteration = i - config.warmup_iterations;
+            if (tasks.reset) {
+                pool.run(tasks.reset);
+            }
+            dispatch_kernel(pool, work, tasks.kernel);
+        }
+    }
+    result.warmup_iterations = std::max(config.warmup_iterations, 0LL);
+    result.threads.assign(pool.size(), ThreadStats{});
+    for (auto& group : groups) {
+        group->reset();
+    }
+    if (work.scheduler) {
+        work.scheduler->reset_stats();
+    }
+
+    // 循环里只读计数器，不做换算；进度按时间而不是按迭代次数打印
+    const uint64_t ticks_per_second = static_cast<uint64_t>(timer.ticks_per_second);
+    const uint64_t target_ticks = static_cast<uint64_t>(config.target_seconds * timer.ticks_per_second);
+    const PageFaults faults0 = process_page_faults();
+    const uint64_t start = read_ticks();
+    uint64_t next_progress = start + ticks_per_second;
+    // 吞吐量样本窗口：固定次数时按迭代数等分，否则按目标时间等分
+    const size_t window_count = std::max<size_t>(config.sample_windows, 1);
+    size_t window_index = 0;
+    WindowSample window;
+    while (true) {
+        iteration = result.iterations;
+        TraceScope scope("iteration", "run", iteration);
+        if (tasks.reset) {
+            uint64_t r0 = read_ticks();
+            pool.run(tasks.reset);
+            result.reset_seconds += timer.seconds(timer.net_ticks(r0, read_ticks()));
+        }
+
+        uint64_t k0 = read_ticks();
+        dispatch_kernel(pool, work, tasks.kernel);
+        uint64_t now = read_ticks();
+        result.dispatch_seconds += timer.seconds(timer.net_ticks(k0, now));
+
+        uint64_t critical = critical_path_ticks(result.threads);
+        result.kernel_seconds += timer.seconds(critical);
+        result.dispatch_ns.record(static_cast<uint64_t>(timer.seconds(critical) * 1e9 + 0.5));
+
+        result.iterations++;
+
+        window.iterations++;
+        window.kernel_seconds += timer.seconds(critical);
+        // 当前所处的窗口；一次分发跨过多个窗口边界时直接跳到所在的窗口，不留下空窗口
+        const size_t position =
+            config.max_iterations > 0
+                ? static_cast<size_t>(result.iterations * static_cast<long long>(window_count) / config.max_iterations)
+                : static_cast<size_t>(static_cast<double>(now - start) * window_count / std::max<uint64_t>(target_ticks, 1));
+        if (position > window_index && window_index + 1 < window_count) {
+            result.windows.push_back(window);
+            window = WindowSample{};
+            window_index = std::min(position, window_count - 1);
+        }
+
+        // 每秒打印一次进度
+        if (config.progress && now >= next_progress) {
+            *config.progress << "\rElapsed time: " << (now - start) / ticks_per_second
+                             << "s, Iterations: " << result.iterations << std::flush;
+            next_progress += ticks_per_second;
+        }
+
+        bool done = config.max_iterations > 0 ? result.iterations >= config.max_iterations
+                                              : now - start >= target_ticks;
+        if (done) {
+            break;
+        }
+    }
+    result.total_seconds = timer.seconds(read_ticks() - start);
+    result.page_faults = process_page_faults() - faults0;
+    if (window.iterations > 0) {
+        result.windows.push_back(window);
+    }
+
+    // 忙碌时间：工作窃取时是各任务的耗时之和（不含找任务和窃取失败的时间），静态划分时就是计算耗时
+    for (size_t tid = 0; tid < result.threads.size(); ++tid) {
+        ThreadStats& t = result.threads[tid];
+        if (work.scheduler) {
+            const StealStats& s = work.scheduler->stats()[tid];
+            t.busy_seconds = timer.seconds(s.busy_ticks);
+            t.tasks = s.tasks;
+            t.stolen_tasks = s.stolen;
+            t.task_elements = s.elements;
+        } else {
+            t.busy_seconds = t.kernel_seconds;
+        }
+    }
+
+    for (auto& group : groups) {
+        accumulate_counters(result.counters, group->read());
+    }
+    if (!config.counters.empty() && result.counters.empty()) {
+        // 打不开时也按请求的顺序列出事件，全部标成不可用
+        for (const PerfEventSpec* spec : config.counters) {
+            CounterValue c;
+            c.name = spec->name;
+            result.counters.push_back(c);
+        }
+    }
+
+    // 原地计算重复多次会让输出不断累加；补一次不计时的 重置 + 单次计算，供后续验证
+    if (tasks.reset && result.inner_reps > 1) {
+        std::vector<ThreadStats> scratch(pool.size());
+        TraceScope scope("output run", "run");
+        PhaseTasks verify = make_tasks(work, 1, scratch);
+        pool.run(verify.reset);
+        dispatch_kernel(pool, work, verify.kernel);
+    }
+    return result;
+}
+
+size_t calibrate_workload_reps(ThreadPool& pool, const Workload& work, double min_batch_seconds) {
+    constexpr size_t MAX_REPS = size_t(1) << 24;
+    const TimerInfo& timer = timer_info();
+    TraceScope scope("calibrate", "run");
+    std::vector<ThreadStats> scratch(pool.size());
+    size_t reps = 1;
+    while (reps < MAX_REPS) {
+        PhaseTasks tasks = make_tasks(work, reps, scratch);
+        dispatch_kernel(pool, work, tasks.kernel);
+        if (timer.seconds(critical_path_ticks(scratch)) >= min_batch_seconds) {
+            break;
+        }
+        reps *= 2;
+    }
+    return reps;
+}
+
+void run_workload_body(ThreadPool& pool, const Workload& work, size_t reps) {
+    dispatch_kernel(pool, work, [&work, reps](size_t tid) { work.body(tid, reps); });
+}
+
+BenchResult run_benchmark(ThreadPool& pool, Workspace& ws, const BenchConfig& config) {
+    return run_workload(pool, saxpy_workload(ws, config), config);
+}
+
+size_t calibrate_inner_reps(ThreadPool& pool, Workspace& ws, const BenchConfig& config,
+                            double min_batch_seconds) {
+    return calibrate_workload_reps(pool, saxpy_workload(ws, config), min_batch_seconds);
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "allocator.h"
+#include "histogram.h"
+#include "perf_counters.h"
+#include "saxpy.h"
+#include "scheduler.h"
+#include "thread_pool.h"
+
+// SAXPY 每个元素的内存流量：读 X、读 Y、写 Y
+constexpr double SAXPY_BYTES_PER_ELEMENT = 3.0 * sizeof(float);
+
+/**
+ * @brief 测量模式
+ *
+ * - Kernel: 原地 SAXPY。每次迭代前仍要把 Y 恢复成初始值，
+ *           但拷贝和计算分成两个阶段分别计时，Performance 只统计计算阶段。
+ * - DoubleBuffer: 非原地 SAXPY，从不变的 Y_original 读取、写入 Y，完全没有拷贝。
+ */
+enum class MeasureMode {
+    Kernel,
+    DoubleBuffer,
+};
+
+const char* measure_mode_name(MeasureMode mode);
+
+/**
+ * @brief 计算阶段实际访问的字节数（每个元素），用于工作集扫描时换算规模
+ *
+ * Kernel 模式只访问 X 和 Y；DoubleBuffer 模式访问 X、Y_original 和 Y。
+ */
+size_t footprint_bytes_per_element(MeasureMode mode);
+
+// 每个工作线程的统计数据，按缓存行对齐避免伪共享
+struct alignas(64) ThreadStats {
+    double kernel_seconds = 0.0;     // 只包含 SAXPY 本身
+    double reset_seconds = 0.0;      // 每次迭代前恢复 Y 的拷贝
+    uint64_t last_start_ticks = 0;   // 最近一次分发中本线程开始 / 结束计算的时间戳（计时器 tick）
+    uint64_t last_end_ticks = 0;
+    double busy_seconds = 0.0;       // 真正在执行计算的时间；静态划分时等于 kernel_seconds
+    uint64_t tasks = 0;              // 工作窃取时执行的任务数（含窃取来的），静态划分为 0
+    uint64_t stolen_tasks = 0;       // 其中从其他线程窃取的任务数
+    uint64_t task_elements = 0;      // 工作窃取时计时循环中处理的元素数（每次分发计一次，不乘 inner_reps）
+};
+
+/**
+ * @brief 工作区内存的实际分配情况，用于在报告中量化页面大小 / TLB 的影响
+ */
+struct MemoryInfo {
+    PageMode requested = PageMode::Default;
+    PageMode effective = PageMode::Default;
+    size_t alignment = 0;
+    bool locked = false;
+    size_t bytes = 0;              // 三个数组的总字节数
+    size_t huge_page_bytes = 0;    // 其中落在大页上的字节数
+    double init_seconds = 0.0;     // 并行首次访问 + 填充初始值的耗时（含缺页）
+    std::string note;              // 退回或 mlock 失败的原因
+    std::string source = "anonymous"; // anonymous，或 file（至少一个数组映射自输入文件）
+    double map_seconds = 0.0;      // 输入文件 mmap 的耗时（populate 时含读入）
+    PageFaults map_faults;         // mmap 期间的缺页
+    PageFaults init_faults;        // 首次访问阶段的缺页
+};
+
+// 汇总若干块内存的分配情况；页面类型和对齐取第一块的值
+MemoryInfo describe_memory(const std::vector<const Allocation*>& arrays, double init_seconds,
+                           const PageFaults& init_faults = PageFaults{});
+
+/**
+ * @brief SAXPY 的输入文件：原始 float32 数组（本机字节序，无文件头）
+ *
+ * 为空的一项照常用合成数据初始化。
+ */
+struct InputFiles {
+    std::string x_path;
+    std::string y_path;            // Y 的初始值，作为 Y_original
+    bool populate = false;         // mmap 时加 MAP_POPULATE
+
+    bool any() const { return !x_path.empty() || !y_path.empty(); }
+};
+
+/**
+ * @brief 一次测量所用的 X / Y / Y_original 三个数组
+ *
+ * 按 AllocPolicy 分配（对齐、大页、mlock），构造时由各线程按与计算阶段相同的静态划分
+ * 并行写入初始值，保证页面落在负责该数据块的线程所在的 NUMA 节点上。
+ *
+ * 给出输入文件时，X / Y_original 改为文件前 elements 个 float 的私有映射，
+ * 首次访问阶段只按同样的划分读一遍把页面调入，计算阶段不再缺页；Y 仍是匿名内存。
+ */
+class Workspace {
+public:
+    Workspace(ThreadPool& pool, size_t elements, const AllocPolicy& policy = AllocPolicy{},
+              const InputFiles& inputs = InputFiles{});
+
+    size_t size() const { return elements_; }
+    const std::vector<Range>& chunks() const { return chunks_; }
+
+    float* x() { return x_.as<float>(); }
+    float* y() { return y_.as<float>(); }
+    float* y_original() { return y_original_.as<float>(); }
+
+    MemoryInfo memory() const;
+
+private:
+    size_t elements_;
+    std::vector<Range> chunks_;
+    // 不使用 std::vector：它会在主线程上清零整个数组，导致所有页面都落在主线程所在的节点上
+    Allocation x_;
+    Allocation y_;
+    Allocation y_original_;
+    double init_seconds_ = 0.0;
+    PageFaults init_faults_;
+};
+
+/**
+ * @brief 单次 SAXPY 调用耗时的统计摘要（纳秒），不含预热迭代
+ */
+struct LatencySummary {
+    size_t samples = 0;
+    double min_ns = 0.0;
+    double median_ns = 0.0;
+    double p90_ns = 0.0;
+    double p99_ns = 0.0;
+    double p999_ns = 0.0;
+    double max_ns = 0.0;
+};
+
+/**
+ * @brief 计时循环中一个时间窗口的统计；各窗口的吞吐量是同一次运行内的重复样本，供统计检验使用
+ */
+struct WindowSample {
+    long long iterations = 0;
+    double kernel_seconds = 0.0;          // 窗口内各次分发计算阶段的跨度之和
+};
+
+struct BenchConfig {
+    const SaxpyKernel* kernel = &saxpy_kernels().front();
+    float a = 2.5f;
+    double target_seconds = 120.0;        // 目标运行时间
+    long long max_iterations = 0;         // > 0 时运行固定的分发次数，忽略 target_seconds
+    long long warmup_iterations = 10;     // 正式计时前先运行的分发次数，不计入任何统计
+    MeasureMode mode = MeasureMode::Kernel;
+    size_t inner_reps = 1;                // 每次分发中每个线程连续执行的调用次数
+    std::ostream* progress = nullptr;     // 非空时向该流打印进度行
+    std::vector<const PerfEventSpec*> counters; // 只在计算阶段采集的硬件计数器；空表示不采集
+    size_t sample_windows = 10;           // 计时循环按时间（固定次数时按迭代数）等分成的窗口数，每个窗口一个吞吐量样本
+    Schedule schedule = Schedule::Static; // SAXPY 和批量 SAXPY 的计算阶段如何在线程间分配
+    size_t steal_grain = DEFAULT_STEAL_GRAIN; // 工作窃取的任务粒度（元素）
+};
+
+/**
+ * @brief 一个可以被 run_workload 计时的并行计算
+ *
+ * SAXPY 和 BLAS-1 套件都通过它复用同一套预热、计时、直方图和计数器逻辑。
+ * 两个回调都按 tid 处理该线程自己的数据块，由线程池并行调用。
+ */
+struct Workload {
+    size_t elements = 0;
+    double flops_per_element = 2.0;
+    double bytes_per_element = SAXPY_BYTES_PER_ELEMENT;      // 一次调用每个元素的内存流量
+    double footprint_bytes_per_element = 2 * sizeof(float);  // 计算阶段访问的不同字节数
+    double reset_bytes_per_element = 0.0;
+    // 普通存储写入一个不在缓存中的行时要先把它读进来（写分配）；这部分流量不在 bytes_per_element 里。
+    // 原地计算写的是刚读过的行，流式存储不做写分配，两者都为 0
+    double write_allocate_bytes_per_element = 0.0;
+    // 每次分发前恢复输入（原地计算时需要）；为空表示没有 reset 阶段
+    std::function<void(size_t tid)> reset;
+    // 对自己的数据块连续执行 reps 次
+    std::function<void(size_t tid, size_t reps)> body;
+    // 非空时 body 通过它领取任务，每次分发前须调用 prepare()；run_workload 据此汇总每个线程的忙碌时间和窃取次数
+    std::shared_ptr<WorkStealingScheduler> scheduler;
+};
+
+struct BenchResult {
+    size_t elements = 0;
+    double flops_per_element = 2.0;
+    double bytes_per_element = SAXPY_BYTES_PER_ELEMENT;
+    double footprint_bytes_per_element = 2 * sizeof(float);
+    double reset_bytes_per_element = 0.0;
+    double write_allocate_bytes_per_element = 0.0;
+    size_t inner_reps = 1;
+    long long iterations = 0;             // 分发次数
+    double total_seconds = 0.0;           // 墙钟时间，包含拷贝
+    double kernel_seconds = 0.0;          // 每次分发从最早开始计算的线程到最晚结束的线程的跨度之和，不含线程池分发开销
+    double dispatch_seconds = 0.0;        // 主线程看到的计算阶段墙钟时间，含线程唤醒和同步
+    double reset_seconds = 0.0;           // 拷贝阶段的墙钟时间
+    Schedule schedule = Schedule::Static;
+    std::vector<ThreadStats> threads;
+    long long warmup_iterations = 0;
+    LatencyHistogram dispatch_ns;         // 每次分发计算阶段的耗时（纳秒）
+    std::vector<CounterValue> counters;   // 所有线程计算阶段的计数之和，顺序同 BenchConfig::counters
+    std::string counters_error;           // 计数器打不开时的原因
+    PageFaults page_faults;               // 计时循环（不含预热）期间整个进程的缺页
+    std::vector<WindowSample> windows;    // 按时间先后排列，跳过没有完整迭代的窗口
+
+    // 内核的总调用次数（不论线程数，每次调用覆盖整个向量）
+    double kernel_calls() const { return static_cast<double>(iterations) * inner_reps; }
+    double gflops() const;
+    double bandwidth_gbs() const;
+    double reset_bandwidth_gbs() const;
+    // 计算阶段搬运的字节数（不含拷贝）
+    double bytes_moved() const { return bytes_per_element * elements * kernel_calls(); }
+    // 估算的实际内存流量：bytes_moved 加上写分配读，用于判断流式存储是否省下了带宽
+    double traffic_bytes() const {
+        return (bytes_per_element + write_allocate_bytes_per_element) * elements * kernel_calls();
+    }
+    double traffic_gbs() const;
+    // 每个窗口按自己的计算时间算出的 GB/s / GFLOPS
+    std::vector<double> window_bandwidth_gbs() const;
+    std::vector<double> window_gflops() const;
+    // 拷贝阶段搬运的字节数
+    double reset_bytes() const { return reset_bytes_per_element * elements * iterations; }
+    size_t footprint_bytes() const { return static_cast<size_t>(footprint_bytes_per_element * elements); }
+    // 单次调用的耗时分布：分发耗时 / inner_reps
+    LatencySummary latency() const;
+    // 线程 tid 每次调用平均处理的元素数：静态划分时就是它的数据块，工作窃取时按实际执行的任务统计
+    double thread_elements(size_t tid, size_t chunk_elements) const;
+    // 线程 tid 的空闲时间：计算阶段的跨度中它没有在执行计算的部分（晚启动、等待最慢线程、找任务）
+    double thread_idle_seconds(size_t tid) const {
+        return std::max(0.0, kernel_seconds - threads[tid].busy_seconds);
+    }
+    // 按名字查找计数；未采集或不可用时返回 nullptr
+    const CounterValue* counter(const char* name) const;
+    double ipc() const;
+};
+
+/**
+ * @brief 按配置运行任意 Workload，直到达到目标时间或固定的迭代次数
+ *
+ * 只使用 config 中与计时相关的字段（kernel / a / mode 由调用方在构造 Workload 时处理）。
+ * 有 reset 阶段且 inner_reps > 1 时，结束后补一次不计时的 reset + 单次调用，
+ * 使输出恰好是一次调用的结果，可以直接用于验证。
+ */
+BenchResult run_workload(ThreadPool& pool, const Workload& work, const BenchConfig& config);
+
+/**
+ * @brief 选择 inner_reps，使每个线程一次分发中的计算至少持续 min_batch_seconds
+ *
+ * 小数组上一次调用只需几十纳秒，和取时间戳的开销处于同一量级；
+ * 在两次读计时器之间连续执行多次，可以把计时误差和分发开销摊薄。
+ */
+size_t calibrate_workload_reps(ThreadPool& pool, const Workload& work, double min_batch_seconds);
+
+/**
+ * @brief 不计时地执行一次 work.body(tid, reps)；有调度器时先恢复所有队列
+ */
+void run_workload_body(ThreadPool& pool, const Workload& work, size_t reps);
+
+/**
+ * @brief SAXPY 的 Workload：按 config.kernel / a / mode 在 ws 上计算
+ *
+ * config.schedule 为 Steal 时每个线程的数据块切成 steal_grain 个元素的任务，
+ * 每个任务连续执行全部 reps 次调用，逐元素的结果与静态划分相同。
+ */
+Workload saxpy_workload(Workspace& ws, const BenchConfig& config);
+
+/**
+ * @brief 按配置运行 SAXPY
+ *
+ * 返回时 Y 恰好等于 a * X + Y_original，可以直接用于结果验证。
+ */
+BenchResult run_benchmark(ThreadPool& pool, Workspace& ws, const BenchConfig& config);
+
+size_t calibrate_inner_reps(ThreadPool& pool, Workspace& ws, const BenchConfig& config,
+                            double min_batch_seconds);
@@ -0,0 +1,384 @@
+#include "blas1.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include "blas1_backends.h"
+#include "cpu_features.h"
+#include "timer.h"
+
+namespace {
+
+// 按精度分派到模板实例；只在循环外分派一次
+template <typename F>
+auto with_precision(Precision p, F&& f) {
+    switch (p) {
+        case Precision::F64: return f(Elem<Precision::F64>{});
+        case Precision::F16: return f(Elem<Precision::F16>{});
+        case Precision::BF16: return f(Elem<Precision::BF16>{});
+        case Precision::F32: break;
+    }
+    return f(Elem<Precision::F32>{});
+}
+
+// X 与 Y 精度不同的混合精度内核：两层分派，f 收到 X 和 Y 的 Elem
+template <typename F>
+auto with_precisions(Precision x, Precision y, F&& f) {
+    return with_precision(x, [&](auto ex) { return with_precision(y, [&](auto ey) { return f(ex, ey); }); });
+}
+
+// 存储格式上的 ULP 距离：fp16 / bf16 解码后才能识别 NaN，位模式的距离与 verify.h 共用
+template <typename E>
+uint32_t storage_ulp(typename E::Storage a, typename E::Storage b) {
+    const double va = E::load(a), vb = E::load(b);
+    typename E::Bits ba, bb;
+    std::memcpy(&ba, &a, sizeof(ba));
+    std::memcpy(&bb, &b, sizeof(bb));
+    return va != va || vb != vb ? UINT32_MAX : ulp_between_bits(ba, bb);
+}
+
+// 计算精度的单位舍入误差
+double unit_roundoff(Precision p) {
+    return p == Precision::F64 ? std::ldexp(1.0, -53) : std::ldexp(1.0, -24);
+}
+
+// 点积参考值的部分和，每个线程一个
+struct alignas(64) DotPartial {
+    long double sum = 0.0L;
+    long double abs_sum = 0.0L;   // sum |x * y|，用于误差上界
+};
+
+double pairwise_total(const std::vector<double>& values) {
+    PairwiseSum<double> tree;
+    for (double v : values) {
+        tree.add(v);
+    }
+    return tree.total();
+}
+
+} // namespace
+
+const char* precision_name(Precision p) {
+    switch (p) {
+        case Precision::F32: return "f32";
+        case Precision::F64: return "f64";
+        case Precision::F16: return "f16";
+        case Precision::BF16: return "bf16";
+    }
+    return "?";
+}
+
+size_t precision_bytes(Precision p) {
+    return with_precision(p, [](auto e) { return sizeof(typename decltype(e)::Storage); });
+}
+
+Precision blas1_y_precision(const Blas1Kernel& kernel) {
+    return kernel.fp32_y ? Precision::F32 : kernel.precision;
+}
+
+std::string blas1_precision_name(const Blas1Kernel& kernel) {
+    std::string name = precision_name(kernel.precision);
+    if (kernel.fp32_y) {
+        name += std::string("/") + precision_name(Precision::F32);
+    }
+    return name;
+}
+
+const char* blas1_op_name(Blas1Op op) {
+    switch (op) {
+        case Blas1Op::Axpy: return "axpy";
+        case Blas1Op::Dot: return "dot";
+        case Blas1Op::Scal: return "scal";
+        case Blas1Op::Copy: return "copy";
+        case Blas1Op::Triad: return "triad";
+    }
+    return "?";
+}
+
+const std::vector<Blas1Kernel>& blas1_kernels() {
+    static const std::vector<Blas1Kernel> kernels = [] {
+        std::vector<Blas1Kernel> out = autovec_blas1_table();
+        if (cpu_features().sve) {
+            for (const Blas1Kernel& sve : sve_blas1_table()) {
+                for (Blas1Kernel& k : out) {
+                    if (std::string(k.name) == sve.name) {
+                        k = sve;
+                    }
+                }
+            }
+        }
+        return out;
+    }();
+    return kernels;
+}
+
+std::vector<const Blas1Kernel*> parse_blas1_list(const std::string& list) {
+    std::vector<const Blas1Kernel*> selected;
+    auto add = [&selected](const Blas1Kernel* kernel) {
+        if (std::find(selected.begin(), selected.end(), kernel) == selected.end()) {
+            selected.push_back(kernel);
+        }
+    };
+
+    std::stringstream ss(list);
+    std::string name;
+    while (std::getline(ss, name, ',')) {
+        if (name == "saxpy") {
+            continue;
+        }
+        bool matched = false;
+        for (const Blas1Kernel& kernel : blas1_kernels()) {
+            // axpy 包含 saxpy 之外的所有精度
+            if (name == "blas1" || name == "all" || name == kernel.name || name == blas1_op_name(kernel.op)) {
+                add(&kernel);
+                matched = true;
+            }
+        }
+        if (!matched) {
+            std::string known = "saxpy";
+            for (const Blas1Kernel& k : blas1_kernels()) {
+                known += std::string(", ") + k.name;
+            }
+            throw std::runtime_error("Unknown operation '" + name + "' (available: " + known +
+                                     ", axpy, dot, scal, copy, triad, blas1)");
+        }
+    }
+    return selected;
+}
+
+bool op_list_includes_saxpy(const std::string& list) {
+    std::stringstream ss(list);
+    std::string name;
+    while (std::getline(ss, name, ',')) {
+        if (name == "saxpy" || name == "axpy" || name == "blas1" || name == "all") {
+            return true;
+        }
+    }
+    return false;
+}
+
+Blas1Workspace::Blas1Workspace(ThreadPool& pool, size_t elements, Precision x_precision, Precision y_precision,
+                               const AllocPolicy& policy)
+    : elements_(elements),
+      x_precision_(x_precision),
+      precision_(y_precision),
+      x_bytes_(precision_bytes(x_precision)),
+      elem_bytes_(precision_bytes(y_precision)),
+      // 按较窄的元素对齐：块边界同时落在 X 和 Y 的缓存行边界上
+      chunks_(static_partition(elements, pool.size(), 64 / std::min(x_bytes_, elem_bytes_))),
+      x_(elements * x_bytes_, policy),
+      y_(elements * elem_bytes_, policy),
+      y_original_(elements * elem_bytes_, policy) {
+    // 与 Workspace 相同的首次访问策略
+    const uint64_t t0 = read_ticks();
+    with_precision(x_precision_, [&](auto e) {
+        using E = decltype(e);
+        using T = typename E::Storage;
+        pool.run([&](size_t tid) {
+            const Range& r = chunks_[tid];
+            T* xs = static_cast<T*>(x());
+            for (size_t i = r.begin; i < r.end; ++i) {
+                xs[i] = E::store(static_cast<typename E::Compute>((i % 64) * 0.25));
+            }
+        });
+        return 0;
+    });
+    with_precision(precision_, [&](auto e) {
+        using E = decltype(e);
+        using T = typename E::Storage;
+        pool.run([&](size_t tid) {
+            const Range& r = chunks_[tid];
+            T* ys = static_cast<T*>(y());
+            T* y0 = static_cast<T*>(y_original());
+            for (size_t i = r.begin; i < r.end; ++i) {
+                y0[i] = E::store(static_cast<typename E::Compute>(((elements_ - i) % 64) * 0.5));
+                ys[i] = y0[i];
+            }
+        });
+        return 0;
+    });
+    init_seconds_ = timer_info().seconds(read_ticks() - t0);
+}
+
+MemoryInfo Blas1Workspace::memory() const {
+    return describe_memory({&x_, &y_, &y_original_}, init_seconds_);
+}
+
+Workload blas1_workload(Blas1Workspace& ws, const Blas1Kernel& kernel, const BenchConfig& config,
+                        std::vector<double>& partial_sums) {
+    // X 与 Y 的元素字节数；只有混合精度内核二者不同
+    const double xs = static_cast<double>(precision_bytes(kernel.precision));
+    const double es = static_cast<double>(precision_bytes(blas1_y_precision(kernel)));
+    // Axpy / Scal 在 Kernel 模式下原地计算
+    const bool in_place = (kernel.op == Blas1Op::Axpy || kernel.op == Blas1Op::Scal) &&
+                          config.mode == MeasureMode::Kernel;
+
+    Workload work;
+    work.elements = ws.size();
+    switch (kernel.op) {
+        case Blas1Op::Axpy:
+            work.flops_per_element = 2.0;
+            work.bytes_per_element = xs + 2 * es;
+            work.footprint_bytes_per_element = xs + (in_place ? 1 : 2) * es;
+            break;
+        case Blas1Op::Scal:
+            work.flops_per_element = 1.0;
+            work.bytes_per_element = 2 * es;
+            work.footprint_bytes_per_element = (in_place ? 1 : 2) * es;
+            break;
+        case Blas1Op::Dot:
+            work.flops_per_element = 2.0;
+            work.bytes_per_element = xs + es;
+            work.footprint_bytes_per_element = xs + es;
+            break;
+        case Blas1Op::Copy:
+            work.flops_per_element = 0.0;
+            work.bytes_per_element = xs + es;
+            work.footprint_bytes_per_element = xs + es;
+            break;
+        case Blas1Op::Triad:
+            work.flops_per_element = 2.0;
+            work.bytes_per_element = xs + 2 * es;
+            work.footprint_bytes_per_element = xs + 2 * es;
+            break;
+    }
+
+    // 除点积外，非原地的操作都写一个没有读过的数组，普通存储要先把它的行读入
+    if (kernel.op != Blas1Op::Dot && !in_place) {
+        work.write_allocate_bytes_per_element = es;
+    }
+
+    if (in_place) {
+        work.reset_bytes_per_element = 2 * es;
+        work.reset = [&ws](size_t tid) {
+            const Range& r = ws.chunks()[tid];
+            const size_t es = precision_bytes(ws.precision());
+            std::memcpy(ws.y(r.begin), ws.y_original(r.begin), r.size() * es);
+        };
+    }
+
+    partial_sums.assign(ws.chunks().size(), 0.0);
+    const Blas1Fn fn = kernel.fn;
+    const Blas1Op op = kernel.op;
+    const double a = config.a;
+    // 原地重复调用时交替使用的第二个系数，使每两次调用后数值回到原来的量级
+    const double a_back = op == Blas1Op::Scal ? (a != 0.0 ? 1.0 / a : 0.0) : -a;
+    work.body = [&ws, &partial_sums, fn, op, a, a_back, in_place](size_t tid, size_t reps) {
+        const Range& r = ws.chunks()[tid];
+        void* y = ws.y(r.begin);
+        const void* x = ws.x(r.begin);
+        const void* src = in_place ? y : ws.y_original(r.begin);
+        if (op == Blas1Op::Dot) {
+            double sum = 0.0;
+            for (size_t rep = 0; rep < reps; ++rep) {
+                sum = fn(a, x, src, nullptr, r.size());
+            }
+            partial_sums[tid] = sum;
+            return;
+        }
+        for (size_t rep = 0; rep < reps; ++rep) {
+            fn(in_place && (rep & 1) ? a_back : a, x, src, y, r.size());
+        }
+    };
+    return work;
+}
+
+BenchResult run_blas1(ThreadPool& pool, Blas1Workspace& ws, const Blas1Kernel& kernel,
+                      const BenchConfig& config, double* dot_result) {
+    std::vector<double> partial_sums;
+    Workload work = blas1_workload(ws, kernel, config, partial_sums);
+    BenchResult result = run_workload(pool, work, config);
+    if (dot_result) {
+        *dot_result = pairwise_total(partial_sums);
+    }
+    return result;
+}
+
+size_t calibrate_blas1_reps(ThreadPool& pool, Blas1Workspace& ws, const Blas1Kernel& kernel,
+                            const BenchConfig& config, double min_batch_seconds) {
+    std::vector<double> partial_sums;
+    return calibrate_workload_reps(pool, blas1_workload(ws, kernel, config, partial_sums), min_batch_seconds);
+}
+
+VerifyResult verify_blas1(ThreadPool& pool, const Blas1Workspace& ws, const Blas1Kernel& kernel,
+                          float a, double dot_result, uint32_t tolerance_ulp) {
+    const uint64_t t0 = read_ticks();
+    VerifyResult result;
+    result.checked = ws.size();
+    result.tolerance_ulp = tolerance_ulp;
+
+    with_precisions(ws.x_precision(), ws.precision(), [&](auto ex, auto e) {
+        using EX = decltype(ex);
+        using E = decltype(e);
+        using T = typename E::Storage;
+        using C = typename E::Compute;
+        const typename EX::Storage* x = static_cast<const typename EX::Storage*>(ws.x());
+        const T* y = static_cast<const T*>(ws.y());
+        const T* y0 = static_cast<const T*>(ws.y_original());
+        // 内核看到的系数已舍入到计算精度
+        const double alpha = static_cast<C>(a);
+        const Blas1Op op = kernel.op;
+        auto reference = [=](size_t i) -> double {
+            const double xi = EX::load(x[i]), y0i = E::load(y0[i]);
+            switch (op) {
+                case Blas1Op::Axpy: return std::fma(alpha, xi, y0i);
+                case Blas1Op::Scal: return alpha * y0i;
+                case Blas1Op::Copy: return xi;
+                case Blas1Op::Triad: return std::fma(alpha, xi, y0i);
+                case Blas1Op::Dot: break;
+            }
+            return 0.0;
+        };
+
+        if (op == Blas1Op::Dot) {
+            std::vector<DotPartial> partial(pool.size());
+            pool.run([&](size_t tid) {
+                const Range& r = ws.chunks()[tid];
+                DotPartial& out = partial[tid];
+                for (size_t i = r.begin; i < r.end; ++i) {
+                    const long double p = static_cast<long double>(EX::load(x[i])) * E::load(y0[i]);
+                    out.sum += p;
+                    out.abs_sum += std::fabs(p);
+                }
+            });
+            long double sum = 0.0L, abs_sum = 0.0L;
+            for (const DotPartial& c : partial) {
+                sum += c.sum;
+                abs_sum += c.abs_sum;
+            }
+            // 树形归约的前向误差上界：(块内链长 + 树高) * u * sum|x*y|
+            const double levels = DOT_MAX_CHAIN + std::ceil(std::log2(std::max<double>(ws.size(), 2.0)));
+            const double bound = tolerance_ulp * levels * unit_roundoff(blas1_y_precision(kernel)) * static_cast<double>(abs_sum);
+            const double expected = static_cast<double>(sum);
+            const C got_c = static_cast<C>(dot_result), expected_c = static_cast<C>(expected);
+            result.max_ulp = ulp_distance_of(expected_c, got_c);
+            if (!(std::fabs(dot_result - expected) <= bound)) {
+                result.mismatches = 1;
+                result.first_index = 0;
+                result.first_expected = expected;
+                result.first_got = dot_result;
+            }
+            return 0;
+        }
+
+        std::vector<UlpScan> partial(pool.size());
+        pool.run([&](size_t tid) {
+            const Range& r = ws.chunks()[tid];
+            partial[tid].scan(r.begin, r.end, tolerance_ulp, [&](size_t i) {
+                return storage_ulp<E>(E::store(static_cast<C>(reference(i))), y[i]);
+            });
+        });
+        const size_t first = merge_ulp_scans(partial, result);
+        if (first != SIZE_MAX) {
+            result.first_expected = E::load(E::store(static_cast<C>(reference(first))));
+            result.first_got = E::load(y[first]);
+        }
+        return 0;
+    });
+
+    result.seconds = timer_info().seconds(read_ticks() - t0);
+    return result;
+}
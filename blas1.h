@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "allocator.h"
+#include "benchmark.h"
+#include "thread_pool.h"
+#include "verify.h"
+
+/**
+ * @brief BLAS-1 套件中的操作
+ *
+ * - Axpy:  y = alpha * x + y（DoubleBuffer 模式下 y = alpha * x + y0）
+ * - Dot:   s = sum(x * y0)，每个线程内做树形归约，线程间再两两相加
+ * - Scal:  y = alpha * y（DoubleBuffer 模式下 y = alpha * y0）
+ * - Copy:  y = x
+ * - Triad: y = y0 + alpha * x，STREAM triad，总是写到独立的输出数组
+ */
+enum class Blas1Op {
+    Axpy,
+    Dot,
+    Scal,
+    Copy,
+    Triad,
+};
+
+// 存储精度；fp16 / bf16 读入后扩展到 fp32 计算，结果再就近舍入回存储格式
+enum class Precision {
+    F32,
+    F64,
+    F16,
+    BF16,
+};
+
+const char* precision_name(Precision p);
+size_t precision_bytes(Precision p);
+
+/**
+ * @brief 统一的 BLAS-1 内核签名（类型擦除，元素类型由 Blas1Kernel::precision / fp32_y 决定）
+ *
+ * 各操作对参数的使用见 Blas1Op；只有 Dot 使用返回值。
+ * 原地计算时 y_in 与 y_out 指向同一块内存。
+ */
+using Blas1Fn = double (*)(double alpha, const void* x, const void* y_in, void* y_out, uint64_t n);
+
+/**
+ * @brief 套件中的一个内核，名字沿用 BLAS 的前缀习惯：daxpy、bfaxpy、sdot、dscal ...
+ *
+ * fp32 的 AXPY 就是原有的 SAXPY 内核（saxpy.h），不在套件里重复。
+ * 混合精度内核（hsaxpy、bfsaxpy）的 X 以 fp16 / bf16 存储，Y 保持 fp32：
+ * 每个元素 10 字节的流量，介于 saxpy（12）和 haxpy / bfaxpy（6）之间，Y 不损失精度。
+ */
+struct Blas1Kernel {
+    const char* name;
+    Blas1Op op;
+    Precision precision;       // X 的存储精度；fp32_y 为 false 时也是 Y 和输出的精度
+    const char* backend;       // "sve" 或 "autovec"
+    const char* description;
+    Blas1Fn fn;
+    bool fp32_y = false;       // 混合精度：Y 和输出以 fp32 存储，在 fp32 中累加
+};
+
+// Y 和输出数组的存储精度
+Precision blas1_y_precision(const Blas1Kernel& kernel);
+
+// 用于显示和报告的精度名：bf16，混合精度时为 X / Y，如 bf16/f32
+std::string blas1_precision_name(const Blas1Kernel& kernel);
+
+/**
+ * @brief 本机可用的 BLAS-1 内核；每个操作只保留优先级最高的后端（sve > autovec）
+ */
+const std::vector<Blas1Kernel>& blas1_kernels();
+
+const char* blas1_op_name(Blas1Op op);
+
+/**
+ * @brief 解析 --op 列表中的套件部分
+ *
+ * 列表项可以是内核名（daxpy）、操作名（dot：该操作的全部精度）或 blas1 / all（全部内核）；
+ * "saxpy" 由原有的 SAXPY 流程处理，这里跳过。遇到未知名字时抛出 std::runtime_error。
+ */
+std::vector<const Blas1Kernel*> parse_blas1_list(const std::string& list);
+
+// --op 列表中是否包含原有的 SAXPY 流程（saxpy / axpy / blas1 / all）
+bool op_list_includes_saxpy(const std::string& list);
+
+/**
+ * @brief 套件使用的 X / Y / Y_original 三个数组，元素类型按精度决定
+ *
+ * X 与 Y（Y_original 与 Y 相同）可以是不同的精度，用于混合精度内核。
+ * 与 Workspace 一样按计算阶段的划分并行首次访问；初始值取小整数的 1/4、1/2 倍，
+ * 在 fp16 / bf16 中也能精确表示，且 AXPY 结果不会溢出。
+ */
+class Blas1Workspace {
+public:
+    Blas1Workspace(ThreadPool& pool, size_t elements, Precision precision,
+                   const AllocPolicy& policy = AllocPolicy{})
+        : Blas1Workspace(pool, elements, precision, precision, policy) {}
+    Blas1Workspace(ThreadPool& pool, size_t elements, Precision x_precision, Precision y_precision,
+                   const AllocPolicy& policy = AllocPolicy{});
+
+    size_t size() const { return elements_; }
+    Precision x_precision() const { return x_precision_; }
+    Precision precision() const { return precision_; }    // Y / Y_original 的精度
+    const std::vector<Range>& chunks() const { return chunks_; }
+
+    // 第 i 个元素的地址
+    void* x(size_t i = 0) const { return x_.as<char>() + i * x_bytes_; }
+    void* y(size_t i = 0) const { return y_.as<char>() + i * elem_bytes_; }
+    void* y_original(size_t i = 0) const { return y_original_.as<char>() + i * elem_bytes_; }
+
+    MemoryInfo memory() const;
+
+private:
+    size_t elements_;
+    Precision x_precision_;
+    Precision precision_;
+    size_t x_bytes_;
+    size_t elem_bytes_;
+    std::vector<Range> chunks_;
+    Allocation x_;
+    Allocation y_;
+    Allocation y_original_;
+    double init_seconds_ = 0.0;
+};
+
+/**
+ * @brief 套件内核的 Workload，使用 config 中的 a 和 mode
+ *
+ * Axpy / Scal 与 SAXPY 一样受 MeasureMode 控制：Kernel 模式原地计算并在每次分发前恢复 Y；
+ * 一次分发内的多次原地调用交替使用 a 与 -a（Scal 为 a 与 1/a），数值不会溢出或变成非规格化数。
+ * Dot / Copy / Triad 不修改输入，没有 reset 阶段。Dot 的各线程部分和写入 partial_sums[tid]。
+ */
+Workload blas1_workload(Blas1Workspace& ws, const Blas1Kernel& kernel, const BenchConfig& config,
+                        std::vector<double>& partial_sums);
+
+/**
+ * @brief 运行一个套件内核；Dot 的最终结果（各线程部分和两两相加）写入 dot_result
+ *
+ * 返回时输出恰好是一次调用的结果，可以直接用于 verify_blas1。
+ */
+BenchResult run_blas1(ThreadPool& pool, Blas1Workspace& ws, const Blas1Kernel& kernel,
+                      const BenchConfig& config, double* dot_result = nullptr);
+
+size_t calibrate_blas1_reps(ThreadPool& pool, Blas1Workspace& ws, const Blas1Kernel& kernel,
+                            const BenchConfig& config, double min_batch_seconds);
+
+/**
+ * @brief 验证最近一次调用的结果
+ *
+ * 向量输出逐元素与 double 参考值（舍入到存储精度）比较 ULP 距离；
+ * Dot 的参考值用 long double 逐项累加，允许的误差为
+ * tolerance_ulp * (DOT_MAX_CHAIN + ceil(log2(n))) * u * sum|x*y|（u 为 Y 存储精度的单位舍入误差），
+ * 即块内链长加树高的归约误差上界乘以容差系数，max_ulp 记录与舍入后参考值的 ULP 距离。
+ */
+VerifyResult verify_blas1(ThreadPool& pool, const Blas1Workspace& ws, const Blas1Kernel& kernel,
+                          float a, double dot_result, uint32_t tolerance_ulp);
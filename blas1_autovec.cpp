@@ -0,0 +1,117 @@
+#include "blas1_backends.h"
+
+// 本文件和 saxpy_autovec.cpp 一样用 -O3 -ftree-vectorize 编译；所有内核都是同一套模板，
+// 按精度实例化。原地模式下 y_in 与 y_out 相同，不能加 __restrict。
+
+namespace {
+
+template <Precision P>
+using StorageOf = typename Elem<P>::Storage;
+
+// PY 与 P 不同时为混合精度：X 按 P 读入并扩展，在 Y 的精度（fp32）中累加
+template <Precision P, Precision PY = P>
+double axpy(double alpha, const void* xv, const void* yv, void* outv, uint64_t n) {
+    using EX = Elem<P>;
+    using E = Elem<PY>;
+    const auto* x = static_cast<const StorageOf<P>*>(xv);
+    const auto* y = static_cast<const StorageOf<PY>*>(yv);
+    auto* out = static_cast<StorageOf<PY>*>(outv);
+    const typename E::Compute a = static_cast<typename E::Compute>(alpha);
+    for (uint64_t i = 0; i < n; ++i) {
+        out[i] = E::store(a * EX::load(x[i]) + E::load(y[i]));
+    }
+    return 0.0;
+}
+
+template <Precision P>
+double scal(double alpha, const void*, const void* yv, void* outv, uint64_t n) {
+    using E = Elem<P>;
+    const auto* y = static_cast<const StorageOf<P>*>(yv);
+    auto* out = static_cast<StorageOf<P>*>(outv);
+    const typename E::Compute a = static_cast<typename E::Compute>(alpha);
+    for (uint64_t i = 0; i < n; ++i) {
+        out[i] = E::store(a * E::load(y[i]));
+    }
+    return 0.0;
+}
+
+template <Precision P>
+double copy(double, const void* xv, const void*, void* outv, uint64_t n) {
+    const auto* x = static_cast<const StorageOf<P>*>(xv);
+    auto* out = static_cast<StorageOf<P>*>(outv);
+    for (uint64_t i = 0; i < n; ++i) {
+        out[i] = x[i];
+    }
+    return 0.0;
+}
+
+// y_out = y_in + alpha * x；y_in 与 y_out 总是不同的数组
+template <Precision P>
+double triad(double alpha, const void* xv, const void* yv, void* outv, uint64_t n) {
+    using E = Elem<P>;
+    const auto* __restrict x = static_cast<const StorageOf<P>*>(xv);
+    const auto* __restrict y = static_cast<const StorageOf<P>*>(yv);
+    auto* __restrict out = static_cast<StorageOf<P>*>(outv);
+    const typename E::Compute a = static_cast<typename E::Compute>(alpha);
+    for (uint64_t i = 0; i < n; ++i) {
+        out[i] = E::store(E::load(y[i]) + a * E::load(x[i]));
+    }
+    return 0.0;
+}
+
+// 点积：块内 LANES 路独立累加（编译器可以直接映射成向量累加器，不需要 -ffast-math），
+// 块内各路两两相加，块和再交给 PairwiseSum 做树形归约
+template <Precision P>
+double dot(double, const void* xv, const void* yv, void*, uint64_t n) {
+    using E = Elem<P>;
+    using T = typename E::Compute;
+    constexpr unsigned LANES = 32;
+    constexpr uint64_t BLOCK = LANES * DOT_MAX_CHAIN;
+    const auto* x = static_cast<const StorageOf<P>*>(xv);
+    const auto* y = static_cast<const StorageOf<P>*>(yv);
+
+    PairwiseSum<T> tree;
+    for (uint64_t begin = 0; begin < n; begin += BLOCK) {
+        const uint64_t end = n - begin < BLOCK ? n : begin + BLOCK;
+        T acc[LANES] = {};
+        uint64_t i = begin;
+        for (; i + LANES <= end; i += LANES) {
+            for (unsigned j = 0; j < LANES; ++j) {
+                acc[j] += E::load(x[i + j]) * E::load(y[i + j]);
+            }
+        }
+        // 尾部单独累加：用变量下标写 acc 会迫使累加器留在内存里
+        T tail = T(0);
+        for (; i < end; ++i) {
+            tail += E::load(x[i]) * E::load(y[i]);
+        }
+        for (unsigned width = LANES / 2; width > 0; width /= 2) {
+            for (unsigned j = 0; j < width; ++j) {
+                acc[j] += acc[j + width];
+            }
+        }
+        tree.add(acc[0] + tail);
+    }
+    return static_cast<double>(tree.total());
+}
+
+} // namespace
+
+const std::vector<Blas1Kernel>& autovec_blas1_table() {
+    static const std::vector<Blas1Kernel> kernels = {
+        {"daxpy",   Blas1Op::Axpy,  Precision::F64,  "autovec", "y = a*x + y, fp64",                     axpy<Precision::F64>},
+        {"haxpy",   Blas1Op::Axpy,  Precision::F16,  "autovec", "y = a*x + y, fp16 storage, fp32 math",  axpy<Precision::F16>},
+        {"bfaxpy",  Blas1Op::Axpy,  Precision::BF16, "autovec", "y = a*x + y, bf16 storage, fp32 math",  axpy<Precision::BF16>},
+        {"hsaxpy",  Blas1Op::Axpy,  Precision::F16,  "autovec", "y = a*x + y, fp16 x, fp32 y",           axpy<Precision::F16, Precision::F32>, true},
+        {"bfsaxpy", Blas1Op::Axpy,  Precision::BF16, "autovec", "y = a*x + y, bf16 x, fp32 y",           axpy<Precision::BF16, Precision::F32>, true},
+        {"sdot",    Blas1Op::Dot,   Precision::F32,  "autovec", "x . y, 32 accumulators + pairwise tree", dot<Precision::F32>},
+        {"ddot",    Blas1Op::Dot,   Precision::F64,  "autovec", "x . y, 32 accumulators + pairwise tree", dot<Precision::F64>},
+        {"sscal",   Blas1Op::Scal,  Precision::F32,  "autovec", "y = a*y, fp32",                         scal<Precision::F32>},
+        {"dscal",   Blas1Op::Scal,  Precision::F64,  "autovec", "y = a*y, fp64",                         scal<Precision::F64>},
+        {"scopy",   Blas1Op::Copy,  Precision::F32,  "autovec", "y = x, fp32",                           copy<Precision::F32>},
+        {"dcopy",   Blas1Op::Copy,  Precision::F64,  "autovec", "y = x, fp64",                           copy<Precision::F64>},
+        {"striad",  Blas1Op::Triad, Precision::F32,  "autovec", "y = y0 + a*x (STREAM triad), fp32",     triad<Precision::F32>},
+        {"dtriad",  Blas1Op::Triad, Precision::F64,  "autovec", "y = y0 + a*x (STREAM triad), fp64",     triad<Precision::F64>},
+    };
+    return kernels;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#include "blas1.h"
+
+// BLAS-1 套件各后端的内核表；约定同 saxpy_backends.h：
+// 只能在 cpu_features() 确认 CPU 支持后才能调用。
+// autovec 表给出完整的内核集合和顺序，sve 表按名字覆盖其中的条目。
+const std::vector<Blas1Kernel>& sve_blas1_table();
+const std::vector<Blas1Kernel>& autovec_blas1_table();
+
+// ---- fp16 / bf16 与 fp32 之间的转换（就近舍入，偶数优先） ----
+// x86 有 F16C 时 fp16 用硬件转换（结果与软件版本逐位相同），否则用软件转换
+
+inline float half_to_float(uint16_t h) {
+#if defined(__F16C__)
+    return _cvtsh_ss(h);
+#else
+    const uint32_t sign = uint32_t(h & 0x8000) << 16;
+    const uint32_t exp = (h >> 10) & 0x1f;
+    const uint32_t mant = h & 0x3ff;
+    uint32_t bits;
+    if (exp == 0x1f) {
+        bits = sign | 0x7f800000u | (mant << 13);
+    } else if (exp == 0) {
+        // 非规格化数：mant * 2^-24
+        const float f = std::ldexp(static_cast<float>(mant), -24);
+        return sign ? -f : f;
+    } else {
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+#endif
+}
+
+inline uint16_t float_to_half(float f) {
+#if defined(__F16C__)
+    return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
+#else
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    const uint16_t sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+    const int exp = static_cast<int>((x >> 23) & 0xff);
+    uint32_t mant = x & 0x7fffff;
+    if (exp == 0xff) {
+        return sign | 0x7c00 | (mant ? 0x200 : 0);
+    }
+    const int e = exp - 127 + 15;
+    if (e >= 0x1f) {
+        return sign | 0x7c00;
+    }
+    if (e <= 0) {
+        if (e < -10) {
+            return sign;
+        }
+        mant |= 0x800000;
+        const int shift = 14 - e;
+        uint32_t h = mant >> shift;
+        const uint32_t rem = mant & ((1u << shift) - 1);
+        const uint32_t half = 1u << (shift - 1);
+        h += rem > half || (rem == half && (h & 1));
+        return static_cast<uint16_t>(sign | h);
+    }
+    uint32_t h = (uint32_t(e) << 10) | (mant >> 13);
+    const uint32_t rem = mant & 0x1fff;
+    // 进位可能溢出到指数域，结果仍然正确（最大有限值向上舍入为无穷）
+    h += rem > 0x1000 || (rem == 0x1000 && (h & 1));
+    return static_cast<uint16_t>(sign | h);
+#endif
+}
+
+inline float bf16_to_float(uint16_t b) {
+    const uint32_t bits = uint32_t(b) << 16;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+inline uint16_t float_to_bf16(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40); // 保持 NaN
+    }
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+/**
+ * @brief 每种精度的存储类型、计算类型和位模式
+ *
+ * fp16 / bf16 以 uint16_t 存储，读入后在 fp32 中计算，写回时舍入。
+ */
+template <Precision P>
+struct Elem;
+
+template <>
+struct Elem<Precision::F32> {
+    using Storage = float;
+    using Compute = float;
+    using Bits = uint32_t;
+    static Compute load(Storage v) { return v; }
+    static Storage store(Compute v) { return v; }
+};
+
+template <>
+struct Elem<Precision::F64> {
+    using Storage = double;
+    using Compute = double;
+    using Bits = uint64_t;
+    static Compute load(Storage v) { return v; }
+    static Storage store(Compute v) { return v; }
+};
+
+template <>
+struct Elem<Precision::F16> {
+    using Storage = uint16_t;
+    using Compute = float;
+    using Bits = uint16_t;
+    static Compute load(Storage v) { return half_to_float(v); }
+    static Storage store(Compute v) { return float_to_half(v); }
+};
+
+template <>
+struct Elem<Precision::BF16> {
+    using Storage = uint16_t;
+    using Compute = float;
+    using Bits = uint16_t;
+    static Compute load(Storage v) { return bf16_to_float(v); }
+    static Storage store(Compute v) { return float_to_bf16(v); }
+};
+
+/**
+ * @brief 按二叉计数器合并的两两求和：每次 add 一个块的和，相同层级的部分和立即相加
+ *
+ * 与逐项累加相比，n 个块之和的舍入误差从 O(n) 降到 O(log n)，且只需要常数空间。
+ */
+template <typename T>
+class PairwiseSum {
+public:
+    void add(T value) {
+        unsigned level = 0;
+        while (occupied_ & (uint64_t(1) << level)) {
+            value = levels_[level] + value;
+            occupied_ &= ~(uint64_t(1) << level);
+            ++level;
+        }
+        levels_[level] = value;
+        occupied_ |= uint64_t(1) << level;
+    }
+
+    // 从低层到高层合并剩余的部分和；只访问被占用的层
+    T total() const {
+        T sum = T(0);
+        for (uint64_t bits = occupied_; bits; bits &= bits - 1) {
+            sum = levels_[__builtin_ctzll(bits)] + sum;
+        }
+        return sum;
+    }
+
+private:
+    T levels_[64];
+    uint64_t occupied_ = 0;
+};
+
+// 点积块内每条累加链的最大长度；验证时的误差上界依赖于它
+constexpr unsigned DOT_MAX_CHAIN = 64;
@@ -0,0 +1,195 @@
+#include "blas1_backends.h"
+
+// 本文件用 -march=...+sve 单独编译；编译器不支持 SVE 时整个后端为空。
+// 所有内核共用 saxpy_sve.cpp 中的谓词循环结构：whilelt 生成尾部掩码，按当前 VL 步进。
+#if defined(__ARM_FEATURE_SVE)
+
+#include <arm_sve.h>
+
+namespace {
+
+// 每种元素类型对应的谓词、步长和广播；加载 / 存储 / 运算使用 ACLE 的重载形式
+template <typename T>
+struct Sve;
+
+template <>
+struct Sve<float> {
+    using Vec = svfloat32_t;
+    static svbool_t whilelt(uint64_t i, uint64_t n) { return svwhilelt_b32(i, n); }
+    static uint64_t count() { return svcntw(); }
+    static Vec dup(float v) { return svdup_n_f32(v); }
+};
+
+template <>
+struct Sve<double> {
+    using Vec = svfloat64_t;
+    static svbool_t whilelt(uint64_t i, uint64_t n) { return svwhilelt_b64(i, n); }
+    static uint64_t count() { return svcntd(); }
+    static Vec dup(double v) { return svdup_n_f64(v); }
+};
+
+template <typename T>
+double axpy(double alpha, const void* xv, const void* yv, void* outv, uint64_t n) {
+    using S = Sve<T>;
+    const T* x = static_cast<const T*>(xv);
+    const T* y = static_cast<const T*>(yv);
+    T* out = static_cast<T*>(outv);
+    const typename S::Vec va = S::dup(static_cast<T>(alpha));
+    for (uint64_t i = 0; i < n; i += S::count()) {
+        svbool_t pg = S::whilelt(i, n);
+        typename S::Vec vx = svld1(pg, x + i);
+        typename S::Vec vy = svld1(pg, y + i);
+        svst1(pg, out + i, svmla_x(pg, vy, vx, va));
+    }
+    return 0.0;
+}
+
+// 扩展到 fp32 计算时各存储格式的加载 / 存储；16 位格式零扩展加载到 32 位通道，
+// 写回时用截断存储取每个通道的低 16 位
+struct F32Lanes {
+    using Storage = float;
+    static svfloat32_t load(svbool_t pg, const float* p) { return svld1(pg, p); }
+    static void store(svbool_t pg, float* p, svfloat32_t v) { svst1(pg, p, v); }
+};
+
+// fp16 位于 32 位通道的低半部分，正是 fcvt 读写的偶数元素；转换由硬件按就近偶数舍入
+struct F16Lanes {
+    using Storage = uint16_t;
+    static svfloat32_t load(svbool_t pg, const uint16_t* p) {
+        return svcvt_f32_f16_x(pg, svreinterpret_f16_u32(svld1uh_u32(pg, p)));
+    }
+    static void store(svbool_t pg, uint16_t* p, svfloat32_t v) {
+        svst1h_u32(pg, p, svreinterpret_u32_f16(svcvt_f16_f32_x(pg, v)));
+    }
+};
+
+// bf16 在基础 SVE 中没有转换指令：左移 16 位即为 fp32，写回时按就近偶数舍入取高 16 位
+struct BF16Lanes {
+    using Storage = uint16_t;
+    static svfloat32_t load(svbool_t pg, const uint16_t* p) {
+        return svreinterpret_f32_u32(svlsl_n_u32_x(pg, svld1uh_u32(pg, p), 16));
+    }
+    static void store(svbool_t pg, uint16_t* p, svfloat32_t v) {
+        svuint32_t bits = svreinterpret_u32_f32(v);
+        svuint32_t lsb = svand_n_u32_x(pg, svlsr_n_u32_x(pg, bits, 16), 1);
+        bits = svadd_u32_x(pg, bits, svadd_n_u32_x(pg, lsb, 0x7fff));
+        svst1h_u32(pg, p, svlsr_n_u32_x(pg, bits, 16));
+    }
+};
+
+// 16 位存储的 AXPY：X / Y 读入后扩展到 fp32 做 svmla，按 Y 的格式写回；
+// Y 为 F32Lanes 时即混合精度（窄 X、fp32 Y），每次按 32 位通道数步进
+template <typename X, typename Y>
+double widening_axpy(double alpha, const void* xv, const void* yv, void* outv, uint64_t n) {
+    const auto* x = static_cast<const typename X::Storage*>(xv);
+    const auto* y = static_cast<const typename Y::Storage*>(yv);
+    auto* out = static_cast<typename Y::Storage*>(outv);
+    const svfloat32_t va = svdup_n_f32(static_cast<float>(alpha));
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, n);
+        Y::store(pg, out + i, svmla_x(pg, Y::load(pg, y + i), X::load(pg, x + i), va));
+    }
+    return 0.0;
+}
+
+template <typename T>
+double scal(double alpha, const void*, const void* yv, void* outv, uint64_t n) {
+    using S = Sve<T>;
+    const T* y = static_cast<const T*>(yv);
+    T* out = static_cast<T*>(outv);
+    const typename S::Vec va = S::dup(static_cast<T>(alpha));
+    for (uint64_t i = 0; i < n; i += S::count()) {
+        svbool_t pg = S::whilelt(i, n);
+        svst1(pg, out + i, svmul_x(pg, svld1(pg, y + i), va));
+    }
+    return 0.0;
+}
+
+template <typename T>
+double copy(double, const void* xv, const void*, void* outv, uint64_t n) {
+    using S = Sve<T>;
+    const T* x = static_cast<const T*>(xv);
+    T* out = static_cast<T*>(outv);
+    for (uint64_t i = 0; i < n; i += S::count()) {
+        svbool_t pg = S::whilelt(i, n);
+        svst1(pg, out + i, svld1(pg, x + i));
+    }
+    return 0.0;
+}
+
+template <typename T>
+double triad(double alpha, const void* xv, const void* yv, void* outv, uint64_t n) {
+    using S = Sve<T>;
+    const T* x = static_cast<const T*>(xv);
+    const T* y = static_cast<const T*>(yv);
+    T* out = static_cast<T*>(outv);
+    const typename S::Vec va = S::dup(static_cast<T>(alpha));
+    for (uint64_t i = 0; i < n; i += S::count()) {
+        svbool_t pg = S::whilelt(i, n);
+        svst1(pg, out + i, svmla_x(pg, svld1(pg, y + i), svld1(pg, x + i), va));
+    }
+    return 0.0;
+}
+
+// 点积：4 个向量累加器轮流使用（合并形式，尾部非活动通道保持原值），
+// 每 DOT_MAX_CHAIN * 4 个向量为一块，块内累加器两两相加后用 svaddv（硬件树形归约）得到块和，
+// 块和再交给 PairwiseSum
+template <typename T>
+double dot(double, const void* xv, const void* yv, void*, uint64_t n) {
+    using S = Sve<T>;
+    using Vec = typename S::Vec;
+    const T* x = static_cast<const T*>(xv);
+    const T* y = static_cast<const T*>(yv);
+    const uint64_t vl = S::count();
+    const uint64_t block = 4 * DOT_MAX_CHAIN * vl;
+    const svbool_t all = S::whilelt(0, vl);
+
+    PairwiseSum<T> tree;
+    for (uint64_t begin = 0; begin < n; begin += block) {
+        const uint64_t end = n - begin < block ? n : begin + block;
+        Vec acc0 = S::dup(T(0)), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        for (uint64_t i = begin; i < end; i += 4 * vl) {
+            svbool_t p0 = S::whilelt(i, end);
+            svbool_t p1 = S::whilelt(i + vl, end);
+            svbool_t p2 = S::whilelt(i + 2 * vl, end);
+            svbool_t p3 = S::whilelt(i + 3 * vl, end);
+            acc0 = svmla_m(p0, acc0, svld1(p0, x + i), svld1(p0, y + i));
+            acc1 = svmla_m(p1, acc1, svld1(p1, x + i + vl), svld1(p1, y + i + vl));
+            acc2 = svmla_m(p2, acc2, svld1(p2, x + i + 2 * vl), svld1(p2, y + i + 2 * vl));
+            acc3 = svmla_m(p3, acc3, svld1(p3, x + i + 3 * vl), svld1(p3, y + i + 3 * vl));
+        }
+        Vec sum = svadd_x(all, svadd_x(all, acc0, acc1), svadd_x(all, acc2, acc3));
+        tree.add(svaddv(all, sum));
+    }
+    return static_cast<double>(tree.total());
+}
+
+} // namespace
+
+const std::vector<Blas1Kernel>& sve_blas1_table() {
+    static const std::vector<Blas1Kernel> kernels = {
+        {"daxpy",  Blas1Op::Axpy,  Precision::F64,  "sve", "whilelt + svmla, fp64",                          axpy<double>},
+        {"haxpy",  Blas1Op::Axpy,  Precision::F16,  "sve", "ld1uh + fcvt to fp32, svmla, fcvt + st1h",       widening_axpy<F16Lanes, F16Lanes>},
+        {"bfaxpy", Blas1Op::Axpy,  Precision::BF16, "sve", "ld1uh + lsl to fp32, svmla, RNE + st1h",         widening_axpy<BF16Lanes, BF16Lanes>},
+        {"hsaxpy", Blas1Op::Axpy,  Precision::F16,  "sve", "ld1uh + fcvt x to fp32, svmla into fp32 y",      widening_axpy<F16Lanes, F32Lanes>, true},
+        {"bfsaxpy", Blas1Op::Axpy, Precision::BF16, "sve", "ld1uh + lsl x to fp32, svmla into fp32 y",       widening_axpy<BF16Lanes, F32Lanes>, true},
+        {"sdot",   Blas1Op::Dot,   Precision::F32,  "sve", "4 accumulators + svaddv + pairwise tree, fp32",  dot<float>},
+        {"ddot",   Blas1Op::Dot,   Precision::F64,  "sve", "4 accumulators + svaddv + pairwise tree, fp64",  dot<double>},
+        {"sscal",  Blas1Op::Scal,  Precision::F32,  "sve", "whilelt + svmul, fp32",                          scal<float>},
+        {"dscal",  Blas1Op::Scal,  Precision::F64,  "sve", "whilelt + svmul, fp64",                          scal<double>},
+        {"scopy",  Blas1Op::Copy,  Precision::F32,  "sve", "whilelt + ld1/st1, fp32",                        copy<float>},
+        {"dcopy",  Blas1Op::Copy,  Precision::F64,  "sve", "whilelt + ld1/st1, fp64",                        copy<double>},
+        {"striad", Blas1Op::Triad, Precision::F32,  "sve", "whilelt + svmla out of place, fp32",             triad<float>},
+        {"dtriad", Blas1Op::Triad, Precision::F64,  "sve", "whilelt + svmla out of place, fp64",             triad<double>},
+    };
+    return kernels;
+}
+
+#else
+
+const std::vector<Blas1Kernel>& sve_blas1_table() {
+    static const std::vector<Blas1Kernel> kernels;
+    return kernels;
+}
+
+#endif // __ARM_FEATURE_SVE
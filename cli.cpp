@@ -0,0 +1,441 @@
+#include "cli.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// 一个选项：长名字、可选的短名字、对应的环境变量
+struct OptionSpec {
+    const char* long_name;
+    char short_name;
+    const char* env;
+    bool takes_value;
+    const char* help;
+};
+
+const std::vector<OptionSpec>& option_specs() {
+    static const std::vector<OptionSpec> specs = {
+        {"size",          'n', "PERF_TEST_SIZE",          true,  "vector length in elements (default 10000000)"},
+        {"scalar",        'a', "PERF_TEST_SCALAR",        true,  "SAXPY scalar a (default 2.5)"},
+        {"duration",      'd', "PERF_TEST_DURATION",      true,  "target run time in seconds per kernel (default 120)"},
+        {"iterations",    'i', "PERF_TEST_ITERATIONS",    true,  "run a fixed number of iterations instead of --duration"},
+        {"samples",       0,   "PERF_TEST_SAMPLES",       true,  "throughput samples per result: equal windows of the timed loop (default 10)"},
+        {"warmup",        'w', "PERF_TEST_WARMUP",        true,  "untimed warmup iterations before measuring (default 10)"},
+        {"batch",         'b', "PERF_TEST_BATCH",         true,  "SAXPY calls per thread between clock reads, 0 = auto (default 0)"},
+        {"kernel",        'k', "PERF_TEST_KERNEL",        true,  "kernel name, comma list, 'all' or 'auto' (default auto: best for this CPU, streaming beyond the LLC)"},
+        {"llc",           0,   "PERF_TEST_LLC",           true,  "last-level cache size for --kernel auto, e.g. 32M; 0 = detect (default 0)"},
+        {"op",            0,   "PERF_TEST_OP",            true,  "operations: saxpy | blas1 | comma list of daxpy, sdot, dot, triad ... (default saxpy)"},
+        {"threads",       't', "PERF_TEST_THREADS",       true,  "worker threads, 0 = all allowed CPUs (default 1)"},
+        {"schedule",      0,   "PERF_TEST_SCHEDULE",      true,  "work distribution for SAXPY and --batched: static | steal (work-stealing, default static)"},
+        {"steal-grain",   0,   "PERF_TEST_STEAL_GRAIN",   true,  "elements per work-stealing task (default 16384)"},
+        {"mode",          'm', "PERF_TEST_MODE",          true,  "measurement mode: kernel | double-buffer (default kernel)"},
+        {"counters",      'c', "PERF_TEST_COUNTERS",      true,  "hardware counters around the kernel: default | all | comma list (default off)"},
+        {"pages",         'p', "PERF_TEST_PAGES",         true,  "vector memory pages: default | thp | 2m | 1g (default: default)"},
+        {"align",         0,   "PERF_TEST_ALIGN",         true,  "vector alignment in bytes, power of two (default: max(64, SVE VL))"},
+        {"mlock",         0,   "PERF_TEST_MLOCK",         false, "mlock the vectors so they cannot be swapped out"},
+        {"x-file",        0,   "PERF_TEST_X_FILE",        true,  "mmap X from a raw float32 file instead of synthetic data"},
+        {"y-file",        0,   "PERF_TEST_Y_FILE",        true,  "mmap initial Y from a raw float32 file instead of synthetic data"},
+        {"populate",      0,   "PERF_TEST_POPULATE",      false, "prefault the input files at mmap time (MAP_POPULATE)"},
+        {"format",        'f', "PERF_TEST_FORMAT",        true,  "stdout format: text | json | csv (default text)"},
+        {"output",        'o', "PERF_TEST_OUTPUT",        true,  "also write the result record to FILE (.csv = CSV, else JSON)"},
+        {"sweep",         0,   "PERF_TEST_SWEEP",         true,  "working-set sweep MIN:MAX, e.g. 1K:1G ('1' = default range)"},
+        {"sweep-seconds", 0,   "PERF_TEST_SWEEP_SECONDS", true,  "measurement time per sweep size (default 0.5)"},
+        {"batched",       0,   "PERF_TEST_BATCHED",       true,  "batched SAXPY over many short vectors: COUNTxN[,COUNTxMIN-MAX...] or default"},
+        {"batched-seconds", 0, "PERF_TEST_BATCHED_SECONDS", true, "measurement time per batched kernel and shape (default 0.5)"},
+        {"fused",         0,   "PERF_TEST_FUSED",         true,  "fused vs unfused pipeline over the sweep sizes (or one --size): axpy,scal,dot stages or default (axpy,dot)"},
+        {"roofline",      0,   "PERF_TEST_ROOFLINE",      false, "measure peak FMA throughput and STREAM bandwidth, report % of roof"},
+        {"roofline-seconds", 0, "PERF_TEST_ROOFLINE_SECONDS", true, "measurement time per roofline micro-kernel (default 1)"},
+        {"dispatch-latency", 0, "PERF_TEST_DISPATCH_LATENCY", false, "measure thread-pool dispatch + barrier round trips (vs spawning threads per call)"},
+        {"dispatch-seconds", 0, "PERF_TEST_DISPATCH_SECONDS", true, "measurement time per dispatch-latency variant (default 1)"},
+        {"mpi-scaling",   0,   "PERF_TEST_MPI_SCALING",   true,  "perf_test_mpi under mpirun: distributed SAXPY over 1, 2, 4 .. N ranks: weak, strong or both"},
+        {"mpi-dot",       0,   "PERF_TEST_MPI_DOT",       false, "with --mpi-scaling: follow each SAXPY with a local dot product and MPI_Allreduce"},
+        {"mpi-seconds",   0,   "PERF_TEST_MPI_SECONDS",   true,  "measurement time per rank count and scaling mode (default 1)"},
+        {"trace",         0,   "PERF_TEST_TRACE",         true,  "record setup / iteration / kernel / task spans per thread and write a Chrome trace JSON to FILE"},
+        {"trace-events",  0,   "PERF_TEST_TRACE_EVENTS",  true,  "trace ring-buffer capacity per thread; the oldest events are overwritten (default 65536)"},
+        {"tile",          0,   "PERF_TEST_TILE",          true,  "cache-blocked SAXPY: bytes per array per tile, e.g. 64K; auto = tuned value from the tuning cache; 0 = off"},
+        {"prefetch",      0,   "PERF_TEST_PREFETCH",      true,  "software prefetch distance in bytes for tiled SAXPY, e.g. 1K; 0 = none (default 0)"},
+        {"tuned",         0,   "PERF_TEST_TUNED",         false, "use the best threads / kernel / pages / tiling cached for this host; tune first if missing"},
+        {"retune",        0,   "PERF_TEST_RETUNE",        false, "with --tile auto or --tuned: ignore the cached entry, re-tune and overwrite it"},
+        {"tune-seconds",  0,   "PERF_TEST_TUNE_SECONDS",  true,  "measurement time per tuning candidate (default 0.05)"},
+        {"tuning-file",   0,   "PERF_TEST_TUNING_FILE",   true,  "tuning cache file (default ~/.cache/perf_test/tuning.ini, or under $XDG_CACHE_HOME)"},
+        {"ulp",           0,   "PERF_TEST_ULP",           true,  "verification tolerance in ULP (default 2)"},
+        {"skip-verify",   0,   "PERF_TEST_SKIP_VERIFY",   false, "skip full-vector verification after each run"},
+        {"list-kernels",  0,   nullptr,                   false, "list kernels and hardware counters available on this CPU and exit"},
+        {"help",          'h', nullptr,                   false, "show this help and exit"},
+    };
+    return specs;
+}
+
+[[noreturn]] void bad_value(const std::string& name, const std::string& value, const char* expected) {
+    throw std::runtime_error("Invalid value '" + value + "' for --" + name + " (expected " + expected + ")");
+}
+
+double parse_double(const std::string& name, const std::string& value) {
+    char* end = nullptr;
+    double parsed = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0') {
+        bad_value(name, value, "a number");
+    }
+    return parsed;
+}
+
+// 非负整数，允许 1e7 这样的写法
+long long parse_count(const std::string& name, const std::string& value) {
+    double parsed = parse_double(name, value);
+    // 先检查范围（也排除 NaN），超出 long long 的 double 转换是未定义行为
+    if (!(parsed >= 0 && parsed < std::ldexp(1.0, 63)) ||
+        parsed != static_cast<double>(static_cast<long long>(parsed))) {
+        bad_value(name, value, "a non-negative integer");
+    }
+    return static_cast<long long>(parsed);
+}
+
+SweepConfig parse_sweep(const std::string& value, SweepConfig sweep) {
+    if (value.empty() || value == "0") {
+        sweep.enabled = false;
+        return sweep;
+    }
+    sweep.enabled = true;
+    size_t colon = value.find(':');
+    if (colon != std::string::npos) {
+        sweep.min_bytes = parse_size(value.substr(0, colon));
+        sweep.max_bytes = parse_size(value.substr(colon + 1));
+    } else if (value != "1") {
+        bad_value("sweep", value, "MIN:MAX such as 1K:1G, or 1");
+    }
+    if (sweep.min_bytes > sweep.max_bytes) {
+        throw std::runtime_error("--sweep: MIN must not exceed MAX.");
+    }
+    return sweep;
+}
+
+void apply(Options& opts, const std::string& name, const std::string& value) {
+    if (name == "size") {
+        long long n = parse_count(name, value);
+        if (n == 0) {
+            bad_value(name, value, "a positive integer");
+        }
+        opts.elements = static_cast<size_t>(n);
+        opts.size_set = true;
+    } else if (name == "scalar") {
+        opts.a = static_cast<float>(parse_double(name, value));
+    } else if (name == "duration") {
+        opts.duration_seconds = parse_double(name, value);
+        if (opts.duration_seconds <= 0) {
+            bad_value(name, value, "a positive number of seconds");
+        }
+    } else if (name == "iterations") {
+        opts.iterations = parse_count(name, value);
+    } else if (name == "samples") {
+        opts.sample_windows = static_cast<size_t>(parse_count(name, value));
+        if (opts.sample_windows == 0) {
+            bad_value(name, value, "a positive integer");
+        }
+    } else if (name == "batch") {
+        opts.batch = static_cast<size_t>(parse_count(name, value));
+    } else if (name == "warmup") {
+        opts.warmup = parse_count(name, value);
+    } else if (name == "kernel") {
+        opts.kernels = value;
+    } else if (name == "llc") {
+        opts.llc_bytes = value == "0" ? 0 : parse_size(value);
+    } else if (name == "op") {
+        if (value.empty()) {
+            bad_value(name, value, "saxpy, blas1 or a comma list of operations");
+        }
+        opts.ops = value;
+    } else if (name == "threads") {
+        opts.threads = static_cast<size_t>(parse_count(name, value));
+    } else if (name == "schedule") {
+        if (value == "static") {
+            opts.schedule = Schedule::Static;
+        } else if (value == "steal") {
+            opts.schedule = Schedule::Steal;
+        } else {
+            bad_value(name, value, "static or steal");
+        }
+    } else if (name == "steal-grain") {
+        opts.steal_grain = static_cast<size_t>(parse_count(name, value));
+        if (opts.steal_grain == 0) {
+            bad_value(name, value, "a positive number of elements");
+        }
+    } else if (name == "mode") {
+        if (value == "kernel") {
+            opts.mode = MeasureMode::Kernel;
+        } else if (value == "double-buffer") {
+            opts.mode = MeasureMode::DoubleBuffer;
+        } else {
+            bad_value(name, value, "kernel or double-buffer");
+        }
+    } else if (name == "counters") {
+        opts.counters = value;
+    } else if (name == "pages") {
+        if (!parse_page_mode(value, opts.alloc.pages)) {
+            bad_value(name, value, "default, thp, 2m or 1g");
+        }
+    } else if (name == "align") {
+        size_t align = parse_size(value);
+        if (align < sizeof(float) || (align & (align - 1)) != 0) {
+            bad_value(name, value, "a power of two of at least 4");
+        }
+        opts.alloc.alignment = align;
+    } else if (name == "mlock") {
+        // 命令行上是开关；环境变量 PERF_TEST_MLOCK=0 表示关闭
+        opts.alloc.lock = value != "0";
+    } else if (name == "x-file") {
+        opts.inputs.x_path = value;
+    } else if (name == "y-file") {
+        opts.inputs.y_path = value;
+    } else if (name == "populate") {
+        opts.inputs.populate = value != "0";
+    } else if (name == "format") {
+        if (value == "text") {
+            opts.format = OutputFormat::Text;
+        } else if (value == "json") {
+            opts.format = OutputFormat::Json;
+        } else if (value == "csv") {
+            opts.format = OutputFormat::Csv;
+        } else {
+            bad_value(name, value, "text, json or csv");
+        }
+    } else if (name == "output") {
+        opts.output_path = value;
+    } else if (name == "sweep") {
+        opts.sweep = parse_sweep(value, opts.sweep);
+    } else if (name == "sweep-seconds") {
+        opts.sweep.seconds_per_size = parse_double(name, value);
+        if (opts.sweep.seconds_per_size <= 0) {
+            bad_value(name, value, "a positive number of seconds");
+        }
+    } else if (name == "batched") {
+        opts.batch_shapes = value == "0" ? std::string() : value;
+    } else if (name == "batched-seconds") {
+        opts.batch_seconds = parse_double(name, value);
+        if (opts.batch_seconds <= 0) {
+            bad_value(name, value, "a positive number of seconds");
+        }
+    } else if (name == "fused") {
+        opts.fused_ops = value == "0" ? std::string() : value;
+    } else if (name == "roofline") {
+        opts.roofline = value != "0";
+    } else if (name == "roofline-seconds") {
+        opts.roofline_seconds = parse_double(name, value);
+        if (opts.roofline_seconds <= 0) {
+            bad_value(name, value, "a positive number");
+        }
+    } else if (name == "dispatch-latency") {
+        opts.dispatch_latency = value != "0";
+    } else if (name == "dispatch-seconds") {
+        opts.dispatch_seconds = parse_double(name, value);
+        if (opts.dispatch_seconds <= 0) {
+            bad_value(name, value, "a positive number of seconds");
+        }
+    } else if (name == "mpi-scaling") {
+        if (value != "weak" && value != "strong" && value != "both" && value != "0") {
+            bad_value(name, value, "weak, strong or both");
+        }
+        opts.mpi_scaling = value == "0" ? std::string() : value;
+    } else if (name == "mpi-dot") {
+        opts.mpi_dot = value != "0";
+    } else if (name == "mpi-seconds") {
+        opts.mpi_seconds = parse_double(name, value);
+        if (opts.mpi_seconds <= 0) {
+            bad_value(name, value, "a positive number of seconds");
+        }
+    } else if (name == "trace") {
+        opts.trace_path = value;
+    } else if (name == "trace-events") {
+        long long n = parse_count(name, value);
+        if (n == 0) {
+            bad_value(name, value, "a positive integer");
+        }
+        opts.trace_events = static_cast<size_t>(n);
+    } else if (name == "tile") {
+        opts.tile_auto = value == "auto";
+        opts.tile_bytes = opts.tile_auto || value == "0" ? 0 : parse_size(value);
+    } else if (name == "prefetch") {
+        opts.prefetch_bytes = value == "0" ? 0 : parse_size(value);
+    } else if (name == "tuned") {
+        opts.tuned = value != "0";
+    } else if (name == "retune") {
+        opts.retune = value != "0";
+    } else if (name == "tune-seconds") {
+        opts.tune_seconds = parse_double(name, value);
+        if (opts.tune_seconds <= 0) {
+            bad_value(name, value, "a positive number of seconds");
+        }
+    } else if (name == "tuning-file") {
+        opts.tuning_file = value;
+    } else if (name == "ulp") {
+        long long ulp = parse_count(name, value);
+        if (ulp > static_cast<long long>(UINT32_MAX)) {
+            bad_value(name, value, "at most 4294967295");
+        }
+        opts.verify_ulp = static_cast<uint32_t>(ulp);
+    } else if (name == "skip-verify") {
+        opts.skip_verify = value != "0";
+    } else if (name == "list-kernels") {
+        opts.list_kernels = true;
+    } else if (name == "help") {
+        opts.help = true;
+    }
+}
+
+const OptionSpec* find_long(const std::string& name) {
+    for (const OptionSpec& spec : option_specs()) {
+        if (name == spec.long_name) {
+            return &spec;
+        }
+    }
+    return nullptr;
+}
+
+const OptionSpec* find_short(char c) {
+    for (const OptionSpec& spec : option_specs()) {
+        if (spec.short_name != 0 && spec.short_name == c) {
+            return &spec;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+const char* output_format_name(OutputFormat format) {
+    switch (format) {
+        case OutputFormat::Text: return "text";
+        case OutputFormat::Json: return "json";
+        case OutputFormat::Csv: return "csv";
+    }
+    return "unknown";
+}
+
+size_t parse_size(const std::string& text) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || !(value > 0)) {
+        throw std::runtime_error("Invalid size: " + text);
+    }
+    switch (*end) {
+        case '\0': break;
+        case 'k': case 'K': value *= 1024.0; ++end; break;
+        case 'm': case 'M': value *= 1024.0 * 1024.0; ++end; break;
+        case 'g': case 'G': value *= 1024.0 * 1024.0 * 1024.0; ++end; break;
+        default: throw std::runtime_error("Invalid size suffix: " + text);
+    }
+    if (*end == 'B' || *end == 'b') {
+        ++end;
+    }
+    if (*end != '\0') {
+        throw std::runtime_error("Invalid size: " + text);
+    }
+    // 同 parse_count：先检查范围（含 inf），再转换；不足 1 字节的值截断后是 0，会被误当成“关闭”
+    if (!(value >= 1.0 && value < std::ldexp(1.0, 64))) {
+        throw std::runtime_error("Invalid size: " + text);
+    }
+    return static_cast<size_t>(value);
+}
+
+Options parse_options(int argc, char** argv) {
+    Options opts;
+
+    // 1. 环境变量（nightly 矩阵里最方便的配置方式）
+    for (const OptionSpec& spec : option_specs()) {
+        if (spec.env == nullptr) {
+            continue;
+        }
+        const char* value = std::getenv(spec.env);
+        if (value != nullptr && *value != '\0') {
+            apply(opts, spec.long_name, value);
+        }
+    }
+
+    // 2. 命令行参数：--name value、--name=value 或 -x value
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const OptionSpec* spec = nullptr;
+        std::string value;
+        bool has_inline_value = false;
+
+        if (arg.rfind("--", 0) == 0) {
+            std::string name = arg.substr(2);
+            size_t eq = name.find('=');
+            if (eq != std::string::npos) {
+                value = name.substr(eq + 1);
+                name = name.substr(0, eq);
+                has_inline_value = true;
+            }
+            spec = find_long(name);
+        } else if (arg.size() == 2 && arg[0] == '-') {
+            spec = find_short(arg[1]);
+        }
+        if (spec == nullptr) {
+            throw std::runtime_error("Unknown option '" + arg + "' (see --help)");
+        }
+
+        if (spec->takes_value && !has_inline_value) {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::string("Option --") + spec->long_name + " requires a value");
+            }
+            value = argv[++i];
+        } else if (!spec->takes_value && has_inline_value) {
+            throw std::runtime_error(std::string("Option --") + spec->long_name + " takes no value");
+        }
+        apply(opts, spec->long_name, value);
+    }
+
+    // 3. 输入文件决定（或约束）向量长度
+    if (opts.inputs.any() && !opts.help && !opts.list_kernels) {
+        size_t available = SIZE_MAX;
+        for (const std::string* path : {&opts.inputs.x_path, &opts.inputs.y_path}) {
+            if (!path->empty()) {
+                available = std::min(available, file_float_count(*path));
+            }
+        }
+        if (available == 0) {
+            throw std::runtime_error("Input files must contain at least one float.");
+        }
+        if (!opts.size_set) {
+            opts.elements = available;
+        } else if (opts.elements > available) {
+            throw std::runtime_error("--size " + std::to_string(opts.elements) + " exceeds the input file length (" +
+                                     std::to_string(available) + " floats).");
+        }
+    }
+    return opts;
+}
+
+void print_usage(std::ostream& out, const char* prog) {
+    out << "Usage: " << prog << " [options]\n\n"
+        << "Options (each can also be set through the listed environment variable):\n";
+    // 说明列对齐到最长的选项之后，至少留一个空格
+    std::vector<std::string> flags;
+    size_t column = 0;
+    for (const OptionSpec& spec : option_specs()) {
+        std::string flag = "  ";
+        flag += spec.short_name ? std::string("-") + spec.short_name + ", " : "    ";
+        flag += std::string("--") + spec.long_name;
+        if (spec.takes_value) {
+            flag += " VALUE";
+        }
+        column = std::max(column, flag.size() + 1);
+        flags.push_back(flag);
+    }
+    for (size_t k = 0; k < option_specs().size(); ++k) {
+        const OptionSpec& spec = option_specs()[k];
+        out << flags[k] << std::string(column - flags[k].size(), ' ') << spec.help;
+        if (spec.env) {
+            out << " [" << spec.env << "]";
+        }
+        out << '\n';
+    }
+    out << "\nCommand-line options override environment variables.\n"
+        << "Exit status: 0 success, 1 invalid options or runtime error, 2 verification failed.\n";
+}
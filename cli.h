@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#include "benchmark.h"
+
+/**
+ * @brief 结果输出格式
+ */
+enum class OutputFormat {
+    Text,   // 人类可读的文本（默认）
+    Json,   // stdout 只输出一条 JSON 记录，文本日志改写到 stderr
+    Csv,    // stdout 只输出 CSV，文本日志改写到 stderr
+};
+
+const char* output_format_name(OutputFormat format);
+
+/**
+ * @brief 工作集扫描配置
+ */
+struct SweepConfig {
+    bool enabled = false;
+    size_t min_bytes = 1024;                       // 1 KiB
+    size_t max_bytes = size_t(1) << 30;            // 1 GiB
+    double seconds_per_size = 0.5;
+};
+
+/**
+ * @brief perf_test 的全部运行参数
+ *
+ * 默认值与早期硬编码的常量一致：1000 万个元素、a = 2.5、运行 120 秒。
+ */
+struct Options {
+    size_t elements = 10000000;
+    bool size_set = false;              // 显式给出了 --size；否则有输入文件时取文件长度
+    float a = 2.5f;
+    double duration_seconds = 120.0;
+    long long iterations = 0;           // > 0 时按固定次数运行，忽略 duration
+    long long warmup = 10;              // 每个内核正式计时前的预热迭代次数
+    size_t sample_windows = 10;         // 每个结果的吞吐量样本数：计时循环等分成的窗口数
+    size_t batch = 0;                   // 两次读计时器之间每个线程连续执行的 SAXPY 次数，0 = 自动
+    std::string kernels;                // 逗号分隔的内核列表或 all；空或 auto 表示按工作集自动选择
+    size_t llc_bytes = 0;               // 自动选择流式存储内核的末级缓存阈值，0 = 从 sysfs 检测
+    std::string ops = "saxpy";          // 要测量的操作：saxpy 和 / 或 BLAS-1 套件（见 blas1.h）
+    std::string counters;               // 硬件计数器：default / all / 逗号分隔的事件名；空表示不采集
+    size_t threads = 1;                 // 0 表示使用全部可用 CPU
+    Schedule schedule = Schedule::Static; // SAXPY 和批量 SAXPY 在线程间的分配方式（见 scheduler.h）
+    size_t steal_grain = DEFAULT_STEAL_GRAIN; // 工作窃取的任务粒度（元素）
+    MeasureMode mode = MeasureMode::Kernel;
+    AllocPolicy alloc;                  // 向量内存的页面类型、对齐和 mlock
+    InputFiles inputs;                  // 从文件映射 X / Y，代替合成数据（只用于 SAXPY）
+    OutputFormat format = OutputFormat::Text;
+    std::string output_path;            // 非空时额外把记录写入该文件（.csv 为 CSV，否则 JSON）
+    SweepConfig sweep;
+    std::string batch_shapes;           // 非空时运行批量 SAXPY 基准（见 batch.h），代替单个长向量
+    std::string fused_ops;              // 非空时在 sweep 的各规模上比较融合 / 非融合的流水线（见 fusion.h）
+    double batch_seconds = 0.5;         // 批量基准中每个 内核 × 布局 × 形状 的测量时间
+    bool roofline = false;              // 先测量峰值 FLOPS 和峰值带宽，给出每个结果占屋顶的百分比
+    double roofline_seconds = 1.0;      // 每个屋顶线微内核的测量时间
+    bool dispatch_latency = false;      // 先测量线程池一次分发 + 屏障的往返耗时（见 dispatch_latency.h）
+    double dispatch_seconds = 1.0;      // 每种分发方式的测量时间
+    std::string mpi_scaling;            // 非空（weak / strong / both）时在 mpirun 下测量分布式 SAXPY 的扩展性（见 mpi_scaling.h）
+    bool mpi_dot = false;               // 分布式 SAXPY 之后做点积并 MPI_Allreduce
+    double mpi_seconds = 1.0;           // 每个 rank 数、每种扩展模式的测量时间
+    std::string trace_path;             // 非空时记录各线程的阶段 / 迭代 / 任务区间并写成 Chrome trace（见 trace.h）
+    size_t trace_events = 65536;        // 每个线程的 trace 环形缓冲区容量（事件数）
+    uint64_t tile_bytes = 0;            // 分块 SAXPY：每个小块每个数组的字节数，0 = 不分块（见 tiling.h）
+    bool tile_auto = false;             // --tile auto：使用调优缓存中的分块 / 预取配置，没有时先调优
+    uint64_t prefetch_bytes = 0;        // 分块 SAXPY 的软件预取提前量（字节），0 = 不预取
+    bool tiled = false;                 // 走分块 SAXPY 内核；--tuned 选中分块内核时设置，即使分块和预取都为 0
+    bool tuned = false;                 // 使用（没有时先生成）本机缓存的最佳线程数 / 内核 / 页面 / 分块（见 tuner.h）
+    bool retune = false;                // --tile auto / --tuned 时忽略缓存，重新调优并覆盖缓存项
+    double tune_seconds = 0.05;         // 调优时每个候选配置的测量时间
+    std::string tuning_file;            // 调优缓存文件；空 = default_tuning_file()
+    uint32_t verify_ulp = 2;            // 整向量验证允许的最大 ULP 距离
+    bool skip_verify = false;
+    bool list_kernels = false;
+    bool help = false;
+};
+
+/**
+ * @brief 先读取 PERF_TEST_* 环境变量，再用命令行参数覆盖
+ *
+ * 给出输入文件而没有 --size 时，向量长度取各文件中较短者的 float 个数；
+ * --size 超过文件长度也报错。参数错误时抛出 std::runtime_error。
+ */
+Options parse_options(int argc, char** argv);
+
+void print_usage(std::ostream& out, const char* prog);
+
+/**
+ * @brief 解析带二进制单位后缀的字节数，例如 "64K"、"8M"、"1G"
+ */
+size_t parse_size(const std::string& text);
@@ -0,0 +1,108 @@
+#include "cpu_features.h"
+
+#include <fstream>
+#include <iterator>
+
+#if defined(__aarch64__)
+#include <sys/auxv.h>
+#include <sys/prctl.h>
+#endif
+
+#if defined(__aarch64__)
+// 旧版内核头文件可能没有这些定义
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD (1UL << 1)
+#endif
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1UL << 22)
+#endif
+#ifndef HWCAP2_SVE2
+#define HWCAP2_SVE2 (1UL << 1)
+#endif
+#ifndef PR_SVE_GET_VL
+#define PR_SVE_GET_VL 51
+#endif
+#ifndef PR_SVE_VL_LEN_MASK
+#define PR_SVE_VL_LEN_MASK 0xffff
+#endif
+#endif
+
+namespace {
+
+// /proc/cpuinfo 中第一次出现的 "field : value" 的值
+std::string cpuinfo_field(const std::string& content, const char* field) {
+    size_t pos = 0;
+    while ((pos = content.find(field, pos)) != std::string::npos) {
+        if (pos == 0 || content[pos - 1] == '\n') {
+            size_t colon = content.find(':', pos);
+            size_t eol = content.find('\n', pos);
+            if (colon != std::string::npos && colon < eol) {
+                size_t begin = content.find_first_not_of(" \t", colon + 1);
+                return begin < eol ? content.substr(begin, eol - begin) : std::string();
+            }
+        }
+        pos += 1;
+    }
+    return std::string();
+}
+
+std::string detect_model() {
+    std::ifstream in("/proc/cpuinfo");
+    const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::string model = cpuinfo_field(content, "model name");
+    if (model.empty()) {
+        // AArch64：与 lscpu 一样由编号确定型号，这里直接保留编号
+        const std::string implementer = cpuinfo_field(content, "CPU implementer");
+        const std::string part = cpuinfo_field(content, "CPU part");
+        if (!implementer.empty() && !part.empty()) {
+            model = "implementer " + implementer + " part " + part;
+        }
+    }
+    return model.empty() ? "unknown" : model;
+}
+
+CpuFeatures detect() {
+    CpuFeatures f;
+#if defined(__aarch64__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    f.neon = (hwcap & HWCAP_ASIMD) != 0;
+    f.sve = (hwcap & HWCAP_SVE) != 0;
+    f.sve2 = f.sve && (hwcap2 & HWCAP2_SVE2) != 0;
+    if (f.sve) {
+        int vl = prctl(PR_SVE_GET_VL);
+        if (vl > 0) {
+            f.sve_vector_bytes = static_cast<unsigned>(vl & PR_SVE_VL_LEN_MASK);
+        }
+    }
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    f.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    f.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+    f.model = detect_model();
+    return f;
+}
+
+} // namespace
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+std::string cpu_feature_string() {
+    const CpuFeatures& f = cpu_features();
+    std::string out;
+    auto add = [&out](bool present, const char* name) {
+        if (present) {
+            out += out.empty() ? name : std::string(" ") + name;
+        }
+    };
+    add(f.neon, "neon");
+    add(f.sve, "sve");
+    add(f.sve2, "sve2");
+    add(f.avx2, "avx2");
+    add(f.avx512f, "avx512f");
+    return out.empty() ? "none" : out;
+}
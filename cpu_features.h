@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @brief 启动时检测到的 CPU 向量扩展
+ *
+ * AArch64 上读取 getauxval(AT_HWCAP/AT_HWCAP2)，x86 上通过 cpuid
+ * （__builtin_cpu_supports，已包含 XGETBV 的操作系统支持检查）。
+ * 型号读不到时为 "unknown"。
+ */
+struct CpuFeatures {
+    bool neon = false;
+    bool sve = false;
+    bool sve2 = false;
+    bool avx2 = false;     // AVX2 + FMA
+    bool avx512f = false;
+    unsigned sve_vector_bytes = 0; // 通过 prctl(PR_SVE_GET_VL) 获取，不执行任何 SVE 指令
+    // /proc/cpuinfo 中的型号：x86 上是 model name；AArch64 没有型号名，用 implementer / part 编号代替
+    std::string model;
+};
+
+/**
+ * @brief 本机 CPU 特性（首次调用时检测，之后缓存）
+ */
+const CpuFeatures& cpu_features();
+
+/**
+ * @brief 以空格分隔的特性列表，例如 "neon sve sve2"
+ */
+std::string cpu_feature_string();
@@ -0,0 +1,111 @@
+#include "dispatch_latency.h"
+
+#include <iomanip>
+#include <ostream>
+#include <thread>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "histogram.h"
+#include "timer.h"
+
+namespace {
+
+// 正式计时前的往返次数：让线程从睡眠转入自旋、代码和数据进入缓存
+constexpr int WARMUP_ROUNDS = 100;
+
+LatencySummary summarize(const LatencyHistogram& hist) {
+    LatencySummary summary;
+    summary.samples = hist.count();
+    summary.min_ns = static_cast<double>(hist.min());
+    summary.median_ns = hist.percentile(0.5);
+    summary.p90_ns = hist.percentile(0.9);
+    summary.p99_ns = hist.percentile(0.99);
+    summary.p999_ns = hist.percentile(0.999);
+    summary.max_ns = static_cast<double>(hist.max());
+    return summary;
+}
+
+// 反复执行 round()，直到累计 seconds 秒；每次往返单独计时
+template <typename F>
+DispatchVariant measure_variant(const char* name, const std::string& description, double seconds, F&& round) {
+    const TimerInfo& timer = timer_info();
+    for (int i = 0; i < WARMUP_ROUNDS; ++i) {
+        round();
+    }
+    LatencyHistogram hist;
+    const uint64_t target = static_cast<uint64_t>(seconds * timer.ticks_per_second);
+    uint64_t total = 0;
+    const uint64_t start = read_ticks();
+    while (read_ticks() - start < target) {
+        const uint64_t t0 = read_ticks();
+        round();
+        const uint64_t ticks = timer.net_ticks(t0, read_ticks());
+        total += ticks;
+        hist.record(static_cast<uint64_t>(timer.seconds(ticks) * 1e9 + 0.5));
+    }
+    DispatchVariant v;
+    v.name = name;
+    v.description = description;
+    v.latency = summarize(hist);
+    v.mean_ns = hist.count() ? timer.seconds(total) * 1e9 / hist.count() : 0.0;
+    return v;
+}
+
+// 每次调用都创建线程：与线程池相同的线程数和绑核，线程体为空
+void spawn_round(const ThreadPool& pool) {
+    std::vector<std::thread> threads;
+    threads.reserve(pool.size());
+    for (size_t tid = 0; tid < pool.size(); ++tid) {
+        const int cpu = pool.slot(tid).cpu;
+        threads.emplace_back([cpu] {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
+
+void print_variant(std::ostream& out, const DispatchVariant& v) {
+    out << "  " << std::left << std::setw(12) << v.name << std::right << std::fixed << std::setprecision(2)
+        << std::setw(12) << v.latency.min_ns / 1e3 << std::setw(12) << v.latency.median_ns / 1e3 << std::setw(12)
+        << v.latency.p99_ns / 1e3 << std::setw(12) << v.mean_ns / 1e3 << std::setw(10) << v.latency.samples
+        << std::defaultfloat << std::setprecision(6) << "  " << v.description << std::endl;
+}
+
+} // namespace
+
+DispatchLatency measure_dispatch_latency(ThreadPool& pool, double seconds, std::ostream* progress) {
+    DispatchLatency result;
+    result.measured = true;
+    result.threads = pool.size();
+    result.worker_spin_ns = pool.worker_spin_ns();
+    result.main_spin_ns = pool.main_spin_ns();
+
+    if (progress) {
+        *progress << "  variant          min(us)  median(us)     p99(us)    mean(us)   samples" << std::endl;
+    }
+    const std::function<void(size_t)> empty = [](size_t) {};
+    auto add = [&](DispatchVariant v) {
+        if (progress) {
+            print_variant(*progress, v);
+        }
+        result.variants.push_back(std::move(v));
+    };
+
+    const std::string defaults = result.worker_spin_ns || result.main_spin_ns
+                                     ? "persistent pool, spin " + std::to_string(result.worker_spin_ns / 1000) +
+                                           " us then futex"
+                                     : std::string("persistent pool, no spin (no spare CPU for the main thread)");
+    add(measure_variant("pool", defaults, seconds, [&] { pool.run(empty); }));
+    pool.set_spin(0, 0);
+    add(measure_variant("pool-futex", "persistent pool, futex wake only", seconds, [&] { pool.run(empty); }));
+    pool.set_spin(result.worker_spin_ns, result.main_spin_ns);
+    add(measure_variant("spawn", "create + pin + join threads per call", seconds, [&] { spawn_round(pool); }));
+    return result;
+}
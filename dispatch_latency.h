@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "thread_pool.h"
+
+/**
+ * @brief 一种分发方式的往返耗时：主线程发出一个空任务到所有线程做完、主线程看到完成为止
+ */
+struct DispatchVariant {
+    std::string name;               // pool / pool-futex / spawn
+    std::string description;
+    LatencySummary latency;         // 每次往返的纳秒数，samples 为测量次数
+    double mean_ns = 0.0;
+};
+
+/**
+ * @brief --dispatch-latency：线程池一次分发 + 屏障的固定开销
+ *
+ * 小数组上一次 SAXPY 只需几十纳秒到几微秒，每次迭代的分发开销决定了能测到的最小规模。
+ * 与每次调用都创建并 join 线程的做法对比，给出常驻线程池省下的代价。
+ */
+struct DispatchLatency {
+    bool measured = false;
+    size_t threads = 0;
+    uint64_t worker_spin_ns = 0;    // 线程池默认的自旋上限
+    uint64_t main_spin_ns = 0;
+    std::vector<DispatchVariant> variants;
+};
+
+/**
+ * @brief 在 pool 上测量三种方式各 seconds 秒
+ *
+ * - pool:       默认设置（先自旋、再 futex 睡眠），即正常测量时的开销
+ * - pool-futex: 不自旋，每次分发和完成都经过 futex 唤醒
+ * - spawn:      每次新建同样多的线程、绑到同样的 CPU 上再 join
+ *
+ * 测完后恢复线程池原来的自旋设置。progress 非空时打印每种方式的结果。
+ */
+DispatchLatency measure_dispatch_latency(ThreadPool& pool, double seconds, std::ostream* progress = nullptr);
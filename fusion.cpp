@@ -0,0 +1,413 @@
+#include "fusion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include "blas1.h"
+#include "blas1_backends.h"
+#include "cpu_features.h"
+#include "fusion_backends.h"
+#include "saxpy.h"
+#include "timer.h"
+
+namespace {
+
+// 各阶段使用的内核：本机默认的 SAXPY、套件的 sscal / sdot，以及 axpy→dot 融合内核；只解析一次
+struct StageKernels {
+    SaxpyFn axpy;
+    Blas1Fn scal;
+    Blas1Fn dot;
+    AxpyDotFn axpy_dot;
+};
+
+Blas1Fn find_blas1_fn(const char* name) {
+    for (const Blas1Kernel& kernel : blas1_kernels()) {
+        if (std::strcmp(kernel.name, name) == 0) {
+            return kernel.fn;
+        }
+    }
+    throw std::runtime_error(std::string("BLAS-1 kernel ") + name + " is not available");
+}
+
+const StageKernels& stage_kernels() {
+    static const StageKernels kernels = {
+        saxpy_kernels().front().fn,
+        find_blas1_fn("sscal"),
+        find_blas1_fn("sdot"),
+        axpy_dot_kernels().front().fn,
+    };
+    return kernels;
+}
+
+// 对 y[begin, begin + n) 执行一个阶段；Dot 的结果累加到 *dot
+inline void apply_stage(const StageKernels& k, const FusedStage& stage, float* y, uint64_t begin, uint64_t n,
+                        double* dot) {
+    switch (stage.op) {
+        case FusedOp::Axpy:
+            k.axpy(stage.alpha, stage.operand + begin, y + begin, y + begin, n);
+            break;
+        case FusedOp::Scal:
+            k.scal(stage.alpha, nullptr, y + begin, y + begin, n);
+            break;
+        case FusedOp::Dot:
+            *dot += k.dot(0.0, y + begin, stage.operand + begin, nullptr, n);
+            break;
+    }
+}
+
+// 每个点积阶段参考值的部分和，每个线程一个
+struct alignas(64) DotPartial {
+    std::vector<long double> sum;
+    std::vector<long double> abs_sum;   // sum |y * z|，用于误差上界
+};
+
+} // namespace
+
+const char* fused_op_name(FusedOp op) {
+    switch (op) {
+        case FusedOp::Axpy: return "axpy";
+        case FusedOp::Scal: return "scal";
+        case FusedOp::Dot: return "dot";
+    }
+    return "?";
+}
+
+const char* fusion_mode_name(FusionMode mode) {
+    switch (mode) {
+        case FusionMode::Unfused: return "unfused";
+        case FusionMode::Blocked: return "blocked";
+        case FusionMode::Fused: return "fused";
+    }
+    return "?";
+}
+
+const std::vector<AxpyDotKernel>& axpy_dot_kernels() {
+    static const std::vector<AxpyDotKernel> kernels = [] {
+        const CpuFeatures& cpu = cpu_features();
+        std::vector<AxpyDotKernel> out;
+        if (cpu.sve) {
+            out.insert(out.end(), sve_axpy_dot_table().begin(), sve_axpy_dot_table().end());
+        }
+        if (cpu.avx512f) {
+            out.insert(out.end(), avx512_axpy_dot_table().begin(), avx512_axpy_dot_table().end());
+        }
+        out.insert(out.end(), autovec_axpy_dot_table().begin(), autovec_axpy_dot_table().end());
+        return out;
+    }();
+    return kernels;
+}
+
+FusedPipeline& FusedPipeline::axpy(float a, const float* x) {
+    stages_.push_back({FusedOp::Axpy, a, x});
+    return *this;
+}
+
+FusedPipeline& FusedPipeline::scal(float a) {
+    stages_.push_back({FusedOp::Scal, a, nullptr});
+    return *this;
+}
+
+FusedPipeline& FusedPipeline::dot(const float* z) {
+    stages_.push_back({FusedOp::Dot, 0.0f, z});
+    return *this;
+}
+
+size_t FusedPipeline::dot_count() const {
+    return static_cast<size_t>(std::count_if(stages_.begin(), stages_.end(),
+                                             [](const FusedStage& s) { return s.op == FusedOp::Dot; }));
+}
+
+void FusedPipeline::run(float* y, const Range& range, double* dots, FusionMode mode) const {
+    const StageKernels& k = stage_kernels();
+    const size_t ndots = dot_count();
+    double scratch = 0.0;
+    if (dots) {
+        std::fill(dots, dots + ndots, 0.0);
+    }
+    auto dot_slot = [&](size_t d) { return dots ? dots + d : &scratch; };
+
+    if (mode == FusionMode::Unfused) {
+        size_t d = 0;
+        for (const FusedStage& stage : stages_) {
+            apply_stage(k, stage, y, range.begin, range.size(), dot_slot(d));
+            d += stage.op == FusedOp::Dot;
+        }
+        return;
+    }
+
+    for (uint64_t begin = range.begin; begin < range.end; begin += FUSION_BLOCK_ELEMENTS) {
+        const uint64_t n = std::min<uint64_t>(FUSION_BLOCK_ELEMENTS, range.end - begin);
+        size_t d = 0;
+        for (size_t s = 0; s < stages_.size(); ++s) {
+            const FusedStage& stage = stages_[s];
+            if (mode == FusionMode::Fused && stage.op == FusedOp::Axpy && s + 1 < stages_.size() &&
+                stages_[s + 1].op == FusedOp::Dot) {
+                *dot_slot(d++) += k.axpy_dot(stage.alpha, stage.operand + begin, y + begin,
+                                             stages_[s + 1].operand + begin, n);
+                ++s;
+                continue;
+            }
+            apply_stage(k, stage, y, begin, n, dot_slot(d));
+            d += stage.op == FusedOp::Dot;
+        }
+    }
+}
+
+double FusedPipeline::flops_per_element() const {
+    double flops = 0.0;
+    for (const FusedStage& stage : stages_) {
+        flops += stage.op == FusedOp::Scal ? 1.0 : 2.0;
+    }
+    return flops;
+}
+
+double FusedPipeline::bytes_per_element(FusionMode mode) const {
+    if (mode == FusionMode::Unfused) {
+        // 每个阶段单独扫一遍：axpy 读 x、y 写 y，scal 读写 y，dot 读 y、z
+        double bytes = 0.0;
+        for (const FusedStage& stage : stages_) {
+            bytes += (stage.op == FusedOp::Axpy ? 3 : 2) * sizeof(float);
+        }
+        return bytes;
+    }
+    // 分块执行时块内的重复访问都命中 L1：y 读一次，有修改时写一次，每个操作数读一次
+    const bool writes = std::any_of(stages_.begin(), stages_.end(),
+                                    [](const FusedStage& s) { return s.op != FusedOp::Dot; });
+    return footprint_bytes_per_element() + (writes ? sizeof(float) : 0);
+}
+
+double FusedPipeline::footprint_bytes_per_element() const {
+    std::vector<const float*> operands;
+    for (const FusedStage& stage : stages_) {
+        if (stage.operand && std::find(operands.begin(), operands.end(), stage.operand) == operands.end()) {
+            operands.push_back(stage.operand);
+        }
+    }
+    return static_cast<double>((1 + operands.size()) * sizeof(float));
+}
+
+std::vector<FusedOp> parse_fused_ops(const std::string& list) {
+    if (list == "default" || list == "1") {
+        return {FusedOp::Axpy, FusedOp::Dot};
+    }
+    std::vector<FusedOp> ops;
+    std::stringstream ss(list);
+    std::string name;
+    while (std::getline(ss, name, ',')) {
+        if (name == "axpy") {
+            ops.push_back(FusedOp::Axpy);
+        } else if (name == "scal") {
+            ops.push_back(FusedOp::Scal);
+        } else if (name == "dot") {
+            ops.push_back(FusedOp::Dot);
+        } else {
+            throw std::runtime_error("Unknown pipeline stage '" + name + "' (available: axpy, scal, dot)");
+        }
+    }
+    if (ops.empty()) {
+        throw std::runtime_error("Empty pipeline: " + list);
+    }
+    return ops;
+}
+
+std::string fused_ops_name(const std::vector<FusedOp>& ops) {
+    std::string name;
+    for (FusedOp op : ops) {
+        name += (name.empty() ? "" : "+") + std::string(fused_op_name(op));
+    }
+    return name;
+}
+
+double fused_footprint_bytes_per_element(const std::vector<FusedOp>& ops) {
+    const bool x = std::find(ops.begin(), ops.end(), FusedOp::Axpy) != ops.end();
+    const bool z = std::find(ops.begin(), ops.end(), FusedOp::Dot) != ops.end();
+    return static_cast<double>((1 + x + z) * sizeof(float));
+}
+
+FusionWorkspace::FusionWorkspace(ThreadPool& pool, size_t elements, const AllocPolicy& policy)
+    : elements_(elements),
+      chunks_(static_partition(elements, pool.size(), 64 / sizeof(float))),
+      x_(elements * sizeof(float), policy),
+      z_(elements * sizeof(float), policy),
+      y_(elements * sizeof(float), policy),
+      y_original_(elements * sizeof(float), policy) {
+    // 与 Workspace 相同的首次访问策略
+    const uint64_t t0 = read_ticks();
+    pool.run([&](size_t tid) {
+        const Range& r = chunks_[tid];
+        float* xs = x_.as<float>();
+        float* zs = z_.as<float>();
+        float* ys = y_.as<float>();
+        float* y0 = y_original_.as<float>();
+        for (size_t i = r.begin; i < r.end; ++i) {
+            xs[i] = static_cast<float>((i % 64) * 0.25);
+            zs[i] = static_cast<float>(((i * 7) % 64) * 0.125);
+            y0[i] = static_cast<float>(((elements_ - i) % 64) * 0.5);
+            ys[i] = y0[i];
+        }
+    });
+    init_seconds_ = timer_info().seconds(read_ticks() - t0);
+}
+
+FusedPipeline FusionWorkspace::pipeline(const std::vector<FusedOp>& ops, float a, bool back) const {
+    // 反向流水线按相反的顺序执行各修改阶段的逆（-a、1/s）；Dot 留在原来的位置上，
+    // 阶段数和访存量与正向相同，纯 axpy→dot 的反向也仍然走融合内核
+    std::vector<FusedOp> modifying;
+    for (FusedOp op : ops) {
+        if (op != FusedOp::Dot) {
+            modifying.push_back(op);
+        }
+    }
+    auto next = modifying.rbegin();
+    FusedPipeline p;
+    for (FusedOp op : ops) {
+        if (back && op != FusedOp::Dot) {
+            op = *next++;
+        }
+        switch (op) {
+            case FusedOp::Axpy: p.axpy(back ? -a : a, x()); break;
+            case FusedOp::Scal: p.scal(back ? 1.0f / FUSION_SCAL_ALPHA : FUSION_SCAL_ALPHA); break;
+            case FusedOp::Dot: p.dot(z()); break;
+        }
+    }
+    return p;
+}
+
+MemoryInfo FusionWorkspace::memory() const {
+    return describe_memory({&x_, &z_, &y_, &y_original_}, init_seconds_);
+}
+
+Workload fusion_workload(FusionWorkspace& ws, const std::vector<FusedOp>& ops, FusionMode mode,
+                         const BenchConfig& config, std::vector<double>& dots) {
+    const FusedPipeline forward = ws.pipeline(ops, config.a);
+    const FusedPipeline back = ws.pipeline(ops, config.a, true);
+    const size_t ndots = forward.dot_count();
+
+    Workload work;
+    work.elements = ws.size();
+    work.flops_per_element = forward.flops_per_element();
+    work.bytes_per_element = forward.bytes_per_element(mode);
+    work.footprint_bytes_per_element = forward.footprint_bytes_per_element();
+    work.reset_bytes_per_element = 2.0 * sizeof(float);
+    work.reset = [&ws](size_t tid) {
+        const Range& r = ws.chunks()[tid];
+        std::copy(ws.y_original() + r.begin, ws.y_original() + r.end, ws.y() + r.begin);
+    };
+
+    dots.assign(ws.chunks().size() * std::max<size_t>(ndots, 1), 0.0);
+    work.body = [&ws, &dots, forward, back, ndots, mode](size_t tid, size_t reps) {
+        const Range& r = ws.chunks()[tid];
+        double* out = ndots ? &dots[tid * ndots] : nullptr;
+        // 一次分发内的多次原地执行交替使用正向和反向流水线，每两次后 Y 回到原值
+        for (size_t rep = 0; rep < reps; ++rep) {
+            (rep & 1 ? back : forward).run(ws.y(), r, out, mode);
+        }
+    };
+    return work;
+}
+
+BenchResult run_fusion(ThreadPool& pool, FusionWorkspace& ws, const std::vector<FusedOp>& ops, FusionMode mode,
+                       const BenchConfig& config, std::vector<double>* dot_results) {
+    std::vector<double> dots;
+    BenchResult result = run_workload(pool, fusion_workload(ws, ops, mode, config, dots), config);
+    if (dot_results) {
+        const size_t ndots = ws.pipeline(ops, config.a).dot_count();
+        dot_results->assign(ndots, 0.0);
+        for (size_t tid = 0; tid < ws.chunks().size(); ++tid) {
+            for (size_t k = 0; k < ndots; ++k) {
+                (*dot_results)[k] += dots[tid * ndots + k];
+            }
+        }
+    }
+    return result;
+}
+
+size_t calibrate_fusion_reps(ThreadPool& pool, FusionWorkspace& ws, const std::vector<FusedOp>& ops,
+                             FusionMode mode, const BenchConfig& config, double min_batch_seconds) {
+    std::vector<double> dots;
+    return calibrate_workload_reps(pool, fusion_workload(ws, ops, mode, config, dots), min_batch_seconds);
+}
+
+VerifyResult verify_fusion(ThreadPool& pool, const FusionWorkspace& ws, const std::vector<FusedOp>& ops,
+                           float a, const std::vector<double>& dot_results, uint32_t tolerance_ulp) {
+    const uint64_t t0 = read_ticks();
+    const FusedPipeline pipeline = ws.pipeline(ops, a);
+    const size_t ndots = pipeline.dot_count();
+    std::vector<UlpScan> partial(pool.size());
+    std::vector<DotPartial> dot_partial(pool.size());
+    VerifyResult result;
+    result.checked = ws.size();
+    result.tolerance_ulp = tolerance_ulp;
+
+    pool.run([&](size_t tid) {
+        const Range& r = ws.chunks()[tid];
+        DotPartial& dots = dot_partial[tid];
+        dots.sum.assign(ndots, 0.0L);
+        dots.abs_sum.assign(ndots, 0.0L);
+        const float* y = ws.y();
+        const float* y0 = ws.y_original();
+        // 逐阶段计算参考值，每步舍入到 float；每个元素只算一次，点积的参考值顺带累加
+        partial[tid].scan(r.begin, r.end, tolerance_ulp, [&](size_t i) {
+            float ref = y0[i];
+            size_t d = 0;
+            for (const FusedStage& stage : pipeline.stages()) {
+                switch (stage.op) {
+                    case FusedOp::Axpy:
+                        ref = static_cast<float>(std::fma(static_cast<double>(stage.alpha), stage.operand[i], ref));
+                        break;
+                    case FusedOp::Scal:
+                        ref = static_cast<float>(static_cast<double>(stage.alpha) * ref);
+                        break;
+                    case FusedOp::Dot: {
+                        const long double p = static_cast<long double>(ref) * stage.operand[i];
+                        dots.sum[d] += p;
+                        dots.abs_sum[d] += std::fabs(p);
+                        ++d;
+                        break;
+                    }
+                }
+            }
+            return ulp_distance(ref, y[i]);
+        });
+    });
+
+    const size_t first = merge_ulp_scans(partial, result);
+    if (first != SIZE_MAX) {
+        result.first_got = ws.y()[first];
+        // 重新算一次出错元素的参考值
+        float ref = ws.y_original()[first];
+        for (const FusedStage& stage : pipeline.stages()) {
+            if (stage.op == FusedOp::Axpy) {
+                ref = static_cast<float>(std::fma(static_cast<double>(stage.alpha), stage.operand[first], ref));
+            } else if (stage.op == FusedOp::Scal) {
+                ref = static_cast<float>(static_cast<double>(stage.alpha) * ref);
+            }
+        }
+        result.first_expected = ref;
+    }
+
+    // 点积：误差上界同 verify_blas1（块内链长 + 树高）* u * sum|y*z|
+    const double levels = DOT_MAX_CHAIN + std::ceil(std::log2(std::max<double>(ws.size(), 2.0)));
+    for (size_t k = 0; k < ndots && k < dot_results.size(); ++k) {
+        long double sum = 0.0L, abs_sum = 0.0L;
+        for (const DotPartial& c : dot_partial) {
+            sum += c.sum[k];
+            abs_sum += c.abs_sum[k];
+        }
+        const double bound = tolerance_ulp * levels * std::ldexp(1.0, -24) * static_cast<double>(abs_sum);
+        const double expected = static_cast<double>(sum);
+        if (!(std::fabs(dot_results[k] - expected) <= bound)) {
+            if (result.dot_mismatches == 0) {
+                result.first_dot = k;
+                result.dot_expected = expected;
+                result.dot_got = dot_results[k];
+            }
+            ++result.dot_mismatches;
+        }
+    }
+    result.seconds = timer_info().seconds(read_ticks() - t0);
+    return result;
+}
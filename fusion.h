@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "allocator.h"
+#include "benchmark.h"
+#include "thread_pool.h"
+#include "verify.h"
+
+/**
+ * @brief 流水线中作用在同一个 Y 上的操作
+ *
+ * - Axpy: y = alpha * x + y
+ * - Scal: y = alpha * y
+ * - Dot:  s = sum(y * z)，用的是前面各阶段执行完之后的 y
+ */
+enum class FusedOp {
+    Axpy,
+    Scal,
+    Dot,
+};
+
+const char* fused_op_name(FusedOp op);
+
+struct FusedStage {
+    FusedOp op;
+    float alpha;            // Axpy / Scal 的系数；Dot 不使用
+    const float* operand;   // Axpy 的 x、Dot 的 z（下标与 y 相同）；Scal 为 nullptr
+};
+
+/**
+ * @brief 寄存器级融合的 y = a * x + y; s = sum(y * z)：每个元素只读一次 y，
+ *        新的 y 写回的同时直接乘 z 累加，返回 s
+ *
+ * 累加方式与套件的 sdot 相同（块内链长不超过 DOT_MAX_CHAIN，块和做两两求和），误差上界一致。
+ */
+using AxpyDotFn = double (*)(float a, const float* x, float* y, const float* z, uint64_t n);
+
+struct AxpyDotKernel {
+    const char* name;
+    const char* backend;
+    const char* description;
+    AxpyDotFn fn;
+};
+
+/**
+ * @brief 本机可用的 axpy→dot 融合内核，按后端优先级排列（sve > avx512 > autovec）；第一个是默认内核
+ */
+const std::vector<AxpyDotKernel>& axpy_dot_kernels();
+
+/**
+ * @brief 流水线的执行方式
+ *
+ * - Unfused: 每个阶段完整地扫一遍 y，相当于依次调用各个 BLAS-1 函数
+ * - Blocked: 按 FUSION_BLOCK_ELEMENTS 分块，每块依次执行所有阶段，后续阶段从 L1 读 y
+ * - Fused:   在 Blocked 的基础上把相邻的 axpy→dot 换成寄存器级融合内核
+ */
+enum class FusionMode {
+    Unfused,
+    Blocked,
+    Fused,
+};
+
+const char* fusion_mode_name(FusionMode mode);
+
+// 分块大小：y 和两个操作数各 8 KiB，合起来留在 32 KiB 的 L1 里
+constexpr uint64_t FUSION_BLOCK_ELEMENTS = 2048;
+
+/**
+ * @brief 一串作用在同一个 Y 上的 BLAS-1 操作，例如
+ *
+ *     FusedPipeline().axpy(a, x).dot(z).run(y, n, &s);
+ *
+ * 等价于 y = a * x + y; s = dot(y, z)，但只扫一遍内存。各阶段使用本机默认的 SAXPY / sscal / sdot 内核。
+ */
+class FusedPipeline {
+public:
+    FusedPipeline& axpy(float a, const float* x);
+    FusedPipeline& scal(float a);
+    FusedPipeline& dot(const float* z);
+
+    const std::vector<FusedStage>& stages() const { return stages_; }
+    size_t dot_count() const;
+
+    /**
+     * @brief 对 y[range) 执行所有阶段，操作数使用相同的下标区间
+     *
+     * dots 依次接收各 Dot 阶段在该区间上的结果（dot_count() 个），为空时不写。
+     */
+    void run(float* y, const Range& range, double* dots, FusionMode mode = FusionMode::Fused) const;
+    void run(float* y, uint64_t n, double* dots, FusionMode mode = FusionMode::Fused) const {
+        run(y, Range{0, n}, dots, mode);
+    }
+
+    // 一次执行每个元素的浮点运算数和各方式的内存流量（字节 / 元素）
+    double flops_per_element() const;
+    double bytes_per_element(FusionMode mode) const;
+    // 访问的不同数组的字节数 / 元素：y 加上各不相同的操作数
+    double footprint_bytes_per_element() const;
+
+private:
+    std::vector<FusedStage> stages_;
+};
+
+/**
+ * @brief 解析逗号分隔的阶段列表：axpy / scal / dot，"default" 或 "1" 为 axpy,dot
+ *
+ * 未知阶段名时抛出 std::runtime_error。
+ */
+std::vector<FusedOp> parse_fused_ops(const std::string& list);
+
+// 阶段列表的显示名，例如 "axpy+dot"
+std::string fused_ops_name(const std::vector<FusedOp>& ops);
+
+// FusionWorkspace 上的流水线访问的字节数 / 元素：y，有 axpy 时加 x，有 dot 时加 z
+double fused_footprint_bytes_per_element(const std::vector<FusedOp>& ops);
+
+/**
+ * @brief 流水线基准的 X / Z / Y / Y_original
+ *
+ * 与 Blas1Workspace 一样按计算阶段的划分并行首次访问；初始值是小整数的 1/4、1/2、1/8 倍，
+ * 交替执行正向流水线和 pipeline(ops, a, true) 构造的反向流水线时数值精确地回到原值。
+ */
+class FusionWorkspace {
+public:
+    FusionWorkspace(ThreadPool& pool, size_t elements, const AllocPolicy& policy = AllocPolicy{});
+
+    size_t size() const { return elements_; }
+    const std::vector<Range>& chunks() const { return chunks_; }
+
+    const float* x() const { return x_.as<float>(); }
+    const float* z() const { return z_.as<float>(); }
+    float* y() const { return y_.as<float>(); }
+    const float* y_original() const { return y_original_.as<float>(); }
+
+    // 按 ops 和 a 构造作用在本工作区上的流水线；back 为 true 时构造其逆：修改阶段倒序、
+    // 系数取逆（-a、1/s），Dot 阶段保持原位置
+    FusedPipeline pipeline(const std::vector<FusedOp>& ops, float a, bool back = false) const;
+
+    MemoryInfo memory() const;
+
+private:
+    size_t elements_;
+    std::vector<Range> chunks_;
+    Allocation x_;
+    Allocation z_;
+    Allocation y_;
+    Allocation y_original_;
+    double init_seconds_ = 0.0;
+};
+
+// Scal 阶段的系数：2 的幂，来回相乘没有舍入
+constexpr float FUSION_SCAL_ALPHA = 0.5f;
+
+/**
+ * @brief 流水线的 Workload：原地计算，每次分发前从 Y_original 恢复 Y（拷贝单独计时）
+ *
+ * 各线程各 Dot 阶段的结果写入 dots[tid * dot_count + k]。
+ */
+Workload fusion_workload(FusionWorkspace& ws, const std::vector<FusedOp>& ops, FusionMode mode,
+                         const BenchConfig& config, std::vector<double>& dots);
+
+/**
+ * @brief 运行流水线；返回时 Y 恰好是一次执行的结果，dot_results 为各 Dot 阶段的最终结果
+ */
+BenchResult run_fusion(ThreadPool& pool, FusionWorkspace& ws, const std::vector<FusedOp>& ops, FusionMode mode,
+                       const BenchConfig& config, std::vector<double>* dot_results = nullptr);
+
+size_t calibrate_fusion_reps(ThreadPool& pool, FusionWorkspace& ws, const std::vector<FusedOp>& ops,
+                             FusionMode mode, const BenchConfig& config, double min_batch_seconds);
+
+/**
+ * @brief 检查最近一次执行的 Y 和各 Dot 阶段的结果
+ *
+ * Y 的参考值逐阶段计算、每步舍入到 float（与内核的 FMA 舍入一致），按 ULP 比较；
+ * 点积的参考值用 long double 累加，误差上界同 verify_blas1；点积的不匹配记在 dot_mismatches / first_dot，
+ * 不计入元素的 mismatches。
+ */
+VerifyResult verify_fusion(ThreadPool& pool, const FusionWorkspace& ws, const std::vector<FusedOp>& ops,
+                           float a, const std::vector<double>& dot_results, uint32_t tolerance_ulp);
@@ -0,0 +1,49 @@
+#include "fusion_backends.h"
+
+#include "blas1_backends.h"
+
+// 本文件和 blas1_autovec.cpp 一样用 -O3 -ftree-vectorize 编译；累加方式与那里的 sdot 相同。
+// y 与 x / z 是不同的数组，可以加 __restrict
+
+namespace {
+
+double axpy_dot(float a, const float* __restrict x, float* __restrict y, const float* __restrict z, uint64_t n) {
+    constexpr unsigned LANES = 32;
+    constexpr uint64_t BLOCK = LANES * DOT_MAX_CHAIN;
+
+    PairwiseSum<float> tree;
+    for (uint64_t begin = 0; begin < n; begin += BLOCK) {
+        const uint64_t end = n - begin < BLOCK ? n : begin + BLOCK;
+        float acc[LANES] = {};
+        uint64_t i = begin;
+        for (; i + LANES <= end; i += LANES) {
+            for (unsigned j = 0; j < LANES; ++j) {
+                const float r = a * x[i + j] + y[i + j];
+                y[i + j] = r;
+                acc[j] += r * z[i + j];
+            }
+        }
+        float tail = 0.0f;
+        for (; i < end; ++i) {
+            const float r = a * x[i] + y[i];
+            y[i] = r;
+            tail += r * z[i];
+        }
+        for (unsigned width = LANES / 2; width > 0; width /= 2) {
+            for (unsigned j = 0; j < width; ++j) {
+                acc[j] += acc[j + width];
+            }
+        }
+        tree.add(acc[0] + tail);
+    }
+    return static_cast<double>(tree.total());
+}
+
+} // namespace
+
+const std::vector<AxpyDotKernel>& autovec_axpy_dot_table() {
+    static const std::vector<AxpyDotKernel> table = {
+        {"autovec", "autovec", "compiler-vectorized axpy and dot in one loop, 32 accumulators", axpy_dot},
+    };
+    return table;
+}
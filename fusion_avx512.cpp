@@ -0,0 +1,74 @@
+#include "fusion_backends.h"
+
+// 本文件用 -mavx512f 单独编译
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+#include "blas1_backends.h"
+
+namespace {
+
+inline __mmask16 lane_mask(uint64_t left) {
+    return left >= 16 ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << left) - 1);
+}
+
+// 一步：r = a * x + y 写回 y，acc += r * z；掩码外的通道读成 0，不影响累加器
+inline __m512 step(__m512 va, const float* x, float* y, const float* z, __mmask16 m, __m512 acc) {
+    __m512 r = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(m, x), _mm512_maskz_loadu_ps(m, y));
+    _mm512_mask_storeu_ps(y, m, r);
+    return _mm512_fmadd_ps(r, _mm512_maskz_loadu_ps(m, z), acc);
+}
+
+// 4 倍展开，每块 DOT_MAX_CHAIN 轮；块尾不足 64 个元素时做一轮 4 步掩码操作，每个累加器的链长不超过上限
+double axpy_dot_avx512(float a, const float* x, float* y, const float* z, uint64_t n) {
+    constexpr uint64_t BLOCK = 64 * DOT_MAX_CHAIN;
+    const __m512 va = _mm512_set1_ps(a);
+    const __mmask16 full = 0xFFFF;
+
+    PairwiseSum<float> tree;
+    for (uint64_t begin = 0; begin < n; begin += BLOCK) {
+        const uint64_t end = n - begin < BLOCK ? n : begin + BLOCK;
+        __m512 acc0 = _mm512_setzero_ps(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        uint64_t i = begin;
+        for (; i + 64 <= end; i += 64) {
+            acc0 = step(va, x + i,      y + i,      z + i,      full, acc0);
+            acc1 = step(va, x + i + 16, y + i + 16, z + i + 16, full, acc1);
+            acc2 = step(va, x + i + 32, y + i + 32, z + i + 32, full, acc2);
+            acc3 = step(va, x + i + 48, y + i + 48, z + i + 48, full, acc3);
+        }
+        if (i < end) {
+            const uint64_t left = end - i;
+            acc0 = step(va, x + i, y + i, z + i, lane_mask(left), acc0);
+            if (left > 16) {
+                acc1 = step(va, x + i + 16, y + i + 16, z + i + 16, lane_mask(left - 16), acc1);
+            }
+            if (left > 32) {
+                acc2 = step(va, x + i + 32, y + i + 32, z + i + 32, lane_mask(left - 32), acc2);
+            }
+            if (left > 48) {
+                acc3 = step(va, x + i + 48, y + i + 48, z + i + 48, lane_mask(left - 48), acc3);
+            }
+        }
+        tree.add(_mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3))));
+    }
+    return static_cast<double>(tree.total());
+}
+
+} // namespace
+
+const std::vector<AxpyDotKernel>& avx512_axpy_dot_table() {
+    static const std::vector<AxpyDotKernel> table = {
+        {"avx512", "avx512", "4x unrolled vfmadd, y stored and vfmadd into 4 dot accumulators", axpy_dot_avx512},
+    };
+    return table;
+}
+
+#else
+
+const std::vector<AxpyDotKernel>& avx512_axpy_dot_table() {
+    static const std::vector<AxpyDotKernel> empty;
+    return empty;
+}
+
+#endif // __AVX512F__
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <vector>
+
+#include "fusion.h"
+
+// axpy→dot 融合内核各后端的表；约定同 saxpy_backends.h：
+// 每个表定义在对应 ISA 的翻译单元里，只能在 cpu_features() 确认 CPU 支持后才能调用。
+const std::vector<AxpyDotKernel>& sve_axpy_dot_table();
+const std::vector<AxpyDotKernel>& avx512_axpy_dot_table();
+const std::vector<AxpyDotKernel>& autovec_axpy_dot_table();
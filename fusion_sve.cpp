@@ -0,0 +1,64 @@
+#include "fusion_backends.h"
+
+// 本文件用 -march=armv8.2-a+sve 单独编译
+#if defined(__ARM_FEATURE_SVE)
+
+#include <arm_sve.h>
+
+#include "blas1_backends.h"
+
+namespace {
+
+// sve_saxpy 的谓词循环上加一条点积链：svmla 得到新的 y，写回的同时 svmla_m 累加 y * z；
+// 4 个累加器轮流使用，分块和归约方式与 blas1_sve.cpp 的 sdot 相同
+double axpy_dot_sve(float a, const float* x, float* y, const float* z, uint64_t n) {
+    const uint64_t vl = svcntw();
+    const uint64_t block = 4 * DOT_MAX_CHAIN * vl;
+    const svbool_t all = svptrue_b32();
+    const svfloat32_t va = svdup_f32(a);
+
+    PairwiseSum<float> tree;
+    for (uint64_t begin = 0; begin < n; begin += block) {
+        const uint64_t end = n - begin < block ? n : begin + block;
+        svfloat32_t acc0 = svdup_f32(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        for (uint64_t i = begin; i < end; i += 4 * vl) {
+            svbool_t p0 = svwhilelt_b32(i, end);
+            svbool_t p1 = svwhilelt_b32(i + vl, end);
+            svbool_t p2 = svwhilelt_b32(i + 2 * vl, end);
+            svbool_t p3 = svwhilelt_b32(i + 3 * vl, end);
+            svfloat32_t r0 = svmla_x(p0, svld1(p0, y + i), svld1(p0, x + i), va);
+            svfloat32_t r1 = svmla_x(p1, svld1(p1, y + i + vl), svld1(p1, x + i + vl), va);
+            svfloat32_t r2 = svmla_x(p2, svld1(p2, y + i + 2 * vl), svld1(p2, x + i + 2 * vl), va);
+            svfloat32_t r3 = svmla_x(p3, svld1(p3, y + i + 3 * vl), svld1(p3, x + i + 3 * vl), va);
+            svst1(p0, y + i, r0);
+            svst1(p1, y + i + vl, r1);
+            svst1(p2, y + i + 2 * vl, r2);
+            svst1(p3, y + i + 3 * vl, r3);
+            acc0 = svmla_m(p0, acc0, r0, svld1(p0, z + i));
+            acc1 = svmla_m(p1, acc1, r1, svld1(p1, z + i + vl));
+            acc2 = svmla_m(p2, acc2, r2, svld1(p2, z + i + 2 * vl));
+            acc3 = svmla_m(p3, acc3, r3, svld1(p3, z + i + 3 * vl));
+        }
+        svfloat32_t sum = svadd_x(all, svadd_x(all, acc0, acc1), svadd_x(all, acc2, acc3));
+        tree.add(svaddv(all, sum));
+    }
+    return static_cast<double>(tree.total());
+}
+
+} // namespace
+
+const std::vector<AxpyDotKernel>& sve_axpy_dot_table() {
+    static const std::vector<AxpyDotKernel> table = {
+        {"sve", "sve", "whilelt + svmla, y stored and svmla_m into 4 dot accumulators", axpy_dot_sve},
+    };
+    return table;
+}
+
+#else
+
+const std::vector<AxpyDotKernel>& sve_axpy_dot_table() {
+    static const std::vector<AxpyDotKernel> empty;
+    return empty;
+}
+
+#endif // __ARM_FEATURE_SVE
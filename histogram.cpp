@@ -0,0 +1,74 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 覆盖整个 uint64_t 范围所需的桶数：线性部分 + 每个 2 的幂一段
+constexpr size_t BUCKET_COUNT =
+    LatencyHistogram::SUB_BUCKETS + (64 - LatencyHistogram::SUB_BUCKET_BITS) * LatencyHistogram::SUB_BUCKETS;
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : buckets_(BUCKET_COUNT, 0) {}
+
+uint64_t LatencyHistogram::bucket_lower(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    uint64_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << shift;
+}
+
+uint64_t LatencyHistogram::bucket_width(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return 1;
+    }
+    return uint64_t(1) << ((index - SUB_BUCKETS) / SUB_BUCKETS);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::clear() {
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+double LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    // 最近秩（nearest-rank）：第 ceil(q * count) 个样本，至少为第 1 个
+    q = std::min(std::max(q, 0.0), 1.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * count_)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            double mid = bucket_lower(i) + (bucket_width(i) - 1) / 2.0;
+            return std::min(std::max(mid, static_cast<double>(min_)), static_cast<double>(max_));
+        }
+    }
+    return static_cast<double>(max_);
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> LatencyHistogram::nonzero_buckets() const {
+    std::vector<std::pair<uint64_t, uint64_t>> out;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (buckets_[i]) {
+            out.emplace_back(bucket_lower(i), buckets_[i]);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 对数-线性（log-linear）直方图，用于记录每次迭代的耗时
+ *
+ * 与 HdrHistogram 的思路相同：小于 2^SUB_BUCKET_BITS 的值逐个计数，
+ * 更大的值按 2 的幂分段，每段再均分为 2^SUB_BUCKET_BITS 个桶。
+ * 相对误差不超过 1 / 2^SUB_BUCKET_BITS（约 3%），桶数固定，
+ * record() 只是一次 clz 加一次数组自增，不分配内存，可以放在测量循环里。
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+
+    LatencyHistogram();
+
+    void record(uint64_t value) {
+        ++buckets_[bucket_index(value)];
+        ++count_;
+        if (value < min_) min_ = value;
+        if (value > max_) max_ = value;
+    }
+
+    void merge(const LatencyHistogram& other);
+    void clear();
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+
+    /**
+     * @brief 第 q 分位数（0 <= q <= 1），取所在桶的中点并限制在 [min, max] 内
+     */
+    double percentile(double q) const;
+
+    /**
+     * @brief 非空桶的 (下界, 计数) 列表，按下界升序
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> nonzero_buckets() const;
+
+private:
+    static size_t bucket_index(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        unsigned shift = exponent - SUB_BUCKET_BITS;
+        return static_cast<size_t>(SUB_BUCKETS + uint64_t(shift) * SUB_BUCKETS +
+                                   ((value >> shift) - SUB_BUCKETS));
+    }
+    static uint64_t bucket_lower(size_t index);
+    static uint64_t bucket_width(size_t index);
+
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
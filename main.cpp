@@ -1,132 +1,1081 @@
 #include <iostream>
+#include <iomanip>
 #include <vector>
-#include <chrono>
 #include <cstdint>
-#include <numeric> // For std::iota
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <memory>
 
-// 必须包含此头文件以使用 SVE 内联函数
-#include <arm_sve.h>
+#include "batch.h"
+#include "benchmark.h"
+#include "blas1.h"
+#include "cli.h"
+#include "dispatch_latency.h"
+#include "fusion.h"
+#include "mpi_scaling.h"
+#include "report.h"
+#include "roofline.h"
+#include "cpu_features.h"
+#include "saxpy.h"
+#include "thread_pool.h"
+#include "tiling.h"
+#include "timer.h"
+#include "topology.h"
+#include "trace.h"
+#include "tuner.h"
+#include "verify.h"
+
+// 所选内核涉及的后端及其向量宽度，例如 "sve (256-bit), neon (128-bit)"
+static std::string describe_backends(const std::vector<const SaxpyKernel*>& kernels) {
+    std::string out;
+    std::vector<std::string> seen;
+    for (const SaxpyKernel* kernel : kernels) {
+        if (std::find(seen.begin(), seen.end(), kernel->backend) != seen.end()) {
+            continue;
+        }
+        seen.push_back(kernel->backend);
+        const SaxpyBackend* backend = find_saxpy_backend(kernel->backend);
+        std::string bits = backend && backend->vector_bits ? std::to_string(backend->vector_bits) + "-bit" : "scalable";
+        out += (out.empty() ? "" : ", ") + std::string(kernel->backend) + " (" + bits + ")";
+    }
+    return out;
+}
+
+// 以 B / KiB / MiB / GiB 显示字节数
+static std::string format_bytes(double bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB"};
+    int unit = 0;
+    while (bytes >= 1024.0 && unit < 3) {
+        bytes /= 1024.0;
+        ++unit;
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1f %s", bytes, units[unit]);
+    return buf;
+}
 
 /**
- * @brief 使用 SVE 指令执行 SAXPY 操作 (Y = a * X + Y)
- * 
- * @param a 标量乘数
- * @param x 输入向量 X
- * @param y 输入/输出向量 Y
+ * @brief 工作集扫描：按 2 倍递增的工作集大小逐个测量，输出 规模-吞吐 表格
+ *
+ * 每个规模都重新分配并首次访问数据；inner_reps 按规模自动校准，
+ * 让小数组也能得到远大于分发开销的测量区间。
+ * 选择了多个内核时，每一行依次给出各内核的 GB/s，便于横向比较。
+ * traffic 列把普通存储的写分配读也计入，可以看出流式存储省下了多少实际带宽。
  */
-void sve_saxpy(float a, const std::vector<float>& x, std::vector<float>& y) {
-    // 确保向量大小相同
-    if (x.size() != y.size()) {
-        throw std::runtime_error("Vector sizes must be equal.");
-    }
-    
-    uint64_t n = x.size();
-    const float* x_ptr = x.data();
-    float* y_ptr = y.data();
-
-    // SVE 的循环方式：
-    // 使用一个谓词(predicate)来处理可能不是向量长度整数倍的数组尾部
-    for (uint64_t i = 0; i < n; ) {
-        // svwhilelt_b32: 创建一个谓词(pg)，对于 i+lane < n 的通道(lane)为 true
-        // 这有效地为循环的最后一次迭代创建了一个掩码
-        svbool_t pg = svwhilelt_b32(i, n);
-        
-        // svld1: 根据谓词 pg 从内存加载数据到向量寄存器
-        svfloat32_t vec_x = svld1_f32(pg, x_ptr + i);
-        svfloat32_t vec_y = svld1_f32(pg, y_ptr + i);
-        
-        // svmad_f32_z: 核心计算！执行 "multiply-add" 操作。
-        // result = (a * vec_x) + vec_y
-        // _z 后缀表示 "zeroing"，即谓词为 false 的通道将被置为 0
-        svfloat32_t result = svmad_f32_z(pg, svdup_n_f32(a), vec_x, vec_y);
-        
-        // svst1: 根据谓词 pg 将结果写回内存
-        svst1_f32(pg, y_ptr + i, result);
-        
-        // svcntw(): 获取当前硬件上 SVE 向量寄存器可以容纳的 32-bit 元素数量。
-        // 这是 "Scalable" 的关键！代码无需硬编码向量宽度。
-        i += svcntw();
-    }
-}
-
-int main() {
-    // ================== 1. 参数设置 ==================
-    const size_t VECTOR_SIZE = 10000000; // 1000 万个元素
-    const float a = 2.5f;
-    const int TARGET_DURATION_SECONDS = 120; // 目标运行时间：2分钟
+static void run_sweep(std::ostream& out, ThreadPool& pool, const SweepConfig& sweep,
+                      BenchConfig config, const std::vector<const SaxpyKernel*>& kernels,
+                      size_t batch, const AllocPolicy& alloc, bool verify, uint32_t tolerance_ulp,
+                      RunRecord& record) {
+    // 没有指定内核时每个规模单独按工作集和末级缓存选择，并在表中列出选中的内核
+    const bool auto_kernel = kernels.empty();
+    // 每批计算至少持续 1ms，计时误差可忽略，同时给每个规模留出足够多的样本
+    constexpr double MIN_BATCH_SECONDS = 1e-3;
+    const size_t bytes_per_elem = footprint_bytes_per_element(config.mode);
+
+    config.target_seconds = sweep.seconds_per_size;
+    config.progress = nullptr;
+
+    out << "Working-set sweep: " << format_bytes(sweep.min_bytes) << " .. "
+        << format_bytes(sweep.max_bytes) << ", " << sweep.seconds_per_size << " s per size, "
+        << page_mode_name(alloc.pages) << " pages" << std::endl;
+    out << std::endl;
+    if (auto_kernel || kernels.size() == 1) {
+        out << "   footprint      elements" << (auto_kernel ? "      kernel" : "")
+            << "       reps      calls     GFLOPS       GB/s    traffic" << std::endl;
+    } else {
+        out << "   footprint      elements";
+        for (const SaxpyKernel* kernel : kernels) {
+            out << std::setw(11) << kernel->name;
+        }
+        out << "   (GB/s)" << std::endl;
+    }
+
+    for (size_t bytes = sweep.min_bytes; bytes <= sweep.max_bytes; bytes *= 2) {
+        size_t elements = std::max<size_t>(bytes / bytes_per_elem, 1);
+        Workspace ws(pool, elements, alloc);
+
+        const size_t footprint = elements * bytes_per_elem;
+        const std::vector<const SaxpyKernel*> chosen =
+            auto_kernel ? std::vector<const SaxpyKernel*>{&auto_saxpy_kernel(footprint, record.llc_bytes)} : kernels;
+
+        out << std::setw(12) << format_bytes(static_cast<double>(footprint))
+            << std::setw(14) << elements << std::fixed << std::setprecision(3);
+        if (auto_kernel) {
+            out << std::setw(12) << chosen.front()->name;
+        }
+        for (const SaxpyKernel* kernel : chosen) {
+            config.kernel = kernel;
+            config.inner_reps = batch ? batch : calibrate_inner_reps(pool, ws, config, MIN_BATCH_SECONDS);
+            BenchResult result = run_benchmark(pool, ws, config);
+            ResultRecord rec = saxpy_result_record(*kernel);
+            rec.result = result;
+            rec.chunks = ws.chunks();
+            rec.memory = ws.memory();
+            record.results.push_back(std::move(rec));
+            if (verify) {
+                record.results.back().verified = true;
+                record.results.back().verify = verify_saxpy(pool, ws, config.a, tolerance_ulp);
+            }
+            if (chosen.size() == 1) {
+                out << std::setw(11) << result.inner_reps
+                    << std::setw(11) << static_cast<long long>(result.kernel_calls())
+                    << std::setw(11) << result.gflops();
+            }
+            out << std::setw(11) << result.bandwidth_gbs();
+            if (chosen.size() == 1) {
+                out << std::setw(11) << result.traffic_gbs();
+            }
+            out << std::flush;
+        }
+        out << std::defaultfloat << std::setprecision(6) << std::endl;
+
+        if (bytes > sweep.max_bytes / 2) {
+            break; // 避免 bytes *= 2 溢出
+        }
+    }
+}
+
+// 打印工作区的页面策略：请求的 / 实际的、对齐、mlock，以及实际落在大页上的比例
+static void print_memory(std::ostream& out, const MemoryInfo& memory) {
+    out << "Memory pages:    " << page_mode_name(memory.effective);
+    if (memory.effective != memory.requested) {
+        out << " (requested " << page_mode_name(memory.requested) << ")";
+    }
+    out << ", THP " << transparent_hugepage_setting() << ", align " << memory.alignment << " B"
+        << (memory.locked ? ", mlocked" : "") << std::endl;
+    out << "Huge pages:      " << format_bytes(static_cast<double>(memory.huge_page_bytes)) << " of "
+        << format_bytes(static_cast<double>(memory.bytes)) << std::endl;
+    if (!memory.note.empty()) {
+        out << "Warning: " << memory.note << std::endl;
+    }
+    if (memory.source == "file") {
+        // 启动开销（映射 + 调页）和计算阶段分开报告
+        out << "Input mapping:   " << memory.map_seconds * 1e3 << " ms, page faults " << memory.map_faults.minor
+            << " minor / " << memory.map_faults.major << " major" << std::endl;
+        out << "Init faults:     " << memory.init_faults.minor << " minor / " << memory.init_faults.major
+            << " major" << std::endl;
+    }
+}
+
+// 打印一次测量的汇总和每线程明细
+static void print_report(std::ostream& out, const BenchResult& result, const ThreadPool& pool,
+                         const std::vector<Range>& chunks) {
+    out << "---------------------" << std::endl;
+    out << "Total iterations: " << result.iterations << std::endl;
+    out << "Total time:       " << result.total_seconds << " seconds" << std::endl;
+    out << "Kernel time:      " << result.kernel_seconds << " seconds ("
+        << result.inner_reps << " call(s) per dispatch)" << std::endl;
+    out << "Dispatch time:    " << result.dispatch_seconds << " seconds (pool overhead "
+        << (result.dispatch_seconds - result.kernel_seconds) / result.iterations * 1e6 << " us/iter)" << std::endl;
+    out << "Performance:      " << result.gflops() << " GFLOPS" << std::endl;
+    out << "Bandwidth:        " << result.bandwidth_gbs() << " GB/s" << std::endl;
+    if (result.write_allocate_bytes_per_element > 0) {
+        out << "Traffic:          " << result.traffic_gbs() << " GB/s incl. write-allocate reads ("
+            << format_bytes(result.traffic_bytes()) << " vs " << format_bytes(result.bytes_moved())
+            << " moved)" << std::endl;
+    }
+    if (result.reset_bytes_per_element > 0) {
+        out << "Reset copy:       " << result.reset_seconds << " seconds (" << result.reset_bandwidth_gbs()
+            << " GB/s, " << result.reset_seconds / result.iterations * 1e6 << " us/iter)" << std::endl;
+    }
+    if (!result.counters_error.empty()) {
+        out << "Counters:         unavailable (" << result.counters_error << ")" << std::endl;
+    } else if (!result.counters.empty()) {
+        // 总数、每次调用、每个元素三个视角；n/a 表示该事件在本机不可用
+        out << "Counters (kernel phase only, all threads):" << std::endl;
+        const double calls = result.kernel_calls();
+        const double elems = calls * result.elements;
+        for (const CounterValue& c : result.counters) {
+            out << "  " << std::left << std::setw(18) << c.name << std::right;
+            if (c.available) {
+                out << std::setw(18) << std::fixed << std::setprecision(0) << c.value
+                    << std::setprecision(3) << std::setw(16) << c.value / calls << " /call"
+                    << std::setw(12) << c.value / elems << " /elem" << std::defaultfloat << std::setprecision(6);
+            } else {
+                out << std::setw(18) << "n/a";
+            }
+            out << std::endl;
+        }
+        if (result.ipc() > 0) {
+            out << "  IPC               " << result.ipc() << std::endl;
+        }
+    }
+    out << "Page faults:      " << result.page_faults.minor << " minor / " << result.page_faults.major
+        << " major during the timed loop" << std::endl;
+    const LatencySummary lat = result.latency();
+    out << "Latency (ns/call, " << lat.samples << " samples, " << result.warmup_iterations << " warmup):" << std::endl;
+    out << "  min " << lat.min_ns << "  median " << lat.median_ns << "  p90 " << lat.p90_ns
+        << "  p99 " << lat.p99_ns << "  p99.9 " << lat.p999_ns << "  max " << lat.max_ns << std::endl;
+
+    // 每个线程的吞吐量按其自身的忙碌时间计算；聚合值按每次分发从最早开始到最晚结束的跨度计算。
+    // idle 是跨度中该线程没有在计算的时间：晚启动和等最慢的线程，工作窃取时还包括找任务
+    if (pool.size() > 1) {
+        const bool steal = result.schedule == Schedule::Steal;
+        out << "\nPer-thread results (" << schedule_name(result.schedule) << " schedule):" << std::endl;
+        out << "  thread   cpu  node    elements     GFLOPS       GB/s    busy(s)    idle(s)   reset(s)"
+            << (steal ? "     tasks    stolen" : "") << std::endl;
+        for (size_t tid = 0; tid < pool.size(); ++tid) {
+            const ThreadStats& t = result.threads[tid];
+            const double per_call = result.thread_elements(tid, chunks[tid].size());
+            double elems = per_call * result.kernel_calls();
+            double busy = t.busy_seconds;
+            double t_gflops = busy > 0 ? result.flops_per_element * elems / busy / 1e9 : 0.0;
+            double t_bw = busy > 0 ? result.bytes_per_element * elems / busy / 1e9 : 0.0;
+            out << "  " << std::setw(6) << tid
+                << std::setw(6) << pool.slot(tid).cpu
+                << std::setw(6) << pool.slot(tid).node
+                << std::setw(12) << std::fixed << std::setprecision(0) << per_call
+                << std::setw(11) << std::setprecision(3) << t_gflops
+                << std::setw(11) << t_bw
+                << std::setw(11) << busy
+                << std::setw(11) << result.thread_idle_seconds(tid)
+                << std::setw(11) << t.reset_seconds
+                << std::defaultfloat << std::setprecision(6);
+            if (steal) {
+                out << std::setw(10) << t.tasks << std::setw(10) << t.stolen_tasks;
+            }
+            out << std::endl;
+        }
+    }
+}
+
+// 打印整向量验证的结果
+static void print_verification(std::ostream& out, const ResultRecord& rec) {
+    if (!rec.verified) {
+        out << "\nVerification:     skipped" << std::endl;
+        return;
+    }
+    const VerifyResult& v = rec.verify;
+    out << "\nVerification:     " << (v.passed() ? "PASS" : "FAIL") << " (" << v.checked << " elements, max "
+        << v.max_ulp << " ULP, tolerance " << v.tolerance_ulp << " ULP, " << v.seconds * 1e3 << " ms)" << std::endl;
+    if (!v.passed()) {
+        // 点积只有一个结果，没有元素下标
+        const bool scalar = rec.op.size() >= 3 && rec.op.compare(rec.op.size() - 3, 3, "dot") == 0;
+        out << "  " << v.mismatches << " mismatch(es); first "
+            << (scalar ? std::string("result") : "y[" + std::to_string(v.first_index) + "]") << ": Expected="
+            << std::setprecision(17) << v.first_expected << ", Got=" << v.first_got
+            << std::setprecision(6) << std::endl;
+    }
+}
+
+// 列出本机可用的内核
+static void print_kernel_list() {
+    std::cout << "Kernels available on this CPU (" << cpu_feature_string() << "):" << std::endl;
+    for (const SaxpyKernel& kernel : saxpy_kernels()) {
+        std::cout << "  " << std::left << std::setw(12) << kernel.name << std::setw(10) << kernel.backend
+                  << std::right << kernel.description << std::endl;
+    }
+    std::cout << "\nBLAS-1 suite (--op; 'saxpy' runs the kernels above, 'blas1' runs everything):" << std::endl;
+    for (const Blas1Kernel& kernel : blas1_kernels()) {
+        std::cout << "  " << std::left << std::setw(12) << kernel.name << std::setw(10) << kernel.backend
+                  << std::setw(10) << blas1_precision_name(kernel) << std::right << kernel.description << std::endl;
+    }
+    std::cout << "\nHardware counters (--counters; * = default):" << std::endl;
+    for (const PerfEventSpec& spec : perf_event_specs()) {
+        std::cout << "  " << (spec.in_default ? '*' : ' ') << ' ' << std::left << std::setw(18) << spec.name
+                  << std::right << spec.description << std::endl;
+    }
+}
+
+// 任何一个结果验证失败时进程以 2 退出（1 保留给参数和运行错误）
+static int verification_exit_code(const RunRecord& record) {
+    for (const ResultRecord& rec : record.results) {
+        if (rec.verified && !rec.verify.passed()) {
+            return 2;
+        }
+    }
+    return 0;
+}
+
+// 工作集扫描中只列出验证失败的结果
+static void report_verification_failures(std::ostream& out, const RunRecord& record) {
+    size_t verified = 0;
+    for (const ResultRecord& rec : record.results) {
+        if (!rec.verified) {
+            continue;
+        }
+        ++verified;
+        const VerifyResult& v = rec.verify;
+        if (v.mismatches > 0) {
+            out << "Verification FAIL: " << rec.kernel << " at " << rec.result.elements << " elements: "
+                << v.mismatches << " mismatch(es), max " << v.max_ulp << " ULP" << std::endl;
+        }
+        if (v.dot_mismatches > 0) {
+            out << "Verification FAIL: " << rec.kernel << " at " << rec.result.elements << " elements: "
+                << v.dot_mismatches << " dot mismatch(es); first dot #" << v.first_dot << ": Expected="
+                << std::setprecision(17) << v.dot_expected << ", Got=" << v.dot_got << std::setprecision(6)
+                << std::endl;
+        }
+    }
+    if (verified > 0 && verification_exit_code(record) == 0) {
+        out << "Verification: all " << verified << " result(s) passed" << std::endl;
+    }
+}
 
-    std::cout << "SVE SAXPY Benchmark" << std::endl;
-    std::cout << "---------------------" << std::endl;
-    std::cout << "Target duration: " << TARGET_DURATION_SECONDS << " seconds" << std::endl;
-    std::cout << "Vector size:     " << VECTOR_SIZE << " elements" << std::endl;
-    
-    // 打印当前 SVE 向量长度（以字节为单位）
-    std::cout << "SVE vector length: " << svcntb() * 8 << " bits (" << svcntb() << " bytes)" << std::endl;
-    std::cout << "---------------------" << std::endl;
+// 屋顶线对比：每个结果的算术强度、可达到的 GFLOPS 和占屋顶的百分比
+static void print_roofline(std::ostream& out, const RunRecord& record) {
+    const RooflinePeaks& peaks = record.roofline;
+    if (!peaks.measured) {
+        return;
+    }
+    out << "\n=== Roofline (peak " << peaks.peak_gflops << " GFLOPS, " << peaks.peak_bandwidth_gbs
+        << " GB/s, ridge " << peaks.ridge_intensity() << " flop/B) ===" << std::endl;
+    out << "  op          kernel      elements   flop/B     GFLOPS  attainable   % roof  bound" << std::endl;
+    for (const ResultRecord& rec : record.results) {
+        const RooflinePoint point = roofline_point(peaks, rec.result);
+        out << "  " << std::left << std::setw(12) << rec.op << std::setw(10) << rec.kernel << std::right
+            << std::setw(10) << rec.result.elements
+            << std::fixed << std::setprecision(3)
+            << std::setw(9) << point.intensity
+            << std::setw(11) << rec.result.gflops()
+            << std::setw(12) << point.attainable_gflops
+            << std::setprecision(1) << std::setw(9) << point.percent_of_roof
+            << "  " << point.bound()
+            << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+}
 
+// 把结构化记录输出到 stdout（--format json/csv）和/或 --output 指定的文件
+static void emit_record(const Options& opts, const RunRecord& record) {
+    if (opts.format == OutputFormat::Json) {
+        write_json(std::cout, record);
+    } else if (opts.format == OutputFormat::Csv) {
+        write_csv(std::cout, record);
+    }
+    if (!opts.output_path.empty()) {
+        write_record_file(opts.output_path, record);
+    }
+}
 
+// 所有 SAXPY 内核共用同一个工作区和同一套测量流程
+static void run_saxpy_kernels(std::ostream& out, ThreadPool& pool, const Options& opts, BenchConfig config,
+                              const std::vector<const SaxpyKernel*>& kernels, double min_batch,
+                              RunRecord& record) {
     // ================== 2. 数据初始化 ==================
-    std::cout << "Initializing vectors..." << std::endl;
-    std::vector<float> x(VECTOR_SIZE);
-    std::vector<float> y(VECTOR_SIZE);
-    std::vector<float> y_original(VECTOR_SIZE);
+    out << "Initializing vectors..." << std::endl;
+    std::unique_ptr<TraceScope> init_scope(new TraceScope("initialize", "setup"));
+    Workspace ws(pool, opts.elements, opts.alloc, opts.inputs);
+    init_scope.reset();
+    const MemoryInfo memory = ws.memory();
+    print_memory(out, memory);
+    out << "Initialization complete (" << memory.init_seconds * 1e3 << " ms on " << pool.size()
+        << " thread(s)). Starting computation." << std::endl;
+
+
+    // ================== 3. 主计算循环 / 4. 结果验证和报告 ==================
+    const size_t first = record.results.size();
+    for (const SaxpyKernel* kernel : kernels) {
+        TraceScope scope("measure kernel", "run", static_cast<long long>(record.results.size() - first));
+        if (kernels.size() > 1) {
+            out << "\n=== Kernel: " << kernel->name << " [" << kernel->backend << "] ("
+                << kernel->description << ") ===" << std::endl;
+        }
+        config.kernel = kernel;
+        config.inner_reps = opts.batch ? opts.batch : calibrate_inner_reps(pool, ws, config, min_batch);
+        ResultRecord rec = saxpy_result_record(*kernel);
+        rec.result = run_benchmark(pool, ws, config);
+        rec.chunks = ws.chunks();
+        rec.memory = memory;
+        out << std::endl << "Computation finished." << std::endl;
+
+        // 验证在计时结束之后进行，不影响任何测量结果
+        if (!opts.skip_verify) {
+            rec.verified = true;
+            rec.verify = verify_saxpy(pool, ws, config.a, opts.verify_ulp);
+        }
+        print_report(out, rec.result, pool, rec.chunks);
+        print_verification(out, rec);
+        record.results.push_back(std::move(rec));
+    }
+
+    // 多个内核时给出横向对比
+    if (kernels.size() > 1) {
+        const BenchResult& base = record.results[first].result;
+        out << "\n=== Kernel comparison ===" << std::endl;
+        out << "  kernel      backend       GFLOPS       GB/s    speedup" << std::endl;
+        for (size_t i = first; i < record.results.size(); ++i) {
+            const ResultRecord& rec = record.results[i];
+            out << "  " << std::left << std::setw(12) << rec.kernel
+                << std::setw(10) << rec.backend << std::right
+                << std::fixed << std::setprecision(3)
+                << std::setw(10) << rec.result.gflops()
+                << std::setw(11) << rec.result.bandwidth_gbs()
+                << std::setw(10) << rec.result.gflops() / base.gflops() << "x"
+                << std::defaultfloat << std::setprecision(6) << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief 分块 SAXPY：按 --tile / --prefetch 的配置运行可调预取内核；--tile auto 时从调优缓存读取配置，
+ *        缓存里没有（或 --retune）时先在同一个工作区上调优，再把结果写回缓存
+ *
+ * inner_reps 按不分块的调用校准；每次调用都完整扫描一遍数据，GB/s 与普通 SAXPY 可比。
+ */
+static void run_tiled_saxpy(std::ostream& out, ThreadPool& pool, const Options& opts, BenchConfig config,
+                            double min_batch, RunRecord& record) {
+    out << "Initializing vectors..." << std::endl;
+    Workspace ws(pool, opts.elements, opts.alloc, opts.inputs);
+    const MemoryInfo memory = ws.memory();
+    print_memory(out, memory);
+    out << "Initialization complete (" << memory.init_seconds * 1e3 << " ms on " << pool.size()
+        << " thread(s))." << std::endl;
 
-    // 用一些值填充向量
-    std::iota(x.begin(), x.end(), 0.0f); // x = {0.0, 1.0, 2.0, ...}
-    for(size_t i = 0; i < VECTOR_SIZE; ++i) {
-        y[i] = static_cast<float>(VECTOR_SIZE - i);
+    const PrefetchSaxpyKernel& kernel = prefetch_saxpy_kernels().front();
+    config.inner_reps = opts.batch ? opts.batch
+                                   : calibrate_workload_reps(pool, tiled_saxpy_workload(ws, config, TileConfig{}), min_batch);
+    TileConfig tile{opts.tile_bytes, opts.prefetch_bytes};
+    // --tuned 时分块配置来自主机调优缓存（见 resolve_tuned_options）
+    std::string source = opts.tuned ? "host-tuned" : "option";
+    if (opts.tile_auto) {
+        const std::string path = opts.tuning_file.empty() ? default_tuning_file() : opts.tuning_file;
+        TuningCache cache = TuningCache::load(path);
+        const std::string key = tiling_cache_key(config, ws.size(), pool.size());
+        if (!opts.retune && load_tile_config(cache, key, tile)) {
+            source = "cache";
+            out << "Tiling:          " << describe_tile(tile) << " (cached in " << path << ")" << std::endl;
+        } else {
+            out << "Tuning tile size and prefetch distance (" << opts.tune_seconds << " s per candidate, inner reps "
+                << config.inner_reps << ")..." << std::endl;
+            const TileTuning tuning = tune_tiling(pool, ws, config, opts.tune_seconds, &out);
+            tile = tuning.best;
+            source = "tuned";
+            store_tile_config(cache, key, tuning);
+            cache.save();
+            out << "Tiling:          " << describe_tile(tile) << " (" << std::fixed << std::setprecision(3)
+                << tuning.best_gbs << " GB/s vs " << tuning.baseline_gbs << " GB/s untiled; saved to " << path << ")"
+                << std::defaultfloat << std::setprecision(6) << std::endl;
+        }
+    } else {
+        out << "Tiling:          " << describe_tile(tile) << std::endl;
     }
-    y_original = y; // 保存 y 的初始状态，以便每次循环重置
+    out << "Starting computation." << std::endl;
 
-    std::cout << "Initialization complete. Starting computation." << std::endl;
+    ResultRecord rec = tiled_result_record(kernel, tile, source);
+    rec.result = run_tiled_benchmark(pool, ws, config, tile);
+    rec.chunks = ws.chunks();
+    rec.memory = memory;
+    out << std::endl << "Computation finished." << std::endl;
+    if (!opts.skip_verify) {
+        rec.verified = true;
+        rec.verify = verify_saxpy(pool, ws, config.a, opts.verify_ulp);
+    }
+    print_report(out, rec.result, pool, rec.chunks);
+    print_verification(out, rec);
+    record.results.push_back(std::move(rec));
+}
 
+/**
+ * @brief 依次运行 BLAS-1 套件内核，最后与 SAXPY 的结果放在一张表里对比
+ *
+ * 每个内核按自己的精度重新分配并首次访问工作区，测量流程与 SAXPY 完全相同。
+ * 表中的 flop/B（算术强度）区分计算受限和带宽受限：同一台机器上，
+ * 带宽受限的操作 GB/s 相近，GFLOPS 随算术强度变化。
+ */
+static void run_blas1_suite(std::ostream& out, ThreadPool& pool, const Options& opts, BenchConfig config,
+                            const std::vector<const Blas1Kernel*>& kernels, double min_batch,
+                            RunRecord& record) {
+    for (const Blas1Kernel* kernel : kernels) {
+        out << "\n=== BLAS-1: " << kernel->name << " [" << kernel->backend << ", "
+            << blas1_precision_name(*kernel) << "] (" << kernel->description << ") ===" << std::endl;
+        Blas1Workspace ws(pool, opts.elements, kernel->precision, blas1_y_precision(*kernel), opts.alloc);
+        config.inner_reps = opts.batch ? opts.batch : calibrate_blas1_reps(pool, ws, *kernel, config, min_batch);
+        ResultRecord rec = blas1_result_record(*kernel);
+        double dot = 0.0;
+        rec.result = run_blas1(pool, ws, *kernel, config, &dot);
+        rec.chunks = ws.chunks();
+        rec.memory = ws.memory();
+        out << std::endl << "Computation finished." << std::endl;
 
-    // ================== 3. 主计算循环 ==================
-    auto start_time = std::chrono::high_resolution_clock::now();
-    long long iterations = 0;
-    
-    while (true) {
-        // 每次迭代前重置 y，以确保计算负载恒定
-        y = y_original;
+        if (!opts.skip_verify) {
+            rec.verified = true;
+            rec.verify = verify_blas1(pool, ws, *kernel, config.a, dot, opts.verify_ulp);
+        }
+        print_report(out, rec.result, pool, rec.chunks);
+        if (kernel->op == Blas1Op::Dot) {
+            out << "Dot result:       " << std::setprecision(17) << dot << std::setprecision(6) << std::endl;
+        }
+        print_verification(out, rec);
+        record.results.push_back(std::move(rec));
+    }
 
-        // 执行核心计算
-        sve_saxpy(a, x, y);
+    out << "\n=== BLAS-1 comparison ===" << std::endl;
+    out << "  op          prec      backend       GFLOPS       GB/s     flop/B" << std::endl;
+    for (const ResultRecord& rec : record.results) {
+        const BenchResult& r = rec.result;
+        out << "  " << std::left << std::setw(12) << rec.op << std::setw(10) << rec.precision
+            << std::setw(10) << rec.backend << std::right
+            << std::fixed << std::setprecision(3)
+            << std::setw(10) << r.gflops()
+            << std::setw(11) << r.bandwidth_gbs()
+            << std::setw(11) << (r.bytes_per_element > 0 ? r.flops_per_element / r.bytes_per_element : 0.0)
+            << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+}
 
-        iterations++;
+/**
+ * @brief 批量 SAXPY：对每个批形状，依次测量每个批量内核在每种布局下的 calls/s
+ *
+ * calls/s 是每秒处理的向量个数，可以直接和上层逐个调用 saxpy 的吞吐比较；
+ * speedup 相对同一布局下的 percall 基线（逐个调用默认 SAXPY 内核）。
+ */
+static void run_batched(std::ostream& out, ThreadPool& pool, const Options& opts,
+                        const std::vector<BatchShape>& shapes, BenchConfig config, double min_batch,
+                        RunRecord& record) {
+    config.target_seconds = opts.batch_seconds;
+    config.progress = nullptr;
 
-        auto current_time = std::chrono::high_resolution_clock::now();
-        auto elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(current_time - start_time).count();
+    for (const BatchShape& shape : shapes) {
+        BatchWorkspace ws(pool, shape, config.a, opts.alloc);
+        out << "\n=== Batch " << shape.name() << " (" << ws.elements() << " elements, "
+            << format_bytes(static_cast<double>(ws.memory().bytes)) << ") ===" << std::endl;
+        out << "  kernel      layout        reps        calls/s    ns/call     GFLOPS       GB/s   speedup  verify" << std::endl;
 
-        // 每秒打印一次进度
-        if (iterations % 10 == 0) { // 减少打印频率
-            std::cout << "\rElapsed time: " << elapsed_seconds << "s, Iterations: " << iterations << std::flush;
+        std::vector<BatchLayout> layouts = {BatchLayout::Items};
+        if (shape.uniform()) {
+            layouts.push_back(BatchLayout::Strided);
+        }
+        for (BatchLayout layout : layouts) {
+            // percall 在表的最后；先测它，作为本布局的基准
+            std::vector<const SaxpyBatchKernel*> kernels = {&saxpy_batch_kernels().back()};
+            for (size_t k = 0; k + 1 < saxpy_batch_kernels().size(); ++k) {
+                kernels.push_back(&saxpy_batch_kernels()[k]);
+            }
+            double base_rate = 0.0;
+            for (const SaxpyBatchKernel* kernel : kernels) {
+                config.inner_reps = opts.batch ? opts.batch
+                                               : calibrate_batch_reps(pool, ws, *kernel, layout, config, min_batch);
+                ResultRecord rec = batch_result_record(*kernel, shape, layout);
+                rec.result = run_batch(pool, ws, *kernel, layout, config);
+                rec.chunks = ws.element_chunks();
+                rec.memory = ws.memory();
+                if (!opts.skip_verify) {
+                    rec.verified = true;
+                    rec.verify = verify_batch(pool, ws, opts.verify_ulp);
+                }
+                const double rate = vectors_per_second(rec);
+                base_rate = base_rate > 0 ? base_rate : rate;
+                out << "  " << std::left << std::setw(12) << kernel->name << std::setw(10)
+                    << batch_layout_name(layout) << std::right << std::fixed
+                    << std::setw(8) << rec.result.inner_reps
+                    << std::setprecision(0) << std::setw(15) << rate
+                    << std::setprecision(2) << std::setw(11) << (rate > 0 ? 1e9 / rate : 0.0)
+                    << std::setprecision(3) << std::setw(11) << rec.result.gflops()
+                    << std::setw(11) << rec.result.bandwidth_gbs()
+                    << std::setw(9) << (base_rate > 0 ? rate / base_rate : 0.0) << "x"
+                    << "  " << (!rec.verified ? "skip" : rec.verify.passed() ? "PASS" : "FAIL")
+                    << std::defaultfloat << std::setprecision(6) << std::endl;
+                record.results.push_back(std::move(rec));
+            }
         }
+    }
+}
+
+/**
+ * @brief 融合流水线：在工作集扫描的各个规模（或 --size 给出的单个规模）上比较 unfused / blocked / fused 三种执行方式
+ *
+ * eff GB/s 按逐个执行时的逻辑流量（每个阶段各扫一遍）计算，三种方式可以直接比较；
+ * GB/s 是各方式自己的实际流量。speedup 以 unfused 为基准。
+ */
+static void run_fused(std::ostream& out, ThreadPool& pool, const Options& opts, BenchConfig config,
+                      RunRecord& record) {
+    constexpr double MIN_BATCH_SECONDS = 1e-3;
+    const std::vector<FusedOp> ops = parse_fused_ops(opts.fused_ops);
+    const SweepConfig& sweep = opts.sweep;
+    config.target_seconds = sweep.seconds_per_size;
+    config.progress = nullptr;
 
-        if (elapsed_seconds >= TARGET_DURATION_SECONDS) {
-            break;
+    // 按流水线实际访问的数组个数换算规模，不含 Y_original
+    const double footprint_per_elem = fused_footprint_bytes_per_element(ops);
+    // 显式给出 --size 且没有 --sweep 时只测这一个规模
+    std::vector<size_t> sizes;
+    if (opts.size_set && !sweep.enabled) {
+        sizes.push_back(opts.elements);
+        out << "Pipeline:        " << fused_ops_name(ops) << ", " << opts.elements << " elements, "
+            << sweep.seconds_per_size << " s per mode" << std::endl;
+    } else {
+        for (size_t bytes = sweep.min_bytes; bytes <= sweep.max_bytes; bytes *= 2) {
+            sizes.push_back(std::max<size_t>(static_cast<size_t>(bytes / footprint_per_elem), 1));
+            if (bytes > sweep.max_bytes / 2) {
+                break; // 避免 bytes *= 2 溢出
+            }
         }
+        out << "Pipeline sweep:  " << fused_ops_name(ops) << ", " << format_bytes(sweep.min_bytes) << " .. "
+            << format_bytes(sweep.max_bytes) << ", " << sweep.seconds_per_size << " s per size and mode" << std::endl;
     }
-    
-    std::cout << std::endl << "Computation finished." << std::endl;
+    out << std::endl;
+    out << "   footprint      elements  mode          reps       ns/call     GFLOPS       GB/s   eff GB/s   speedup  verify"
+        << std::endl;
 
+    const FusionMode modes[] = {FusionMode::Unfused, FusionMode::Blocked, FusionMode::Fused};
+    for (size_t elements : sizes) {
+        FusionWorkspace ws(pool, elements, opts.alloc);
+        const double logical_bytes = ws.pipeline(ops, config.a).bytes_per_element(FusionMode::Unfused);
 
-    // ================== 4. 结果验证和报告 ==================
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto total_duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
-    
-    std::cout << "---------------------" << std::endl;
-    std::cout << "Total iterations: " << iterations << std::endl;
-    std::cout << "Total time:       " << total_duration / 1000000.0 << " seconds" << std::endl;
-    double gflops = (2.0 * VECTOR_SIZE * iterations) / (total_duration / 1000000.0) / 1e9;
-    std::cout << "Performance:      " << gflops << " GFLOPS" << std::endl;
-    
-    // 抽样验证结果是否正确
-    std::cout << "\nVerifying a few results..." << std::endl;
-    size_t indices_to_check[] = {0, 1, 42, VECTOR_SIZE / 2, VECTOR_SIZE - 1};
-    for(size_t idx : indices_to_check) {
-        float expected = a * x[idx] + y_original[idx];
-        std::cout << "y[" << idx << "]: Expected=" << expected << ", Got=" << y[idx] << std::endl;
+        double base_seconds = 0.0;
+        for (FusionMode mode : modes) {
+            config.inner_reps = opts.batch ? opts.batch
+                                           : calibrate_fusion_reps(pool, ws, ops, mode, config, MIN_BATCH_SECONDS);
+            ResultRecord rec = fusion_result_record(ops, mode);
+            std::vector<double> dots;
+            rec.result = run_fusion(pool, ws, ops, mode, config, &dots);
+            rec.chunks = ws.chunks();
+            rec.memory = ws.memory();
+            if (!opts.skip_verify) {
+                rec.verified = true;
+                rec.verify = verify_fusion(pool, ws, ops, config.a, dots, opts.verify_ulp);
+            }
+            const BenchResult& r = rec.result;
+            const double per_call = r.kernel_calls() > 0 ? r.kernel_seconds / r.kernel_calls() : 0.0;
+            base_seconds = base_seconds > 0 ? base_seconds : per_call;
+            out << std::setw(12) << format_bytes(static_cast<double>(r.footprint_bytes()))
+                << std::setw(14) << elements << "  " << std::left << std::setw(10) << fusion_mode_name(mode)
+                << std::right << std::fixed
+                << std::setw(8) << r.inner_reps
+                << std::setprecision(1) << std::setw(14) << per_call * 1e9
+                << std::setprecision(3) << std::setw(11) << r.gflops()
+                << std::setw(11) << r.bandwidth_gbs()
+                << std::setw(11) << (r.kernel_seconds > 0 ? logical_bytes * elements * r.kernel_calls() / r.kernel_seconds / 1e9 : 0.0)
+                << std::setw(9) << (per_call > 0 ? base_seconds / per_call : 0.0) << "x"
+                << "  " << (!rec.verified ? "skip" : rec.verify.passed() ? "PASS" : "FAIL")
+                << std::defaultfloat << std::setprecision(6) << std::endl;
+            record.results.push_back(std::move(rec));
+        }
     }
+}
 
-    return 0;
+/**
+ * @brief --tuned：按本机的调优缓存项改写 opts；没有缓存项（或 --retune）时先调优并写回缓存
+ *
+ * 只用于单个 SAXPY 运行；线程数、内核、页面类型和分块由调优结果决定，不能再单独指定。
+ */
+static void resolve_tuned_options(std::ostream& out, Options& opts) {
+    if (opts.sweep.enabled || !opts.batch_shapes.empty() || !opts.fused_ops.empty() || opts.ops != "saxpy" ||
+        opts.inputs.any()) {
+        throw std::runtime_error("--tuned only applies to a single synthetic SAXPY run (no --sweep, --batched, --fused, --op or input files).");
+    }
+    if ((!opts.kernels.empty() && opts.kernels != "auto") || opts.tile_auto || opts.tile_bytes || opts.prefetch_bytes) {
+        throw std::runtime_error("--tuned picks the kernel and tiling; drop --kernel / --tile / --prefetch.");
+    }
+    const std::string path = opts.tuning_file.empty() ? default_tuning_file() : opts.tuning_file;
+    TuningCache cache = TuningCache::load(path);
+    const std::string key = host_tuning_key(opts);
+    TunedConfig tuned;
+    if (!opts.retune && load_tuned_config(cache, key, tuned)) {
+        out << "Tuned config:    " << describe_tuned_config(tuned) << " (cached in " << path << ")" << std::endl;
+    } else {
+        out << "Tuning threads, kernel, pages and tiling for this host (" << opts.tune_seconds
+            << " s per candidate)..." << std::endl;
+        const HostTuning tuning = tune_host(opts, opts.tune_seconds, &out);
+        tuned = tuning.best;
+        store_tuned_config(cache, key, tuning);
+        cache.save();
+        out << "Tuned config:    " << describe_tuned_config(tuned) << " (" << std::fixed << std::setprecision(3)
+            << tuned.gbs << " GB/s vs " << tuning.baseline_gbs << " GB/s baseline; saved to " << path << ")"
+            << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+    apply_tuned_config(opts, tuned);
+}
+
+// 在 run() 的每条返回路径上导出 trace：析构时所有工作都已结束，导出失败只报告、不影响退出码
+class TraceExport {
+public:
+    TraceExport(std::ostream& out, std::string path) : out_(out), path_(std::move(path)) {}
+    ~TraceExport() {
+        if (path_.empty()) {
+            return;
+        }
+        try {
+            write_chrome_trace(path_);
+            const TraceStats stats = trace_stats();
+            out_ << "Trace: " << stats.events << " events from " << stats.threads << " thread(s) written to "
+                 << path_;
+            if (stats.dropped > 0) {
+                out_ << " (" << stats.dropped << " oldest dropped; raise --trace-events)";
+            }
+            out_ << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: " << e.what() << std::endl;
+        }
+    }
+
+    TraceExport(const TraceExport&) = delete;
+    TraceExport& operator=(const TraceExport&) = delete;
+
+private:
+    std::ostream& out_;
+    std::string path_;
+};
+
+/**
+ * @brief 分布式 SAXPY 的弱 / 强扩展：按 rank 数打印每一步和相对 1 个 rank 的效率
+ *
+ * 所有 rank 都调用；只有 rank 0 的 out 有输出。任何一步验证失败时返回 2（只在 rank 0 上）。
+ */
+static int run_mpi_scaling(std::ostream& out, ThreadPool& pool, const Options& opts, BenchConfig config,
+                           const SaxpyKernel& kernel, const MpiSession& mpi, RunRecord& record) {
+    config.kernel = &kernel;
+    MpiScalingConfig scaling;
+    scaling.elements = opts.elements;
+    scaling.weak = opts.mpi_scaling != "strong";
+    scaling.strong = opts.mpi_scaling != "weak";
+    scaling.dot = opts.mpi_dot;
+    scaling.seconds = opts.mpi_seconds;
+    scaling.verify_ulp = opts.verify_ulp;
+    scaling.verify = !opts.skip_verify;
+    scaling.alloc = opts.alloc;
+
+    out << "\n=== MPI scaling: " << kernel.name << " [" << kernel.backend << "], " << pool.size()
+        << " thread(s) per rank ===" << std::endl;
+    record.mpi = measure_mpi_scaling(mpi, pool, config, scaling, &out);
+
+    int status = 0;
+    out << "\n  mode     ranks   elements/rank    us/iter  saxpy us  allreduce us      GB/s    GFLOPS  efficiency"
+        << std::endl;
+    for (const MpiScalingPoint& p : record.mpi.points) {
+        out << "  " << std::left << std::setw(8) << p.mode << std::right << std::setw(6) << p.ranks
+            << std::setw(16) << p.max_rank_elements << std::fixed << std::setprecision(2) << std::setw(11)
+            << p.iteration_seconds * 1e6 << std::setw(10) << p.saxpy_seconds * 1e6 << std::setw(14)
+            << p.allreduce_seconds * 1e6 << std::setprecision(3) << std::setw(10) << p.bandwidth_gbs
+            << std::setw(10) << p.gflops << std::setprecision(1) << std::setw(11) << p.efficiency * 100 << "%"
+            << (p.verified ? "" : "  FAILED") << std::defaultfloat << std::setprecision(6) << std::endl;
+        if (!p.verified) {
+            status = 2;
+        }
+    }
+    return status;
+}
+
+static int run(int argc, char** argv) {
+    // ================== 1. 参数设置 ==================
+    Options opts = parse_options(argc, argv);
+    if (opts.help) {
+        print_usage(std::cout, argv[0]);
+        return 0;
+    }
+    if (opts.list_kernels) {
+        print_kernel_list();
+        return 0;
+    }
+
+    // MPI 模式下所有 rank 运行同一个程序，只有 rank 0 打印日志和输出记录；会话比线程池活得久
+    const bool MPI_SCALING = !opts.mpi_scaling.empty();
+    std::unique_ptr<MpiSession> mpi;
+    if (MPI_SCALING) {
+        mpi.reset(new MpiSession());
+    }
+    const bool LEAD_RANK = !mpi || mpi->rank() == 0;
+
+    // 结构化格式独占 stdout，人类可读的日志改写到 stderr；其余 rank 的日志丢弃
+    std::ostream null_out(nullptr);
+    std::ostream& out = !LEAD_RANK ? null_out : opts.format == OutputFormat::Text ? std::cout : std::cerr;
+
+    // 尽早开启，调优和线程池启动也在时间线上；线程池在 exporter 之后构造，先于它析构
+    if (!opts.trace_path.empty()) {
+        trace_set_thread_name("main");
+        trace_enable(opts.trace_events);
+        if (!LEAD_RANK) {
+            opts.trace_path += ".rank" + std::to_string(mpi->rank());
+        }
+    }
+    TraceExport trace_export(out, opts.trace_path);
+
+    // 调优缓存按单机写入，不能让多个 rank 同时调优并更新它
+    if (MPI_SCALING && opts.tuned) {
+        throw std::runtime_error("--mpi-scaling cannot be combined with --tuned.");
+    }
+    // 调优：在解析其余配置之前，用本机缓存（或现在调优得到）的最佳配置覆盖线程数、内核、页面和分块
+    if (opts.tuned) {
+        resolve_tuned_options(out, opts);
+    }
+
+    const size_t VECTOR_SIZE = opts.elements;
+    const float a = opts.a;
+    const MeasureMode MODE = opts.mode;
+    const SweepConfig& SWEEP = opts.sweep;
+    // MPI 模式下同一节点上的 rank 各用一段互不重叠的 CPU，默认线程数也按这一段计
+    const std::vector<CpuSlot> ALLOWED = mpi ? mpi_rank_cpus(*mpi, allowed_cpus()) : allowed_cpus();
+    const size_t THREADS = opts.threads == 0 ? std::max<size_t>(ALLOWED.size(), 1) : opts.threads;
+    // 自动模式：工作集超过这组 CPU 的末级缓存时改用流式存储内核
+    const std::vector<CpuSlot> CPUS = select_cpus(THREADS, ALLOWED);
+    const size_t LLC = opts.llc_bytes ? opts.llc_bytes : last_level_cache_bytes(CPUS);
+    const bool AUTO_KERNEL = opts.kernels.empty() || opts.kernels == "auto";
+    const std::vector<const SaxpyKernel*> KERNELS =
+        AUTO_KERNEL ? std::vector<const SaxpyKernel*>{&auto_saxpy_kernel(VECTOR_SIZE * footprint_bytes_per_element(MODE), LLC)}
+                    : parse_kernel_list(opts.kernels);
+    const bool RUN_SAXPY = op_list_includes_saxpy(opts.ops);
+    const std::vector<const Blas1Kernel*> SUITE = parse_blas1_list(opts.ops);
+    if (SWEEP.enabled && !SUITE.empty()) {
+        throw std::runtime_error("--sweep only supports --op saxpy.");
+    }
+    const bool BATCHED = !opts.batch_shapes.empty();
+    if (BATCHED && (SWEEP.enabled || !SUITE.empty())) {
+        throw std::runtime_error("--batched cannot be combined with --sweep or BLAS-1 operations.");
+    }
+    // 在打印表头之前解析，非法形状不会留下半行输出
+    const std::vector<BatchShape> SHAPES = BATCHED ? parse_batch_shapes(opts.batch_shapes) : std::vector<BatchShape>{};
+    if (opts.inputs.any() && (SWEEP.enabled || BATCHED || !SUITE.empty() || !RUN_SAXPY)) {
+        throw std::runtime_error("--x-file / --y-file only apply to a single SAXPY run (no --sweep, --batched or BLAS-1).");
+    }
+    // 融合流水线沿用 --sweep 的规模范围（只给 --size 时测单个规模，都未指定时为默认范围）
+    const bool FUSED = !opts.fused_ops.empty();
+    if (FUSED && (BATCHED || !SUITE.empty() || opts.inputs.any())) {
+        throw std::runtime_error("--fused cannot be combined with --batched, BLAS-1 operations or input files.");
+    }
+
+    // 分块 SAXPY 使用自己的可调预取内核，只用于单个 SAXPY 运行
+    const bool TILED = opts.tiled || opts.tile_auto || opts.tile_bytes > 0 || opts.prefetch_bytes > 0;
+    if (TILED && (SWEEP.enabled || BATCHED || FUSED || !SUITE.empty() || !RUN_SAXPY)) {
+        throw std::runtime_error("--tile / --prefetch only apply to a single SAXPY run (no --sweep, --batched, --fused or BLAS-1).");
+    }
+    if (TILED && !AUTO_KERNEL) {
+        throw std::runtime_error("--tile / --prefetch use the tiled_* kernels and cannot be combined with --kernel.");
+    }
+    if (opts.tile_auto && opts.prefetch_bytes > 0) {
+        throw std::runtime_error("--prefetch cannot be combined with --tile auto (the tuner picks the distance).");
+    }
+    // 工作窃取只接入了 SAXPY（含 --sweep）和批量 SAXPY；分块按线程自己的数据块进行
+    const bool STEAL = opts.schedule == Schedule::Steal;
+    if (STEAL && (FUSED || TILED || !SUITE.empty())) {
+        throw std::runtime_error("--schedule steal only applies to SAXPY and --batched (no --fused, --tile or BLAS-1).");
+    }
+
+    // 分布式模式只运行单个 SAXPY 内核；调优缓存按单机写入，不在多个 rank 上并发更新
+    if (MPI_SCALING && (SWEEP.enabled || BATCHED || FUSED || TILED || !SUITE.empty() || !RUN_SAXPY ||
+                        opts.inputs.any() || KERNELS.size() > 1)) {
+        throw std::runtime_error("--mpi-scaling runs a single SAXPY kernel (no --sweep, --batched, --fused, --tile, "
+                                 "BLAS-1 or input files).");
+    }
+
+    // 标题不假定 ISA，写出本次运行实际选用的后端
+    std::vector<std::string> backends;
+    auto add_backend = [&backends](const char* backend) {
+        if (std::find(backends.begin(), backends.end(), backend) == backends.end()) {
+            backends.push_back(backend);
+        }
+    };
+    if (TILED) {
+        add_backend(prefetch_saxpy_kernels().front().backend);
+    } else if (BATCHED) {
+        add_backend(saxpy_batch_kernels().front().backend);
+    } else if (FUSED) {
+        add_backend(axpy_dot_kernels().front().backend);
+    } else {
+        for (const SaxpyKernel* kernel : RUN_SAXPY ? KERNELS : std::vector<const SaxpyKernel*>{}) {
+            add_backend(kernel->backend);
+        }
+        for (const Blas1Kernel* kernel : SUITE) {
+            add_backend(kernel->backend);
+        }
+    }
+    const char* title = MPI_SCALING ? "Distributed SAXPY Benchmark"
+                        : BATCHED   ? "Batched SAXPY Benchmark"
+                        : FUSED     ? "Fused BLAS-1 Pipeline Benchmark"
+                        : !SUITE.empty() ? "BLAS-1 Benchmark"
+                                         : "SAXPY Benchmark";
+    out << title << " (";
+    for (size_t k = 0; k < backends.size(); ++k) {
+        out << (k ? ", " : "") << backends[k];
+    }
+    out << ")" << std::endl;
+    out << "---------------------" << std::endl;
+    if (BATCHED) {
+        out << "Batch shapes:    ";
+        for (size_t k = 0; k < SHAPES.size(); ++k) {
+            out << (k ? ", " : "") << SHAPES[k].name();
+        }
+        out << " (" << opts.batch_seconds << " s per kernel and layout)" << std::endl;
+    } else if (!SWEEP.enabled && !FUSED) {
+        // 分布式模式按 --mpi-seconds 计时（见下面的 MPI ranks 一行），不使用 --duration / --iterations
+        if (!MPI_SCALING) {
+            if (opts.iterations > 0) {
+                out << "Iterations:      " << opts.iterations << std::endl;
+            } else {
+                out << "Target duration: " << opts.duration_seconds << " seconds"
+                    << (KERNELS.size() > 1 ? " per kernel" : "") << std::endl;
+            }
+        }
+        out << "Vector size:     " << VECTOR_SIZE << " elements" << std::endl;
+        if (opts.inputs.any()) {
+            out << "Input files:     X " << (opts.inputs.x_path.empty() ? "synthetic" : opts.inputs.x_path)
+                << ", Y " << (opts.inputs.y_path.empty() ? "synthetic" : opts.inputs.y_path)
+                << (opts.inputs.populate ? " (MAP_POPULATE)" : "") << std::endl;
+        }
+    }
+    if (MPI_SCALING) {
+        // 分布式循环总是非原地写，每次迭代的结果相同，--mode 只影响单机测量
+        out << "Measure mode:    double-buffer (distributed)" << std::endl;
+        out << "MPI ranks:       " << mpi->size() << " on " << mpi->nodes() << " node(s), " << opts.mpi_scaling
+            << " scaling" << (opts.mpi_dot ? " + dot allreduce" : "") << " (" << opts.mpi_seconds
+            << " s per rank count; vector size is per rank for weak, total for strong)" << std::endl;
+        const std::vector<std::string> rank_cpus = mpi_gather_cpu_lists(*mpi, CPUS);
+        for (size_t r = 0; r < rank_cpus.size(); ++r) {
+            out << "  rank " << r << " CPUs:    " << rank_cpus[r] << std::endl;
+        }
+        if (static_cast<size_t>(mpi->local_size()) > allowed_cpus().size()) {
+            out << "Warning: " << mpi->local_size() << " ranks share " << allowed_cpus().size()
+                << " CPU(s) on this node; scaling results reflect oversubscription" << std::endl;
+        }
+    } else {
+        out << "Measure mode:    " << measure_mode_name(MODE) << std::endl;
+    }
+    if (STEAL) {
+        out << "Schedule:        steal (" << opts.steal_grain << " elements per task)" << std::endl;
+    }
+    if (!SUITE.empty()) {
+        out << "Operation(s):    " << (RUN_SAXPY ? "saxpy" : "");
+        for (size_t k = 0; k < SUITE.size(); ++k) {
+            out << (k || RUN_SAXPY ? ", " : "") << SUITE[k]->name;
+        }
+        out << std::endl;
+    }
+    if (BATCHED) {
+        out << "Batch kernels:   ";
+        for (size_t k = 0; k < saxpy_batch_kernels().size(); ++k) {
+            out << (k ? ", " : "") << saxpy_batch_kernels()[k].name;
+        }
+        out << std::endl;
+    } else if (FUSED) {
+        out << "Pipeline kernels: " << saxpy_kernels().front().name << " (axpy), " << axpy_dot_kernels().front().name
+            << " (axpy+dot)" << std::endl;
+    } else if (TILED) {
+        out << "Kernel(s):       " << prefetch_saxpy_kernels().front().name << " ["
+            << prefetch_saxpy_kernels().front().backend << "] (tiled)" << std::endl;
+    } else if (RUN_SAXPY) {
+        out << "Kernel(s):       ";
+        if (AUTO_KERNEL && SWEEP.enabled) {
+            out << "auto (per size)";
+        } else {
+            for (size_t k = 0; k < KERNELS.size(); ++k) {
+                out << (k ? ", " : "") << KERNELS[k]->name;
+            }
+            out << (AUTO_KERNEL ? " (auto)" : "");
+        }
+        out << std::endl;
+    }
+
+    // 打印检测到的 CPU 特性；只有支持 SVE 时才读取 SVE 向量长度（以字节为单位）
+    const CpuFeatures& cpu = cpu_features();
+    out << "CPU features:    " << cpu_feature_string() << std::endl;
+    const TimerInfo& timer = timer_info();
+    out << "Timer:           " << timer.source << " (" << timer.ticks_per_second / 1e6 << " MHz, overhead "
+        << timer.overhead_ns() << " ns)" << std::endl;
+    if (!timer.reliable) {
+        out << "Warning: TSC is not invariant; timings may drift with frequency changes" << std::endl;
+    }
+    if (cpu.sve) {
+        out << "SVE vector length: " << cpu.sve_vector_bytes * 8 << " bits (" << cpu.sve_vector_bytes << " bytes)" << std::endl;
+    }
+    if (RUN_SAXPY && !BATCHED && !TILED) {
+        out << "Backend(s):      " << describe_backends(KERNELS) << std::endl;
+    }
+
+    out << "LLC:             " << (LLC ? format_bytes(static_cast<double>(LLC)) : std::string("unknown"))
+        << (opts.llc_bytes ? " (--llc)" : "") << std::endl;
+
+    // 创建绑核线程池：线程按 NUMA 节点均匀分布，同节点线程编号连续
+    ThreadPool pool(CPUS);
+    out << "Threads:         " << pool.size() << " (NUMA nodes: " << numa_node_count() << ")" << std::endl;
+    if (pool.pin_failures() > 0) {
+        out << "Warning: failed to pin " << pool.pin_failures() << " thread(s)" << std::endl;
+    }
+    out << "---------------------" << std::endl;
+
+    RunRecord record;
+    record.options = opts;
+    record.numa_nodes = numa_node_count();
+    record.llc_bytes = LLC;
+    for (size_t tid = 0; tid < pool.size(); ++tid) {
+        record.cpus.push_back(pool.slot(tid));
+    }
+
+    BenchConfig config;
+    config.a = a;
+    config.mode = MODE;
+    config.target_seconds = opts.duration_seconds;
+    config.max_iterations = opts.iterations;
+    config.warmup_iterations = opts.warmup;
+    config.sample_windows = opts.sample_windows;
+    config.counters = parse_counter_list(opts.counters);
+    config.schedule = opts.schedule;
+    config.steal_grain = opts.steal_grain;
+
+    // 屋顶线：在同一组线程上先测两个峰值，再运行正常的测量
+    if (opts.roofline) {
+        out << "Measuring roofline peaks (" << opts.roofline_seconds << " s per micro-kernel)..." << std::endl;
+        record.roofline = measure_roofline(pool, config, LLC, opts.alloc, opts.roofline_seconds, &out);
+        out << "---------------------" << std::endl;
+    }
+
+    // 线程池往返耗时：在正式测量所用的同一个线程池上测，给出每次迭代固定开销的下限
+    if (opts.dispatch_latency) {
+        out << "Measuring pool dispatch + barrier latency (" << opts.dispatch_seconds << " s per variant; spin "
+            << pool.worker_spin_ns() / 1000 << " us worker / " << pool.main_spin_ns() / 1000 << " us main)..."
+            << std::endl;
+        record.dispatch = measure_dispatch_latency(pool, opts.dispatch_seconds, &out);
+        out << "---------------------" << std::endl;
+    }
+
+    if (FUSED) {
+        run_fused(out, pool, opts, config, record);
+        report_verification_failures(out, record);
+        print_roofline(out, record);
+        emit_record(opts, record);
+        return verification_exit_code(record);
+    }
+
+    if (SWEEP.enabled) {
+        run_sweep(out, pool, SWEEP, config, AUTO_KERNEL ? std::vector<const SaxpyKernel*>{} : KERNELS, opts.batch, opts.alloc, !opts.skip_verify,
+                  opts.verify_ulp, record);
+        report_verification_failures(out, record);
+        print_roofline(out, record);
+        emit_record(opts, record);
+        return verification_exit_code(record);
+    }
+
+
+    if (MPI_SCALING) {
+        const int status = run_mpi_scaling(out, pool, opts, config, *KERNELS.front(), *mpi, record);
+        if (LEAD_RANK) {
+            emit_record(opts, record);
+        }
+        return status;
+    }
+
+    // 小数组上单次调用只有几十纳秒：自动把多次调用合成一批再计时，
+    // 让每批至少是计时开销的 1000 倍（且不少于 10us）；大数组保持每次分发一次调用
+    const double min_batch = std::max(10e-6, 1000 * timer.overhead_ns() * 1e-9);
+    if (BATCHED) {
+        run_batched(out, pool, opts, SHAPES, config, min_batch, record);
+        report_verification_failures(out, record);
+        print_roofline(out, record);
+        emit_record(opts, record);
+        return verification_exit_code(record);
+    }
+    config.progress = &out;
+    if (TILED) {
+        run_tiled_saxpy(out, pool, opts, config, min_batch, record);
+    } else if (RUN_SAXPY) {
+        run_saxpy_kernels(out, pool, opts, config, KERNELS, min_batch, record);
+    }
+    if (!SUITE.empty()) {
+        run_blas1_suite(out, pool, opts, config, SUITE, min_batch, record);
+    }
+
+    print_roofline(out, record);
+    emit_record(opts, record);
+    return verification_exit_code(record);
+}
+
+int main(int argc, char** argv) {
+    // 配置错误等异常统一在这里报告，避免 std::terminate 直接中止进程
+    try {
+        return run(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        mpi_abort(1);
+        return 1;
+    }
 }
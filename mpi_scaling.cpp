@@ -0,0 +1,326 @@
+#include "mpi_scaling.h"
+
+#include <algorithm>
+#include <exception>
+#include <ostream>
+#include <stdexcept>
+
+#include "blas1.h"
+#include "timer.h"
+#include "trace.h"
+#include "verify.h"
+
+// 本文件只在 perf_test_mpi 中以 -DPERF_TEST_MPI 用 mpicxx 编译（见 makefile 的 mpi 目标）
+#if defined(PERF_TEST_MPI)
+
+#include <mpi.h>
+
+#include <set>
+#include <string>
+
+namespace {
+
+// 每个 rank 数依次测量的值：1, 2, 4, ...，最后补上总数
+std::vector<int> rank_counts(int size) {
+    std::vector<int> counts;
+    for (int p = 1; p < size; p *= 2) {
+        counts.push_back(p);
+    }
+    counts.push_back(size);
+    return counts;
+}
+
+double max_over(MPI_Comm comm, double value) {
+    double result = value;
+    MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_MAX, comm);
+    return result;
+}
+
+double min_over(MPI_Comm comm, double value) {
+    double result = value;
+    MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_MIN, comm);
+    return result;
+}
+
+double sum_over(MPI_Comm comm, double value) {
+    double result = value;
+    MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_SUM, comm);
+    return result;
+}
+
+const Blas1Kernel& sdot_kernel() {
+    for (const Blas1Kernel& kernel : blas1_kernels()) {
+        if (kernel.op == Blas1Op::Dot && kernel.precision == Precision::F32 && !kernel.fp32_y) {
+            return kernel;
+        }
+    }
+    throw std::runtime_error("No fp32 dot kernel available for --mpi-dot.");
+}
+
+/**
+ * @brief 前 ranks 个 rank 上的一次测量；comm 为这些 rank 组成的子通信域
+ */
+MpiScalingPoint measure_point(MPI_Comm comm, int ranks, int rank, const std::string& mode, ThreadPool& pool,
+                              const BenchConfig& base, const MpiScalingConfig& scaling) {
+    const bool weak = mode == "weak";
+    // 强扩展按缓存行对齐均分总规模，和线程间的划分一样避免分片边界落在同一行上
+    const size_t local = weak ? scaling.elements
+                              : static_partition(scaling.elements, ranks, 64 / sizeof(float))[rank].size();
+
+    Workspace ws(pool, local, scaling.alloc);
+    BenchConfig config = base;
+    config.mode = MeasureMode::DoubleBuffer;
+    const Workload work = saxpy_workload(ws, config);
+    const TimerInfo& timer = timer_info();
+
+    const Blas1Fn dot_fn = scaling.dot ? sdot_kernel().fn : nullptr;
+    std::vector<double> partial(pool.size(), 0.0);
+    uint64_t saxpy_ticks = 0;
+    uint64_t allreduce_ticks = 0;
+    double dot = 0.0;
+    auto iteration = [&]() {
+        const uint64_t t0 = read_ticks();
+        run_workload_body(pool, work, 1);
+        const uint64_t t1 = read_ticks();
+        saxpy_ticks += t1 - t0;
+        if (!dot_fn) {
+            return;
+        }
+        pool.run([&](size_t tid) {
+            const Range& r = ws.chunks()[tid];
+            partial[tid] = dot_fn(0.0, ws.x() + r.begin, ws.y() + r.begin, nullptr, r.size());
+        });
+        double local_dot = 0.0;
+        for (double p : partial) {
+            local_dot += p;
+        }
+        const uint64_t t2 = read_ticks();
+        MPI_Allreduce(&local_dot, &dot, 1, MPI_DOUBLE, MPI_SUM, comm);
+        allreduce_ticks += read_ticks() - t2;
+    };
+
+    // 预热同时估计每次迭代的耗时；所有 rank 取最慢的估计，保证迭代次数一致（allreduce 必须配对）
+    const long long warmup = std::max<long long>(config.warmup_iterations, 1);
+    MPI_Barrier(comm);
+    const uint64_t w0 = read_ticks();
+    for (long long i = 0; i < warmup; ++i) {
+        iteration();
+    }
+    const double per_iteration = max_over(comm, timer.seconds(read_ticks() - w0) / warmup);
+    const long long iterations =
+        config.max_iterations > 0
+            ? config.max_iterations
+            : std::max<long long>(3, static_cast<long long>(scaling.seconds / std::max(per_iteration, 1e-9)));
+
+    saxpy_ticks = 0;
+    allreduce_ticks = 0;
+    MPI_Barrier(comm);
+    const uint64_t start = read_ticks();
+    {
+        TraceScope scope("mpi step", "run", ranks);
+        for (long long i = 0; i < iterations; ++i) {
+            iteration();
+        }
+    }
+    const double elapsed = timer.seconds(read_ticks() - start);
+
+    MpiScalingPoint point;
+    point.mode = mode;
+    point.ranks = ranks;
+    point.elements = static_cast<size_t>(sum_over(comm, static_cast<double>(local)));
+    point.max_rank_elements = static_cast<size_t>(max_over(comm, static_cast<double>(local)));
+    point.iterations = iterations;
+    point.iteration_seconds = max_over(comm, elapsed) / iterations;
+    point.saxpy_seconds = max_over(comm, timer.seconds(saxpy_ticks)) / iterations;
+    point.min_saxpy_seconds = min_over(comm, timer.seconds(saxpy_ticks)) / iterations;
+    point.allreduce_seconds = max_over(comm, timer.seconds(allreduce_ticks)) / iterations;
+    point.dot = dot;
+
+    // 点积额外读一遍 X 和 Y
+    const double bytes_per_element = work.bytes_per_element + (dot_fn ? 2 * sizeof(float) : 0);
+    const double flops_per_element = work.flops_per_element + (dot_fn ? 2.0 : 0.0);
+    point.bandwidth_gbs = bytes_per_element * point.elements / point.iteration_seconds / 1e9;
+    point.gflops = flops_per_element * point.elements / point.iteration_seconds / 1e9;
+
+    if (scaling.verify) {
+        const VerifyResult v = verify_saxpy(pool, ws, config.a, scaling.verify_ulp);
+        point.verified = min_over(comm, v.passed() ? 1.0 : 0.0) > 0.0;
+    }
+    return point;
+}
+
+} // namespace
+
+MpiSession::MpiSession() {
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (!initialized) {
+        MPI_Init(nullptr, nullptr);
+    }
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+    MPI_Comm_size(MPI_COMM_WORLD, &size_);
+
+    // 按处理器名统计节点数：每个 rank 的名字收集到所有 rank
+    char name[MPI_MAX_PROCESSOR_NAME] = {};
+    int length = 0;
+    MPI_Get_processor_name(name, &length);
+    std::vector<char> all(static_cast<size_t>(size_) * MPI_MAX_PROCESSOR_NAME);
+    MPI_Allgather(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, all.data(), MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                  MPI_COMM_WORLD);
+    std::set<std::string> hosts;
+    for (int r = 0; r < size_; ++r) {
+        hosts.insert(std::string(all.data() + static_cast<size_t>(r) * MPI_MAX_PROCESSOR_NAME));
+    }
+    nodes_ = hosts.size();
+
+    MPI_Comm node = MPI_COMM_NULL;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank_, MPI_INFO_NULL, &node);
+    MPI_Comm_rank(node, &local_rank_);
+    MPI_Comm_size(node, &local_size_);
+    MPI_Comm_free(&node);
+}
+
+MpiSession::~MpiSession() {
+    if (std::uncaught_exceptions() == 0) {
+        MPI_Finalize();
+    }
+}
+
+bool mpi_available() {
+    return true;
+}
+
+std::vector<CpuSlot> mpi_rank_cpus(const MpiSession& mpi, const std::vector<CpuSlot>& allowed) {
+    MPI_Comm node = MPI_COMM_NULL;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, mpi.rank(), MPI_INFO_NULL, &node);
+    // 和节点内 0 号 rank 的 CPU 列表比较，所有 rank 都相同时才需要切分
+    std::string mine = format_cpu_list(allowed);
+    std::string first = mine;
+    int length = static_cast<int>(first.size());
+    MPI_Bcast(&length, 1, MPI_INT, 0, node);
+    first.resize(static_cast<size_t>(length));
+    MPI_Bcast(&first[0], length, MPI_CHAR, 0, node);
+    int same = first == mine ? 1 : 0;
+    int all_same = same;
+    MPI_Allreduce(&same, &all_same, 1, MPI_INT, MPI_LAND, node);
+    MPI_Comm_free(&node);
+    if (!all_same) {
+        return allowed;
+    }
+    return partition_cpus(allowed, static_cast<size_t>(mpi.local_size()), static_cast<size_t>(mpi.local_rank()));
+}
+
+std::vector<std::string> mpi_gather_cpu_lists(const MpiSession& mpi, const std::vector<CpuSlot>& cpus) {
+    const std::string mine = format_cpu_list(cpus);
+    int length = static_cast<int>(mine.size());
+    std::vector<int> lengths(static_cast<size_t>(mpi.size()));
+    MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    std::vector<int> offsets(lengths.size(), 0);
+    for (size_t r = 1; r < lengths.size(); ++r) {
+        offsets[r] = offsets[r - 1] + lengths[r - 1];
+    }
+    std::vector<char> all(mpi.rank() == 0 ? static_cast<size_t>(offsets.back() + lengths.back()) + 1 : 1);
+    MPI_Gatherv(mine.data(), length, MPI_CHAR, all.data(), lengths.data(), offsets.data(), MPI_CHAR, 0,
+                MPI_COMM_WORLD);
+    std::vector<std::string> lists;
+    if (mpi.rank() == 0) {
+        for (size_t r = 0; r < lengths.size(); ++r) {
+            lists.emplace_back(all.data() + offsets[r], static_cast<size_t>(lengths[r]));
+        }
+    }
+    return lists;
+}
+
+void mpi_abort(int code) {
+    int initialized = 0, finalized = 0;
+    MPI_Initialized(&initialized);
+    MPI_Finalized(&finalized);
+    if (initialized && !finalized) {
+        MPI_Abort(MPI_COMM_WORLD, code);
+    }
+}
+
+MpiScaling measure_mpi_scaling(const MpiSession& mpi, ThreadPool& pool, const BenchConfig& config,
+                               const MpiScalingConfig& scaling, std::ostream* progress) {
+    if (scaling.strong && scaling.elements < static_cast<size_t>(mpi.size()) * 64 / sizeof(float)) {
+        throw std::runtime_error("--mpi-scaling strong needs at least one cache line of elements per rank.");
+    }
+    std::ostream* out = mpi.rank() == 0 ? progress : nullptr;
+
+    MpiScaling result;
+    result.measured = true;
+    result.ranks = mpi.size();
+    result.nodes = mpi.nodes();
+    result.threads_per_rank = pool.size();
+    result.kernel = config.kernel->name;
+    result.dot = scaling.dot;
+
+    std::vector<std::string> modes;
+    if (scaling.weak) {
+        modes.push_back("weak");
+    }
+    if (scaling.strong) {
+        modes.push_back("strong");
+    }
+    for (const std::string& mode : modes) {
+        double baseline = 0.0;
+        for (int ranks : rank_counts(mpi.size())) {
+            const bool active = mpi.rank() < ranks;
+            MPI_Comm comm = MPI_COMM_NULL;
+            MPI_Comm_split(MPI_COMM_WORLD, active ? 0 : MPI_UNDEFINED, mpi.rank(), &comm);
+            MpiScalingPoint point;
+            if (active) {
+                point = measure_point(comm, ranks, mpi.rank(), mode, pool, config, scaling);
+                MPI_Comm_free(&comm);
+            }
+            // 其余 rank 在这里等待，下一步开始前所有 rank 重新对齐
+            MPI_Barrier(MPI_COMM_WORLD);
+            if (mpi.rank() != 0) {
+                continue;
+            }
+            if (ranks == 1) {
+                baseline = point.iteration_seconds;
+            }
+            // 强扩展总工作量不变；弱扩展每个 rank 的工作量不变
+            point.efficiency = mode == "weak" ? baseline / point.iteration_seconds
+                                              : baseline / (ranks * point.iteration_seconds);
+            if (out) {
+                *out << "  " << mode << " x" << ranks << ": " << point.bandwidth_gbs << " GB/s, "
+                     << point.iteration_seconds * 1e6 << " us/iter, efficiency " << point.efficiency * 100
+                     << "%" << (point.verified ? "" : " (verification FAILED)") << std::endl;
+            }
+            result.points.push_back(point);
+        }
+    }
+    return result;
+}
+
+#else
+
+MpiSession::MpiSession() {
+    throw std::runtime_error("This binary was built without MPI; build perf_test_mpi with 'make mpi' "
+                             "and launch it with mpirun.");
+}
+
+MpiSession::~MpiSession() {}
+
+bool mpi_available() {
+    return false;
+}
+
+std::vector<CpuSlot> mpi_rank_cpus(const MpiSession&, const std::vector<CpuSlot>& allowed) {
+    return allowed;
+}
+
+std::vector<std::string> mpi_gather_cpu_lists(const MpiSession&, const std::vector<CpuSlot>& cpus) {
+    return {format_cpu_list(cpus)};
+}
+
+void mpi_abort(int) {}
+
+MpiScaling measure_mpi_scaling(const MpiSession&, ThreadPool&, const BenchConfig&, const MpiScalingConfig&,
+                               std::ostream*) {
+    throw std::runtime_error("This binary was built without MPI.");
+}
+
+#endif // PERF_TEST_MPI
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "allocator.h"
+#include "benchmark.h"
+#include "thread_pool.h"
+#include "topology.h"
+
+/**
+ * @brief 进程内的 MPI 环境：构造时 MPI_Init，析构时 MPI_Finalize
+ *
+ * 只有 `make mpi` 生成的 perf_test_mpi 链接了 MPI；普通构建中构造函数抛出 std::runtime_error。
+ * 因异常退出作用域时不调用 MPI_Finalize（它是集合操作，其余 rank 可能还在别处），
+ * 由报告完错误的一方调用 mpi_abort()。
+ */
+class MpiSession {
+public:
+    MpiSession();
+    ~MpiSession();
+
+    MpiSession(const MpiSession&) = delete;
+    MpiSession& operator=(const MpiSession&) = delete;
+
+    int rank() const { return rank_; }
+    int size() const { return size_; }
+    size_t nodes() const { return nodes_; }     // 不同的 MPI_Get_processor_name 个数
+    // 本节点（MPI_COMM_TYPE_SHARED）上的 rank 序号和 rank 数
+    int local_rank() const { return local_rank_; }
+    int local_size() const { return local_size_; }
+
+private:
+    int rank_ = 0;
+    int size_ = 1;
+    size_t nodes_ = 1;
+    int local_rank_ = 0;
+    int local_size_ = 1;
+};
+
+// 本二进制是否带 MPI（perf_test_mpi）
+bool mpi_available();
+
+/**
+ * @brief 本 rank 的线程池可以使用的 CPU
+ *
+ * 同一节点上的各 rank 允许的 CPU 完全相同时（启动器没有绑核），按节点内的 rank 序号
+ * 切成互不重叠的连续段（见 partition_cpus），否则各 rank 的满线程池会绑到同一批核上，
+ * 等待中的 rank 在 MPI_Barrier 里忙等也会占着这些核；启动器已经分别绑核时原样返回 allowed。
+ * 所有 rank 都必须调用。
+ */
+std::vector<CpuSlot> mpi_rank_cpus(const MpiSession& mpi, const std::vector<CpuSlot>& allowed);
+
+// 每个 rank 的 CPU 列表（format_cpu_list 格式，按 rank 排列），只在 rank 0 上返回；所有 rank 都必须调用
+std::vector<std::string> mpi_gather_cpu_lists(const MpiSession& mpi, const std::vector<CpuSlot>& cpus);
+
+// MPI 已初始化且尚未结束时 MPI_Abort，终止所有 rank，避免其余 rank 卡在下一个集合通信上；否则什么都不做
+void mpi_abort(int code);
+
+/**
+ * @brief 一个 rank 数上的测量结果；时间取最慢的 rank
+ *
+ * 弱扩展时每个 rank 的规模不变，效率 = T(1) / T(p)；
+ * 强扩展时总规模不变、均分给各 rank，效率 = T(1) / (p * T(p))。T 为每次迭代的墙钟时间。
+ */
+struct MpiScalingPoint {
+    std::string mode;                   // weak / strong
+    int ranks = 0;
+    size_t elements = 0;                // 所有 rank 的总元素数
+    size_t max_rank_elements = 0;       // 最大分片
+    long long iterations = 0;
+    double iteration_seconds = 0.0;     // 最慢 rank 的每次迭代墙钟时间，含 allreduce
+    double saxpy_seconds = 0.0;         // 最慢 rank 的每次迭代 SAXPY 时间
+    double min_saxpy_seconds = 0.0;     // 最快 rank 的，与上者之比反映 rank 间的不均衡
+    double allreduce_seconds = 0.0;     // 最慢 rank 的每次迭代 allreduce 时间（含等待其他 rank）
+    double bandwidth_gbs = 0.0;         // 所有 rank 合计
+    double gflops = 0.0;
+    double efficiency = 0.0;            // 相对同一模式下 1 个 rank 的结果
+    double dot = 0.0;                   // 最后一次 allreduce 的点积
+    bool verified = true;               // 所有 rank 的 SAXPY 输出都通过验证
+};
+
+struct MpiScaling {
+    bool measured = false;
+    int ranks = 0;
+    size_t nodes = 0;
+    size_t threads_per_rank = 0;
+    std::string kernel;
+    bool dot = false;
+    std::vector<MpiScalingPoint> points;
+};
+
+struct MpiScalingConfig {
+    size_t elements = 0;                // 弱扩展时为每个 rank 的规模，强扩展时为总规模
+    bool weak = true;
+    bool strong = true;
+    bool dot = false;                   // 每次 SAXPY 之后做本地点积并 MPI_Allreduce
+    double seconds = 1.0;               // 每个 rank 数的测量时间
+    uint32_t verify_ulp = 2;
+    bool verify = true;
+    AllocPolicy alloc;
+};
+
+/**
+ * @brief 分布式 SAXPY 的弱 / 强扩展测量
+ *
+ * rank 数依次取 1, 2, 4, ... 直到总数（不是 2 的幂时最后再测一次总数），
+ * 每一步前 p 个 rank 组成子通信域，各自在本地线程池上对自己的分片运行同一个内核，其余 rank 等待。
+ * 为了让每次迭代的结果都相同，分布式循环总是非原地写（double-buffer）。
+ * 所有 rank 都必须调用；完整的结果只在 rank 0 上返回，progress 也只在 rank 0 上打印。
+ */
+MpiScaling measure_mpi_scaling(const MpiSession& mpi, ThreadPool& pool, const BenchConfig& config,
+                               const MpiScalingConfig& scaling, std::ostream* progress = nullptr);
@@ -0,0 +1,196 @@
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t hw_cache(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+int perf_event_open(perf_event_attr* attr, int group_fd) {
+    return static_cast<int>(syscall(__NR_perf_event_open, attr, 0, -1, group_fd, 0));
+}
+
+std::string open_error(int err) {
+    std::string msg = std::string("perf_event_open failed: ") + std::strerror(err);
+    if (err == EACCES || err == EPERM) {
+        msg += " (check /proc/sys/kernel/perf_event_paranoid)";
+    }
+    return msg;
+}
+
+} // namespace
+
+const std::vector<PerfEventSpec>& perf_event_specs() {
+    static const std::vector<PerfEventSpec> specs = {
+        {"cycles",        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,              "CPU cycles", true},
+        {"instructions",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,            "retired instructions", true},
+        {"l1d_loads",     PERF_TYPE_HW_CACHE,
+         hw_cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_ACCESS),
+         "L1D read accesses", false},
+        {"l1d_misses",    PERF_TYPE_HW_CACHE,
+         hw_cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS),
+         "L1D read misses", true},
+        {"llc_loads",     PERF_TYPE_HW_CACHE,
+         hw_cache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_ACCESS),
+         "last-level cache read accesses", false},
+        {"llc_misses",    PERF_TYPE_HW_CACHE,
+         hw_cache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS),
+         "last-level cache read misses", true},
+        // arm64 PMU 驱动把通用的 stalled-cycles-backend 映射到 STALL_BACKEND (0x24)
+        {"stall_backend", PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND,  "cycles stalled in the backend", true},
+        {"branches",      PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS,     "retired branches", false},
+        {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,           "mispredicted branches", true},
+#if defined(__aarch64__)
+        // Armv8.2 PMU 公共事件 SVE_INST_RETIRED
+        {"sve_inst_retired", PERF_TYPE_RAW,   0x8002,                                "retired SVE instructions", true},
+#endif
+    };
+    return specs;
+}
+
+std::vector<const PerfEventSpec*> parse_counter_list(const std::string& list) {
+    std::vector<const PerfEventSpec*> events;
+    if (list.empty() || list == "0" || list == "off") {
+        return events;
+    }
+    if (list == "default" || list == "all" || list == "1") {
+        for (const PerfEventSpec& spec : perf_event_specs()) {
+            if (list == "all" || spec.in_default) {
+                events.push_back(&spec);
+            }
+        }
+        return events;
+    }
+
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string name = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        const PerfEventSpec* found = nullptr;
+        for (const PerfEventSpec& spec : perf_event_specs()) {
+            if (name == spec.name) {
+                found = &spec;
+            }
+        }
+        if (!found) {
+            throw std::runtime_error("Unknown counter '" + name + "'");
+        }
+        events.push_back(found);
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    return events;
+}
+
+PerfCounterGroup::PerfCounterGroup(const std::vector<const PerfEventSpec*>& events)
+    : events_(events), fds_(events.size(), -1) {
+    int first_error = 0;
+    for (size_t i = 0; i < events_.size(); ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events_[i]->type;
+        attr.config = events_[i]->config;
+        attr.disabled = leader_ < 0 ? 1 : 0; // 组员跟随组长
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int fd = perf_event_open(&attr, leader_);
+        if (fd < 0) {
+            if (!first_error) {
+                first_error = errno;
+            }
+            continue;
+        }
+        fds_[i] = fd;
+        if (leader_ < 0) {
+            leader_ = fd;
+        }
+    }
+    if (leader_ < 0 && !events_.empty()) {
+        error_ = open_error(first_error);
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void PerfCounterGroup::enable() {
+    if (leader_ >= 0) {
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void PerfCounterGroup::disable() {
+    if (leader_ >= 0) {
+        ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void PerfCounterGroup::reset() {
+    if (leader_ >= 0) {
+        ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+std::vector<CounterValue> PerfCounterGroup::read() const {
+    std::vector<CounterValue> values(events_.size());
+    for (size_t i = 0; i < events_.size(); ++i) {
+        values[i].name = events_[i]->name;
+    }
+    if (leader_ < 0) {
+        return values;
+    }
+
+    // PERF_FORMAT_GROUP 布局：nr, time_enabled, time_running, value[nr]（按打开顺序）
+    std::vector<uint64_t> buf(3 + events_.size());
+    ssize_t got = ::read(leader_, buf.data(), buf.size() * sizeof(uint64_t));
+    if (got < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+        return values;
+    }
+    uint64_t enabled = buf[1];
+    uint64_t running = buf[2];
+    if (running == 0) {
+        return values; // 整组从未被调度到 PMU 上
+    }
+    double scale = static_cast<double>(enabled) / running;
+
+    size_t slot = 0;
+    for (size_t i = 0; i < events_.size() && slot < buf[0]; ++i) {
+        if (fds_[i] < 0) {
+            continue;
+        }
+        values[i].available = true;
+        values[i].value = buf[3 + slot] * scale;
+        ++slot;
+    }
+    return values;
+}
+
+void accumulate_counters(std::vector<CounterValue>& into, const std::vector<CounterValue>& from) {
+    if (into.empty()) {
+        into = from;
+        return;
+    }
+    for (size_t i = 0; i < into.size() && i < from.size(); ++i) {
+        into[i].available = into[i].available || from[i].available;
+        into[i].value += from[i].value;
+    }
+}
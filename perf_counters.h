@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 一个可以用 perf_event_open 打开的硬件事件
+ */
+struct PerfEventSpec {
+    const char* name;        // 报告中使用的名字，例如 "l1d_misses"
+    uint32_t type;           // PERF_TYPE_HARDWARE / PERF_TYPE_HW_CACHE / PERF_TYPE_RAW
+    uint64_t config;
+    const char* description;
+    bool in_default;         // 是否属于 --counters default
+};
+
+/**
+ * @brief 本平台已知的全部事件；SVE_INST_RETIRED 等架构相关事件只在对应平台上出现
+ */
+const std::vector<PerfEventSpec>& perf_event_specs();
+
+/**
+ * @brief 解析 --counters 的取值
+ *
+ * "default" 为常用集合，"all" 为全部已知事件，也可以是逗号分隔的事件名；
+ * "" / "0" / "off" 表示不采集。名字未知时抛出 std::runtime_error。
+ */
+std::vector<const PerfEventSpec*> parse_counter_list(const std::string& list);
+
+// 一个事件的计数；available 为 false 表示内核或 PMU 不支持、或从未被调度到
+struct CounterValue {
+    const char* name = "";
+    bool available = false;
+    double value = 0.0;       // 已按 time_enabled / time_running 做多路复用缩放
+};
+
+/**
+ * @brief 调用线程自己的一组计数器（pid = 0, cpu = -1，只统计用户态）
+ *
+ * 所有事件放在同一个 group 里，由组长统一 enable / disable，保证各事件统计的是同一段时间。
+ * 不支持的事件被跳过，其余事件照常计数；组长都打不开时 ok() 为 false，error() 给出原因。
+ * 必须在要被统计的线程上构造。
+ */
+class PerfCounterGroup {
+public:
+    explicit PerfCounterGroup(const std::vector<const PerfEventSpec*>& events);
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    bool ok() const { return leader_ >= 0; }
+    const std::string& error() const { return error_; }
+
+    void enable();
+    void disable();
+    void reset();
+
+    // 按构造时的事件顺序返回计数
+    std::vector<CounterValue> read() const;
+
+private:
+    std::vector<const PerfEventSpec*> events_;
+    std::vector<int> fds_;            // 与 events_ 一一对应，打不开的为 -1
+    int leader_ = -1;
+    std::string error_;
+};
+
+/**
+ * @brief 把 from 累加到 into 上（两者事件顺序相同；into 为空时直接复制）
+ */
+void accumulate_counters(std::vector<CounterValue>& into, const std::vector<CounterValue>& from);
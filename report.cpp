@@ -0,0 +1,643 @@
+#include "report.h"
+
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+#include "cpu_features.h"
+#include "timer.h"
+
+namespace {
+
+// CSV 的文本字段：整体加双引号，内部的双引号写两遍（RFC 4180）；融合流水线的阶段列表等可能含逗号
+std::string csv_text(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        quoted += c;
+        if (c == '"') {
+            quoted += '"';
+        }
+    }
+    return quoted + '"';
+}
+
+/**
+ * @brief 极简 JSON 写出器：只支持本文件用到的对象、数组、字符串和数字
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::ostream& out) : out_(out) {}
+
+    void begin_object() { open('{'); }
+    void end_object() { close('}'); }
+    void begin_array() { open('['); }
+    void end_array() { close(']'); }
+
+    JsonWriter& key(const char* name) {
+        separator();
+        string(name);
+        out_ << ": ";
+        pending_key_ = true;
+        return *this;
+    }
+
+    void value(const std::string& s) { separator(); string(s.c_str()); }
+    void value(const char* s) { separator(); string(s); }
+    void value(bool b) { separator(); out_ << (b ? "true" : "false"); }
+    void value(long long v) { separator(); out_ << v; }
+    void value(size_t v) { separator(); out_ << v; }
+    void value(int v) { separator(); out_ << v; }
+    void value(double v) {
+        separator();
+        // JSON 没有 NaN / Inf
+        if (!std::isfinite(v)) {
+            out_ << "null";
+            return;
+        }
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.9g", v);
+        out_ << buf;
+    }
+    void null() { separator(); out_ << "null"; }
+
+private:
+    void open(char c) {
+        separator();
+        out_ << c;
+        first_.push_back(true);
+    }
+
+    void close(char c) {
+        bool empty = first_.back();
+        first_.pop_back();
+        if (!empty) {
+            newline();
+        }
+        out_ << c;
+        if (first_.empty()) {
+            out_ << '\n';
+        }
+    }
+
+    // 在值之前输出逗号和缩进；紧跟在 key 之后的值不需要
+    void separator() {
+        if (pending_key_) {
+            pending_key_ = false;
+            return;
+        }
+        if (first_.empty()) {
+            return;
+        }
+        if (!first_.back()) {
+            out_ << ',';
+        }
+        first_.back() = false;
+        newline();
+    }
+
+    void newline() {
+        out_ << '\n';
+        for (size_t i = 0; i < first_.size(); ++i) {
+            out_ << "  ";
+        }
+    }
+
+    void string(const char* s) {
+        out_ << '"';
+        for (; *s; ++s) {
+            unsigned char c = static_cast<unsigned char>(*s);
+            switch (c) {
+                case '"': out_ << "\\\""; break;
+                case '\\': out_ << "\\\\"; break;
+                case '\n': out_ << "\\n"; break;
+                case '\t': out_ << "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        out_ << buf;
+                    } else {
+                        out_ << *s;
+                    }
+            }
+        }
+        out_ << '"';
+    }
+
+    std::ostream& out_;
+    std::vector<bool> first_;
+    bool pending_key_ = false;
+};
+
+std::string iso8601_now() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm{};
+    gmtime_r(&now, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buf;
+}
+
+void write_page_faults(JsonWriter& json, const char* key, const PageFaults& faults) {
+    json.key(key).begin_object();
+    json.key("minor").value(faults.minor);
+    json.key("major").value(faults.major);
+    json.end_object();
+}
+
+void write_result(JsonWriter& json, const ResultRecord& rec, const RunRecord& record) {
+    const BenchResult& r = rec.result;
+    const LatencySummary lat = r.latency();
+
+    json.begin_object();
+    json.key("op").value(rec.op);
+    json.key("precision").value(rec.precision);
+    json.key("kernel").value(rec.kernel);
+    json.key("backend").value(rec.backend);
+    json.key("vector_bits").value(static_cast<size_t>(rec.vector_bits));
+    json.key("non_temporal").value(rec.non_temporal);
+    json.key("elements").value(r.elements);
+    if (!rec.shape.empty()) {
+        json.key("shape").value(rec.shape);
+        json.key("layout").value(rec.layout);
+        json.key("vectors").value(rec.vectors);
+        json.key("vectors_per_second").value(vectors_per_second(rec));
+    }
+    if (!rec.tiling.empty()) {
+        json.key("tiling").begin_object();
+        json.key("tile_bytes").value(static_cast<size_t>(rec.tile.tile_bytes));
+        json.key("prefetch_bytes").value(static_cast<size_t>(rec.tile.prefetch_bytes));
+        json.key("source").value(rec.tiling);
+        json.end_object();
+    }
+    json.key("footprint_bytes").value(r.footprint_bytes());
+    json.key("flops_per_element").value(r.flops_per_element);
+    json.key("bytes_per_element").value(r.bytes_per_element);
+    json.key("inner_reps").value(r.inner_reps);
+    json.key("schedule").value(schedule_name(r.schedule));
+    json.key("warmup_iterations").value(r.warmup_iterations);
+    json.key("iterations").value(r.iterations);
+    json.key("kernel_calls").value(r.kernel_calls());
+    json.key("total_seconds").value(r.total_seconds);
+    json.key("kernel_seconds").value(r.kernel_seconds);
+    json.key("dispatch_seconds").value(r.dispatch_seconds);
+    json.key("reset_seconds").value(r.reset_seconds);
+    json.key("gflops").value(r.gflops());
+    json.key("bandwidth_gbs").value(r.bandwidth_gbs());
+    json.key("bytes_moved").value(r.bytes_moved());
+    json.key("traffic_bytes").value(r.traffic_bytes());
+    json.key("traffic_gbs").value(r.traffic_gbs());
+    json.key("reset_bytes").value(r.reset_bytes());
+    // 计时循环各窗口的吞吐量：同一次运行内的重复样本，compare_performance.py 用它们做显著性检验
+    json.key("samples").begin_object();
+    json.key("windows").value(r.windows.size());
+    json.key("iterations").begin_array();
+    for (const WindowSample& w : r.windows) {
+        json.value(static_cast<long long>(w.iterations));
+    }
+    json.end_array();
+    json.key("gflops").begin_array();
+    for (double v : r.window_gflops()) {
+        json.value(v);
+    }
+    json.end_array();
+    json.key("bandwidth_gbs").begin_array();
+    for (double v : r.window_bandwidth_gbs()) {
+        json.value(v);
+    }
+    json.end_array();
+    json.end_object();
+
+    json.key("latency_ns").begin_object();
+    json.key("samples").value(lat.samples);
+    json.key("min").value(lat.min_ns);
+    json.key("median").value(lat.median_ns);
+    json.key("p90").value(lat.p90_ns);
+    json.key("p99").value(lat.p99_ns);
+    json.key("p99_9").value(lat.p999_ns);
+    json.key("max").value(lat.max_ns);
+    // 非空桶：[单次调用耗时下界, 样本数]
+    json.key("buckets").begin_array();
+    for (const auto& bucket : r.dispatch_ns.nonzero_buckets()) {
+        json.begin_array();
+        json.value(static_cast<double>(bucket.first) / r.inner_reps);
+        json.value(static_cast<size_t>(bucket.second));
+        json.end_array();
+    }
+    json.end_array();
+    json.end_object();
+
+    write_page_faults(json, "page_faults", r.page_faults);
+    if (record.roofline.measured) {
+        const RooflinePoint point = roofline_point(record.roofline, r);
+        json.key("roofline").begin_object();
+        json.key("arithmetic_intensity").value(point.intensity);
+        json.key("attainable_gflops").value(point.attainable_gflops);
+        json.key("percent_of_roof").value(point.percent_of_roof);
+        json.key("bound").value(point.bound());
+        json.end_object();
+    }
+
+    json.key("memory").begin_object();
+    json.key("pages_requested").value(page_mode_name(rec.memory.requested));
+    json.key("pages").value(page_mode_name(rec.memory.effective));
+    json.key("alignment").value(rec.memory.alignment);
+    json.key("locked").value(rec.memory.locked);
+    json.key("bytes").value(rec.memory.bytes);
+    json.key("huge_page_bytes").value(rec.memory.huge_page_bytes);
+    json.key("init_seconds").value(rec.memory.init_seconds);
+    json.key("source").value(rec.memory.source);
+    json.key("map_seconds").value(rec.memory.map_seconds);
+    write_page_faults(json, "map_faults", rec.memory.map_faults);
+    write_page_faults(json, "init_faults", rec.memory.init_faults);
+    if (!rec.memory.note.empty()) {
+        json.key("note").value(rec.memory.note);
+    }
+    json.end_object();
+
+    json.key("verification");
+    if (rec.verified) {
+        const VerifyResult& v = rec.verify;
+        json.begin_object();
+        json.key("passed").value(v.passed());
+        json.key("checked").value(v.checked);
+        json.key("mismatches").value(v.mismatches);
+        json.key("max_ulp").value(static_cast<size_t>(v.max_ulp));
+        json.key("tolerance_ulp").value(static_cast<size_t>(v.tolerance_ulp));
+        json.key("seconds").value(v.seconds);
+        if (v.mismatches > 0) {
+            json.key("first_mismatch").begin_object();
+            json.key("index").value(v.first_index);
+            json.key("expected").value(v.first_expected);
+            json.key("got").value(v.first_got);
+            json.end_object();
+        }
+        if (v.dot_mismatches > 0) {
+            json.key("dot_mismatches").value(v.dot_mismatches);
+            json.key("first_dot_mismatch").begin_object();
+            json.key("stage").value(v.first_dot);
+            json.key("expected").value(v.dot_expected);
+            json.key("got").value(v.dot_got);
+            json.end_object();
+        }
+        json.end_object();
+    } else {
+        json.null();
+    }
+
+    if (!record.options.counters.empty()) {
+        json.key("counters").begin_object();
+        for (const CounterValue& c : r.counters) {
+            json.key(c.name);
+            if (c.available) {
+                json.value(c.value);
+            } else {
+                json.null();
+            }
+        }
+        json.end_object();
+        if (r.ipc() > 0) {
+            json.key("ipc").value(r.ipc());
+        } else {
+            json.key("ipc").null();
+        }
+        if (!r.counters_error.empty()) {
+            json.key("counters_error").value(r.counters_error);
+        }
+    }
+
+    json.key("threads").begin_array();
+    for (size_t tid = 0; tid < r.threads.size(); ++tid) {
+        const ThreadStats& t = r.threads[tid];
+        const double per_call = r.thread_elements(tid, rec.chunks[tid].size());
+        double elems = per_call * r.kernel_calls();
+        double busy = t.busy_seconds;
+        json.begin_object();
+        json.key("tid").value(tid);
+        json.key("cpu").value(record.cpus[tid].cpu);
+        json.key("node").value(record.cpus[tid].node);
+        if (r.schedule == Schedule::Steal) {
+            json.key("elements").value(per_call);
+        } else {
+            json.key("elements").value(rec.chunks[tid].size());
+        }
+        json.key("kernel_seconds").value(t.kernel_seconds);
+        json.key("busy_seconds").value(busy);
+        json.key("idle_seconds").value(r.thread_idle_seconds(tid));
+        json.key("reset_seconds").value(t.reset_seconds);
+        if (r.schedule == Schedule::Steal) {
+            json.key("tasks").value(t.tasks);
+            json.key("stolen_tasks").value(t.stolen_tasks);
+        }
+        json.key("gflops").value(busy > 0 ? r.flops_per_element * elems / busy / 1e9 : 0.0);
+        json.key("bandwidth_gbs").value(busy > 0 ? r.bytes_per_element * elems / busy / 1e9 : 0.0);
+        json.end_object();
+    }
+    json.end_array();
+    json.end_object();
+}
+
+} // namespace
+
+ResultRecord saxpy_result_record(const SaxpyKernel& kernel) {
+    ResultRecord rec;
+    rec.kernel = kernel.name;
+    rec.backend = kernel.backend;
+    const SaxpyBackend* backend = find_saxpy_backend(kernel.backend);
+    rec.vector_bits = backend ? backend->vector_bits : 0;
+    rec.non_temporal = kernel.non_temporal;
+    return rec;
+}
+
+ResultRecord blas1_result_record(const Blas1Kernel& kernel) {
+    ResultRecord rec;
+    rec.op = kernel.name;
+    rec.precision = blas1_precision_name(kernel);
+    rec.kernel = kernel.name;
+    rec.backend = kernel.backend;
+    // 套件的两个后端（sve / autovec）与同名的 SAXPY 后端向量宽度相同
+    const SaxpyBackend* backend = find_saxpy_backend(kernel.backend);
+    rec.vector_bits = backend ? backend->vector_bits : 0;
+    return rec;
+}
+
+ResultRecord batch_result_record(const SaxpyBatchKernel& kernel, const BatchShape& shape, BatchLayout layout) {
+    ResultRecord rec;
+    rec.op = "saxpy_batch";
+    rec.kernel = kernel.name;
+    rec.backend = kernel.backend;
+    const SaxpyBackend* backend = find_saxpy_backend(kernel.backend);
+    rec.vector_bits = backend ? backend->vector_bits : 0;
+    rec.shape = shape.name();
+    rec.layout = batch_layout_name(layout);
+    rec.vectors = shape.count;
+    return rec;
+}
+
+ResultRecord tiled_result_record(const PrefetchSaxpyKernel& kernel, const TileConfig& tile, const std::string& source) {
+    ResultRecord rec;
+    rec.kernel = kernel.name;
+    rec.backend = kernel.backend;
+    const SaxpyBackend* backend = find_saxpy_backend(kernel.backend);
+    rec.vector_bits = backend ? backend->vector_bits : 0;
+    rec.tile = tile;
+    rec.tiling = source;
+    return rec;
+}
+
+ResultRecord fusion_result_record(const std::vector<FusedOp>& ops, FusionMode mode) {
+    ResultRecord rec;
+    rec.op = "pipeline";
+    rec.kernel = fusion_mode_name(mode);
+    // fused 方式的 axpy→dot 用融合内核，其余阶段和另两种方式用默认 SAXPY 内核的后端
+    rec.backend = mode == FusionMode::Fused && ops.size() > 1 ? axpy_dot_kernels().front().backend
+                                                              : saxpy_kernels().front().backend;
+    const SaxpyBackend* backend = find_saxpy_backend(rec.backend.c_str());
+    rec.vector_bits = backend ? backend->vector_bits : 0;
+    rec.shape = fused_ops_name(ops);
+    return rec;
+}
+
+double vectors_per_second(const ResultRecord& rec) {
+    const BenchResult& r = rec.result;
+    return r.kernel_seconds > 0 ? static_cast<double>(rec.vectors) * r.kernel_calls() / r.kernel_seconds : 0.0;
+}
+
+void write_json(std::ostream& out, const RunRecord& record) {
+    const Options& opts = record.options;
+    const CpuFeatures& cpu = cpu_features();
+    JsonWriter json(out);
+
+    json.begin_object();
+    json.key("schema_version").value(REPORT_SCHEMA_VERSION);
+    json.key("benchmark").value("saxpy");
+    json.key("timestamp").value(iso8601_now());
+
+    json.key("system").begin_object();
+    json.key("cpu_model").value(cpu.model);
+    json.key("cpu_features").value(cpu_feature_string());
+    if (cpu.sve) {
+        json.key("sve_vector_bits").value(static_cast<size_t>(cpu.sve_vector_bytes * 8));
+    } else {
+        json.key("sve_vector_bits").null();
+    }
+    json.key("numa_nodes").value(record.numa_nodes);
+    if (record.llc_bytes > 0) {
+        json.key("llc_bytes").value(record.llc_bytes);
+    } else {
+        json.key("llc_bytes").null();
+    }
+    json.key("transparent_hugepage").value(transparent_hugepage_setting());
+    json.key("roofline");
+    if (record.roofline.measured) {
+        const RooflinePeaks& peaks = record.roofline;
+        json.begin_object();
+        json.key("peak_gflops").value(peaks.peak_gflops);
+        json.key("fma_kernel").value(peaks.fma_kernel);
+        json.key("fma_backend").value(peaks.fma_backend);
+        json.key("peak_bandwidth_gbs").value(peaks.peak_bandwidth_gbs);
+        json.key("bandwidth_kernel").value(peaks.bandwidth_kernel);
+        json.key("bandwidth_elements").value(peaks.bandwidth_elements);
+        json.key("copy_gbs").value(peaks.copy_gbs);
+        json.key("triad_gbs").value(peaks.triad_gbs);
+        json.key("ridge_intensity").value(peaks.ridge_intensity());
+        json.end_object();
+    } else {
+        json.null();
+    }
+    json.key("dispatch_latency");
+    if (record.dispatch.measured) {
+        const DispatchLatency& d = record.dispatch;
+        json.begin_object();
+        json.key("threads").value(d.threads);
+        json.key("worker_spin_ns").value(d.worker_spin_ns);
+        json.key("main_spin_ns").value(d.main_spin_ns);
+        json.key("variants").begin_array();
+        for (const DispatchVariant& v : d.variants) {
+            json.begin_object();
+            json.key("name").value(v.name);
+            json.key("samples").value(v.latency.samples);
+            json.key("min_ns").value(v.latency.min_ns);
+            json.key("median_ns").value(v.latency.median_ns);
+            json.key("p90_ns").value(v.latency.p90_ns);
+            json.key("p99_ns").value(v.latency.p99_ns);
+            json.key("p999_ns").value(v.latency.p999_ns);
+            json.key("max_ns").value(v.latency.max_ns);
+            json.key("mean_ns").value(v.mean_ns);
+            json.end_object();
+        }
+        json.end_array();
+        json.end_object();
+    } else {
+        json.null();
+    }
+    const TimerInfo& timer = timer_info();
+    json.key("timer").begin_object();
+    json.key("source").value(timer.source);
+    json.key("frequency_hz").value(timer.ticks_per_second);
+    json.key("overhead_ns").value(timer.overhead_ns());
+    json.key("reliable").value(timer.reliable);
+    json.end_object();
+    json.key("cpus").begin_array();
+    for (const CpuSlot& slot : record.cpus) {
+        json.value(slot.cpu);
+    }
+    json.end_array();
+    json.end_object();
+
+    json.key("config").begin_object();
+    json.key("elements").value(opts.elements);
+    json.key("a").value(static_cast<double>(opts.a));
+    json.key("mode").value(measure_mode_name(opts.mode));
+    json.key("schedule").value(schedule_name(opts.schedule));
+    json.key("steal_grain").value(opts.steal_grain);
+    json.key("duration_seconds").value(opts.duration_seconds);
+    json.key("iterations").value(opts.iterations);
+    json.key("warmup").value(opts.warmup);
+    json.key("samples").value(opts.sample_windows);
+    json.key("batch").value(opts.batch);
+    json.key("counters").value(opts.counters);
+    json.key("pages").value(page_mode_name(opts.alloc.pages));
+    json.key("alignment").value(opts.alloc.alignment ? opts.alloc.alignment : default_alignment());
+    json.key("mlock").value(opts.alloc.lock);
+    json.key("x_file").value(opts.inputs.x_path);
+    json.key("y_file").value(opts.inputs.y_path);
+    json.key("populate").value(opts.inputs.populate);
+    json.key("verify").value(!opts.skip_verify);
+    json.key("verify_ulp").value(static_cast<size_t>(opts.verify_ulp));
+    json.key("threads").value(record.cpus.size());
+    json.key("kernels").value(opts.kernels.empty() ? "auto" : opts.kernels);
+    json.key("ops").value(opts.ops);
+    json.key("batched").value(opts.batch_shapes);
+    json.key("fused").value(opts.fused_ops);
+    json.key("roofline").value(opts.roofline);
+    json.key("dispatch_latency").value(opts.dispatch_latency);
+    json.key("trace").value(opts.trace_path);
+    json.key("mpi_scaling").value(opts.mpi_scaling);
+    json.key("mpi_dot").value(opts.mpi_dot);
+    json.key("tile").value(opts.tile_auto ? std::string("auto") : std::to_string(opts.tile_bytes));
+    json.key("prefetch_bytes").value(static_cast<size_t>(opts.prefetch_bytes));
+    json.key("tuned").value(opts.tuned);
+    json.key("sweep").begin_object();
+    json.key("enabled").value(opts.sweep.enabled);
+    json.key("min_bytes").value(opts.sweep.min_bytes);
+    json.key("max_bytes").value(opts.sweep.max_bytes);
+    json.key("seconds_per_size").value(opts.sweep.seconds_per_size);
+    json.end_object();
+    json.end_object();
+
+    json.key("results").begin_array();
+    for (const ResultRecord& rec : record.results) {
+        write_result(json, rec, record);
+    }
+    json.end_array();
+
+    json.key("mpi_scaling");
+    if (record.mpi.measured) {
+        const MpiScaling& m = record.mpi;
+        json.begin_object();
+        json.key("ranks").value(m.ranks);
+        json.key("nodes").value(m.nodes);
+        json.key("threads_per_rank").value(m.threads_per_rank);
+        json.key("kernel").value(m.kernel);
+        json.key("dot_allreduce").value(m.dot);
+        json.key("points").begin_array();
+        for (const MpiScalingPoint& p : m.points) {
+            json.begin_object();
+            json.key("mode").value(p.mode);
+            json.key("ranks").value(p.ranks);
+            json.key("elements").value(p.elements);
+            json.key("max_rank_elements").value(p.max_rank_elements);
+            json.key("iterations").value(p.iterations);
+            json.key("iteration_seconds").value(p.iteration_seconds);
+            json.key("saxpy_seconds").value(p.saxpy_seconds);
+            json.key("min_saxpy_seconds").value(p.min_saxpy_seconds);
+            json.key("allreduce_seconds").value(p.allreduce_seconds);
+            json.key("bandwidth_gbs").value(p.bandwidth_gbs);
+            json.key("gflops").value(p.gflops);
+            json.key("efficiency").value(p.efficiency);
+            json.key("dot").value(p.dot);
+            json.key("verified").value(p.verified);
+            json.end_object();
+        }
+        json.end_array();
+        json.end_object();
+    } else {
+        json.null();
+    }
+    json.end_object();
+}
+
+void write_csv(std::ostream& out, const RunRecord& record) {
+    // 采集了计数器时，在固定列之后按 --counters 的顺序追加各事件和 IPC，不可用的留空。
+    // shape / layout / vectors 只对批量 SAXPY 和融合流水线有值，tile_bytes / prefetch_bytes 只对分块 SAXPY 有值
+    const std::vector<const PerfEventSpec*> counters = parse_counter_list(record.options.counters);
+    out << "op,precision,kernel,backend,vector_bits,mode,shape,layout,vectors,tile_bytes,prefetch_bytes,schedule,"
+           "threads,elements,footprint_bytes,inner_reps,iterations,"
+           "kernel_calls,kernel_seconds,gflops,bandwidth_gbs,bytes_moved,non_temporal,traffic_bytes,"
+           "latency_min_ns,latency_median_ns,latency_p90_ns,latency_p99_ns,latency_p999_ns,latency_max_ns,"
+           "pages,huge_page_bytes,verification,max_ulp";
+    for (const PerfEventSpec* spec : counters) {
+        out << ',' << spec->name;
+    }
+    out << (counters.empty() ? "\n" : ",ipc\n");
+    for (const ResultRecord& rec : record.results) {
+        const BenchResult& r = rec.result;
+        const LatencySummary lat = r.latency();
+        out << csv_text(rec.op) << ',' << csv_text(rec.precision) << ',' << csv_text(rec.kernel) << ','
+            << csv_text(rec.backend) << ',' << rec.vector_bits << ',' << csv_text(measure_mode_name(record.options.mode))
+            << ',' << csv_text(rec.shape) << ',' << csv_text(rec.layout) << ',';
+        if (!rec.shape.empty()) {
+            out << rec.vectors;
+        }
+        out << ',';
+        if (!rec.tiling.empty()) {
+            out << rec.tile.tile_bytes << ',' << rec.tile.prefetch_bytes;
+        } else {
+            out << ',';
+        }
+        out << ',' << csv_text(schedule_name(r.schedule));
+        char line[512];
+        std::snprintf(line, sizeof(line),
+                      ",%zu,%zu,%zu,%zu,%lld,%.0f,%.9g,%.9g,%.9g,%.0f,%d,%.0f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,",
+                      record.cpus.size(), r.elements, r.footprint_bytes(), r.inner_reps,
+                      r.iterations, r.kernel_calls(), r.kernel_seconds, r.gflops(), r.bandwidth_gbs(),
+                      r.bytes_moved(), rec.non_temporal ? 1 : 0, r.traffic_bytes(), lat.min_ns, lat.median_ns, lat.p90_ns, lat.p99_ns, lat.p999_ns,
+                      lat.max_ns);
+        out << line << csv_text(page_mode_name(rec.memory.effective)) << ',' << rec.memory.huge_page_bytes << ','
+            << csv_text(!rec.verified ? "skipped" : rec.verify.passed() ? "pass" : "fail") << ','
+            << rec.verify.max_ulp;
+        if (!counters.empty()) {
+            for (const PerfEventSpec* spec : counters) {
+                const CounterValue* c = r.counter(spec->name);
+                out << ',';
+                if (c) {
+                    std::snprintf(line, sizeof(line), "%.0f", c->value);
+                    out << line;
+                }
+            }
+            out << ',';
+            if (r.ipc() > 0) {
+                std::snprintf(line, sizeof(line), "%.4f", r.ipc());
+                out << line;
+            }
+        }
+        out << '\n';
+    }
+}
+
+void write_record_file(const std::string& path, const RunRecord& record) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open output file: " + path);
+    }
+    bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+        write_csv(out, record);
+    } else {
+        write_json(out, record);
+    }
+}
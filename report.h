@@ -0,0 +1,90 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "batch.h"
+#include "benchmark.h"
+#include "blas1.h"
+#include "cli.h"
+#include "dispatch_latency.h"
+#include "fusion.h"
+#include "mpi_scaling.h"
+#include "roofline.h"
+#include "tiling.h"
+#include "verify.h"
+
+/**
+ * @brief 一个内核在一个规模上的测量结果
+ */
+struct ResultRecord {
+    std::string op = "saxpy";       // saxpy 或 BLAS-1 套件的内核名（daxpy、sdot ...）
+    std::string precision = "f32";
+    std::string kernel;             // SAXPY 内核名；套件中与 op 相同
+    std::string backend;
+    unsigned vector_bits = 0;       // 后端的向量宽度；0 表示可变长度
+    bool non_temporal = false;      // 内核是否使用流式存储
+    std::string shape;              // 批量 SAXPY 的批形状（如 16384x256）或融合流水线的阶段列表；其他操作为空
+    std::string layout;             // 批量 SAXPY 的数据布局：items / strided
+    size_t vectors = 0;             // 批量 SAXPY 每次调用处理的向量个数
+    TileConfig tile;                // 分块 SAXPY 的分块和预取配置
+    std::string tiling;             // 分块配置的来源：option / cache / tuned / host-tuned；空表示不是分块 SAXPY
+    BenchResult result;
+    std::vector<Range> chunks;      // 每个线程负责的数据块
+    MemoryInfo memory;              // 工作区的页面 / 对齐情况
+    bool verified = false;          // 是否做了整向量验证
+    VerifyResult verify;
+};
+
+// SAXPY 内核的结果记录，只填好 op / kernel / backend / vector_bits
+ResultRecord saxpy_result_record(const SaxpyKernel& kernel);
+
+// BLAS-1 套件内核的结果记录
+ResultRecord blas1_result_record(const Blas1Kernel& kernel);
+
+// 批量 SAXPY 的结果记录，op 为 saxpy_batch
+ResultRecord batch_result_record(const SaxpyBatchKernel& kernel, const BatchShape& shape, BatchLayout layout);
+
+// 融合流水线的结果记录：op 为 pipeline，kernel 为执行方式，shape 为阶段列表（如 axpy+dot）
+ResultRecord fusion_result_record(const std::vector<FusedOp>& ops, FusionMode mode);
+
+// 分块 SAXPY 的结果记录：op 为 saxpy，kernel 为可调预取内核名，source 为配置来源
+ResultRecord tiled_result_record(const PrefetchSaxpyKernel& kernel, const TileConfig& tile, const std::string& source);
+
+// 批量 SAXPY 每秒处理的向量个数（即等价的单次 saxpy 调用次数）
+double vectors_per_second(const ResultRecord& rec);
+
+/**
+ * @brief 一次 perf_test 运行的完整记录，直接供 scripts/ 下的分析脚本读取
+ */
+struct RunRecord {
+    Options options;
+    std::vector<CpuSlot> cpus;      // 每个工作线程绑定的 CPU
+    int numa_nodes = 1;
+    size_t llc_bytes = 0;           // 自动选择内核所用的末级缓存容量；0 表示未知
+    RooflinePeaks roofline;         // --roofline 时测得的两条屋顶
+    DispatchLatency dispatch;       // --dispatch-latency 时测得的线程池往返耗时
+    MpiScaling mpi;                 // --mpi-scaling 时各 rank 数上的分布式 SAXPY（只在 rank 0 上完整）
+    std::vector<ResultRecord> results;
+};
+
+// JSON 记录的格式版本，字段有不兼容变化时递增
+constexpr int REPORT_SCHEMA_VERSION = 1;
+
+/**
+ * @brief 输出 JSON 记录（单个对象，带 config / system / results）
+ */
+void write_json(std::ostream& out, const RunRecord& record);
+
+/**
+ * @brief 输出 CSV：一行表头，每个结果一行
+ */
+void write_csv(std::ostream& out, const RunRecord& record);
+
+/**
+ * @brief 把记录写入文件；扩展名为 .csv 时写 CSV，否则写 JSON
+ *
+ * 打开文件失败时抛出 std::runtime_error。
+ */
+void write_record_file(const std::string& path, const RunRecord& record);
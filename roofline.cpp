@@ -0,0 +1,194 @@
+#include "roofline.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "blas1.h"
+#include "cpu_features.h"
+#include "roofline_backends.h"
+#include "saxpy.h"
+
+namespace {
+
+// 可移植的后备实现：GCC 向量扩展的 128-bit 向量，-ffp-contract=fast（GNU 模式默认）下 a * m + c 合成 FMA
+typedef float v4sf __attribute__((vector_size(16)));
+
+double fma_peak_generic(uint64_t iterations, float* sink) {
+    const v4sf m = {0.999999f, 0.999999f, 0.999999f, 0.999999f};
+    const v4sf c = {1e-6f, 1e-6f, 1e-6f, 1e-6f};
+    const v4sf base = {0.1f, 0.2f, 0.3f, 0.4f};
+    // 16 个具名累加器：放在数组里时 -O2 不会展开内层循环，每次 FMA 都经过栈上的读写
+    v4sf a0 = base * 1.0f, a1 = base * 2.0f, a2 = base * 3.0f, a3 = base * 4.0f;
+    v4sf a4 = base * 5.0f, a5 = base * 6.0f, a6 = base * 7.0f, a7 = base * 8.0f;
+    v4sf a8 = base * 9.0f, a9 = base * 10.0f, a10 = base * 11.0f, a11 = base * 12.0f;
+    v4sf a12 = base * 13.0f, a13 = base * 14.0f, a14 = base * 15.0f, a15 = base * 16.0f;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        a0 = a0 * m + c;
+        a1 = a1 * m + c;
+        a2 = a2 * m + c;
+        a3 = a3 * m + c;
+        a4 = a4 * m + c;
+        a5 = a5 * m + c;
+        a6 = a6 * m + c;
+        a7 = a7 * m + c;
+        a8 = a8 * m + c;
+        a9 = a9 * m + c;
+        a10 = a10 * m + c;
+        a11 = a11 * m + c;
+        a12 = a12 * m + c;
+        a13 = a13 * m + c;
+        a14 = a14 * m + c;
+        a15 = a15 * m + c;
+    }
+    const v4sf s = ((a0 + a1) + (a2 + a3)) + ((a4 + a5) + (a6 + a7)) + ((a8 + a9) + (a10 + a11)) +
+                   ((a12 + a13) + (a14 + a15));
+    *sink = s[0] + s[1] + s[2] + s[3];
+    return 2.0 * 16 * 4 * static_cast<double>(iterations);
+}
+
+// 一次调用的迭代次数：约几十微秒，由 calibrate_workload_reps 再合成足够长的批
+constexpr uint64_t FMA_ITERATIONS = 1 << 14;
+
+// 带宽内核每个数组的最小字节数（LLC 未知时使用）
+constexpr size_t DEFAULT_BANDWIDTH_ARRAY_BYTES = size_t(256) << 20;
+
+const Blas1Kernel& find_blas1(const char* name) {
+    for (const Blas1Kernel& kernel : blas1_kernels()) {
+        if (std::strcmp(kernel.name, name) == 0) {
+            return kernel;
+        }
+    }
+    throw std::runtime_error(std::string("BLAS-1 kernel ") + name + " is not available");
+}
+
+} // namespace
+
+const std::vector<FmaPeakKernel>& fma_peak_kernels() {
+    static const std::vector<FmaPeakKernel> kernels = [] {
+        const CpuFeatures& cpu = cpu_features();
+        std::vector<FmaPeakKernel> out;
+        if (cpu.sve) {
+            out.insert(out.end(), sve_fma_peak_table().begin(), sve_fma_peak_table().end());
+        }
+        if (cpu.avx512f) {
+            out.insert(out.end(), avx512_fma_peak_table().begin(), avx512_fma_peak_table().end());
+        }
+        if (cpu.avx2) {
+            out.insert(out.end(), avx2_fma_peak_table().begin(), avx2_fma_peak_table().end());
+        }
+        if (cpu.neon) {
+            out.insert(out.end(), neon_fma_peak_table().begin(), neon_fma_peak_table().end());
+        }
+        out.push_back({"fma_generic", "generic", 128, "16 independent 128-bit vector-extension chains",
+                       fma_peak_generic});
+        return out;
+    }();
+    return kernels;
+}
+
+RooflinePeaks measure_roofline(ThreadPool& pool, const BenchConfig& config, size_t llc_bytes,
+                               const AllocPolicy& policy, double seconds, std::ostream* progress) {
+    // 只沿用预热设置：计数器、进度和固定迭代次数都不适用于微内核
+    BenchConfig cfg;
+    cfg.warmup_iterations = config.warmup_iterations;
+    cfg.target_seconds = seconds;
+    cfg.mode = MeasureMode::DoubleBuffer;
+
+    RooflinePeaks peaks;
+    peaks.measured = true;
+
+    // 1. 计算峰值：每个线程在自己的核上独立运行同一个 FMA 微内核
+    const FmaPeakKernel& fma = fma_peak_kernels().front();
+    std::vector<float> sinks(pool.size() * 16);   // 每个线程独占一个缓存行
+    float scratch = 0.0f;
+    Workload work;
+    work.elements = pool.size();
+    work.flops_per_element = fma.fn(1, &scratch) * FMA_ITERATIONS;
+    work.bytes_per_element = 0.0;
+    work.footprint_bytes_per_element = 0.0;
+    work.body = [&fma, &sinks](size_t tid, size_t reps) {
+        for (size_t rep = 0; rep < reps; ++rep) {
+            fma.fn(FMA_ITERATIONS, &sinks[tid * 16]);
+        }
+    };
+    cfg.inner_reps = calibrate_workload_reps(pool, work, 1e-3);
+    peaks.peak_gflops = run_workload(pool, work, cfg).gflops();
+    peaks.fma_kernel = fma.name;
+    peaks.fma_backend = fma.backend;
+    if (progress) {
+        *progress << "  " << std::left << std::setw(18) << fma.name << std::setw(10) << fma.backend << std::right
+                  << std::fixed << std::setprecision(3) << std::setw(12) << peaks.peak_gflops << " GFLOPS"
+                  << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+
+    // 2. 带宽峰值：STREAM 的规则，每个数组至少是 LLC 的 4 倍。
+    // 屋顶取各候选内核实际搬运的字节数（含写分配）中最快的一个：按 STREAM 口径计数时普通存储的
+    // 写分配读不算在内，最好后端上的原地 SAXPY 会超过这样测出的屋顶
+    const size_t array_bytes = llc_bytes ? 4 * llc_bytes : DEFAULT_BANDWIDTH_ARRAY_BYTES;
+    peaks.bandwidth_elements = array_bytes / sizeof(float);
+    peaks.llc_bytes = llc_bytes;
+    auto consider = [&](const std::string& name, const char* backend, const BenchResult& result) {
+        const double gbs = result.traffic_gbs();
+        if (gbs > peaks.peak_bandwidth_gbs) {
+            peaks.peak_bandwidth_gbs = gbs;
+            peaks.bandwidth_kernel = name;
+        }
+        if (progress) {
+            *progress << "  " << std::left << std::setw(18) << name << std::setw(10) << backend << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(12) << gbs << " GB/s"
+                      << std::defaultfloat << std::setprecision(6) << std::endl;
+        }
+        return gbs;
+    };
+    {
+        Blas1Workspace ws(pool, peaks.bandwidth_elements, Precision::F32, policy);
+        for (const char* name : {"scopy", "striad"}) {
+            const Blas1Kernel& kernel = find_blas1(name);
+            cfg.inner_reps = calibrate_blas1_reps(pool, ws, kernel, cfg, 1e-3);
+            const double gbs = consider(kernel.name, kernel.backend, run_blas1(pool, ws, kernel, cfg));
+            (kernel.op == Blas1Op::Copy ? peaks.copy_gbs : peaks.triad_gbs) = gbs;
+        }
+    }
+
+    // 最好后端上的 SAXPY：默认内核的原地 / 非原地写，以及超过 LLC 时自动选中的流式存储内核
+    Workspace ws(pool, peaks.bandwidth_elements, policy);
+    const SaxpyKernel& best = saxpy_kernels().front();
+    const SaxpyKernel& streaming = auto_saxpy_kernel(array_bytes * 3, llc_bytes ? llc_bytes : array_bytes);
+    std::vector<std::pair<const SaxpyKernel*, MeasureMode>> candidates = {
+        {&best, MeasureMode::Kernel},
+        {&best, MeasureMode::DoubleBuffer},
+    };
+    if (streaming.non_temporal && &streaming != &best) {
+        candidates.emplace_back(&streaming, MeasureMode::DoubleBuffer);
+    }
+    for (const auto& [kernel, mode] : candidates) {
+        BenchConfig saxpy = cfg;
+        saxpy.kernel = kernel;
+        saxpy.mode = mode;
+        saxpy.inner_reps = calibrate_inner_reps(pool, ws, saxpy, 1e-3);
+        consider(std::string(kernel->name) + (mode == MeasureMode::Kernel ? " in-place" : ""), kernel->backend,
+                 run_benchmark(pool, ws, saxpy));
+    }
+    return peaks;
+}
+
+RooflinePoint roofline_point(const RooflinePeaks& peaks, const BenchResult& result) {
+    RooflinePoint point;
+    // 和带宽峰值用同一个口径：实际搬运的字节数，含写分配读
+    const double traffic_bytes_per_element = result.bytes_per_element + result.write_allocate_bytes_per_element;
+    if (!peaks.measured || traffic_bytes_per_element <= 0) {
+        return point;
+    }
+    point.intensity = result.flops_per_element / traffic_bytes_per_element;
+    point.attainable_gflops = std::min(peaks.peak_gflops, point.intensity * peaks.peak_bandwidth_gbs);
+    point.percent_of_roof = point.attainable_gflops > 0 ? result.gflops() / point.attainable_gflops * 100.0 : 0.0;
+    point.memory_bound = point.intensity < peaks.ridge_intensity();
+    point.in_cache = peaks.llc_bytes > 0 && result.footprint_bytes() <= peaks.llc_bytes;
+    return point;
+}
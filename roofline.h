@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "allocator.h"
+#include "benchmark.h"
+#include "thread_pool.h"
+
+/**
+ * @brief 峰值 FMA 微内核：iterations 次迭代，每次对若干个互相独立的向量累加器各做一次 FMA
+ *
+ * 累加器个数按 FMA 延迟 × 发射端口数取足，使流水线一直是满的；数据全在寄存器里，不访问内存。
+ * 返回执行的浮点运算次数（一次 FMA 记 2 次），累加器之和写入 *sink，防止计算被优化掉。
+ */
+using FmaPeakFn = double (*)(uint64_t iterations, float* sink);
+
+struct FmaPeakKernel {
+    const char* name;
+    const char* backend;
+    unsigned vector_bits;        // 0 表示可变长度（SVE）
+    const char* description;
+    FmaPeakFn fn;
+};
+
+/**
+ * @brief 本机可用的峰值 FMA 内核，按后端优先级排列（sve > avx512 > avx2 > neon > generic）；
+ *        第一个用于屋顶线的计算峰值
+ */
+const std::vector<FmaPeakKernel>& fma_peak_kernels();
+
+/**
+ * @brief 屋顶线模型的两条屋顶：同一台机器、同一组线程上测得的峰值 FLOPS 和峰值内存带宽
+ *
+ * 带宽峰值取 STREAM 式内核（scopy / striad）和最好后端上的 SAXPY（原地、非原地、流式存储）中最快的一个，
+ * 按实际搬运的字节数（含写分配）计算；每个数组至少是 LLC 的 4 倍，保证测到的是 DRAM 带宽。
+ */
+struct RooflinePeaks {
+    bool measured = false;
+    double peak_gflops = 0.0;
+    std::string fma_kernel;
+    std::string fma_backend;
+    double peak_bandwidth_gbs = 0.0;
+    std::string bandwidth_kernel;       // 达到峰值带宽的内核
+    size_t bandwidth_elements = 0;      // 带宽内核每个数组的元素个数
+    size_t llc_bytes = 0;               // 测量时使用的 LLC 大小，0 = 未知
+    double copy_gbs = 0.0;              // 含写分配
+    double triad_gbs = 0.0;
+
+    // 脊点：算术强度高于它时受计算限制，低于它时受带宽限制（flop/B）
+    double ridge_intensity() const { return peak_bandwidth_gbs > 0 ? peak_gflops / peak_bandwidth_gbs : 0.0; }
+};
+
+/**
+ * @brief 在线程池的全部线程上测量两个峰值，每个微内核测量 seconds 秒
+ *
+ * 只沿用 config 中的预热次数，不采集计数器；llc_bytes 为 0 时每个数组按 256 MiB 计。
+ * progress 非空时打印每个微内核的结果。
+ */
+RooflinePeaks measure_roofline(ThreadPool& pool, const BenchConfig& config, size_t llc_bytes,
+                               const AllocPolicy& policy, double seconds, std::ostream* progress = nullptr);
+
+/**
+ * @brief 一个测量结果在屋顶线上的位置
+ */
+struct RooflinePoint {
+    double intensity = 0.0;            // flops / traffic_bytes（flop/B），含写分配，与带宽峰值口径一致
+    double attainable_gflops = 0.0;    // min(峰值 FLOPS, 算术强度 × 峰值带宽)
+    double percent_of_roof = 0.0;      // 实测 GFLOPS / attainable_gflops × 100
+    bool memory_bound = true;          // 算术强度低于脊点
+    bool in_cache = false;             // 受带宽限制但工作集放得进 LLC：屋顶按 DRAM 计，百分比可能超过 100
+
+    const char* bound() const { return !memory_bound ? "compute" : in_cache ? "cache" : "memory"; }
+};
+
+/**
+ * @brief 按结果每元素的 flops 和实际搬运的字节数（含写分配）计算算术强度和所处的屋顶
+ *
+ * 屋顶按 DRAM 带宽计算，工作集在缓存里的结果可能超过 100%，这类结果标为 cache。
+ */
+RooflinePoint roofline_point(const RooflinePeaks& peaks, const BenchResult& result);
@@ -0,0 +1,61 @@
+#include "roofline_backends.h"
+
+// 本文件用 -mavx2 -mfma 单独编译
+#if defined(__AVX2__) && defined(__FMA__)
+
+#include <immintrin.h>
+
+namespace {
+
+// 12 个 ymm 累加器，理由同 roofline_avx512.cpp
+double fma_peak_avx2(uint64_t iterations, float* sink) {
+    const __m256 m = _mm256_set1_ps(0.999999f);
+    const __m256 c = _mm256_set1_ps(1e-6f);
+    __m256 a0 = _mm256_set1_ps(0.1f), a1 = _mm256_set1_ps(0.2f), a2 = _mm256_set1_ps(0.3f);
+    __m256 a3 = _mm256_set1_ps(0.4f), a4 = _mm256_set1_ps(0.5f), a5 = _mm256_set1_ps(0.6f);
+    __m256 a6 = _mm256_set1_ps(0.7f), a7 = _mm256_set1_ps(0.8f), a8 = _mm256_set1_ps(0.9f);
+    __m256 a9 = _mm256_set1_ps(1.1f), a10 = _mm256_set1_ps(1.2f), a11 = _mm256_set1_ps(1.3f);
+    for (uint64_t i = 0; i < iterations; ++i) {
+        a0 = _mm256_fmadd_ps(a0, m, c);
+        a1 = _mm256_fmadd_ps(a1, m, c);
+        a2 = _mm256_fmadd_ps(a2, m, c);
+        a3 = _mm256_fmadd_ps(a3, m, c);
+        a4 = _mm256_fmadd_ps(a4, m, c);
+        a5 = _mm256_fmadd_ps(a5, m, c);
+        a6 = _mm256_fmadd_ps(a6, m, c);
+        a7 = _mm256_fmadd_ps(a7, m, c);
+        a8 = _mm256_fmadd_ps(a8, m, c);
+        a9 = _mm256_fmadd_ps(a9, m, c);
+        a10 = _mm256_fmadd_ps(a10, m, c);
+        a11 = _mm256_fmadd_ps(a11, m, c);
+    }
+    __m256 s = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3)),
+                             _mm256_add_ps(_mm256_add_ps(a4, a5), _mm256_add_ps(a6, a7)));
+    s = _mm256_add_ps(s, _mm256_add_ps(_mm256_add_ps(a8, a9), _mm256_add_ps(a10, a11)));
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, s);
+    float total = 0.0f;
+    for (float v : lanes) {
+        total += v;
+    }
+    *sink = total;
+    return 2.0 * 12 * 8 * static_cast<double>(iterations);
+}
+
+} // namespace
+
+const std::vector<FmaPeakKernel>& avx2_fma_peak_table() {
+    static const std::vector<FmaPeakKernel> table = {
+        {"fma_avx2", "avx2", 256, "12 independent vfmadd chains on ymm registers", fma_peak_avx2},
+    };
+    return table;
+}
+
+#else
+
+const std::vector<FmaPeakKernel>& avx2_fma_peak_table() {
+    static const std::vector<FmaPeakKernel> empty;
+    return empty;
+}
+
+#endif // __AVX2__ && __FMA__
@@ -0,0 +1,55 @@
+#include "roofline_backends.h"
+
+// 本文件用 -mavx512f 单独编译
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+namespace {
+
+// 12 个 zmm 累加器：两个 FMA 端口 × 4 周期延迟至少需要 8 个独立链，多留一些余量
+double fma_peak_avx512(uint64_t iterations, float* sink) {
+    const __m512 m = _mm512_set1_ps(0.999999f);
+    const __m512 c = _mm512_set1_ps(1e-6f);
+    __m512 a0 = _mm512_set1_ps(0.1f), a1 = _mm512_set1_ps(0.2f), a2 = _mm512_set1_ps(0.3f);
+    __m512 a3 = _mm512_set1_ps(0.4f), a4 = _mm512_set1_ps(0.5f), a5 = _mm512_set1_ps(0.6f);
+    __m512 a6 = _mm512_set1_ps(0.7f), a7 = _mm512_set1_ps(0.8f), a8 = _mm512_set1_ps(0.9f);
+    __m512 a9 = _mm512_set1_ps(1.1f), a10 = _mm512_set1_ps(1.2f), a11 = _mm512_set1_ps(1.3f);
+    for (uint64_t i = 0; i < iterations; ++i) {
+        a0 = _mm512_fmadd_ps(a0, m, c);
+        a1 = _mm512_fmadd_ps(a1, m, c);
+        a2 = _mm512_fmadd_ps(a2, m, c);
+        a3 = _mm512_fmadd_ps(a3, m, c);
+        a4 = _mm512_fmadd_ps(a4, m, c);
+        a5 = _mm512_fmadd_ps(a5, m, c);
+        a6 = _mm512_fmadd_ps(a6, m, c);
+        a7 = _mm512_fmadd_ps(a7, m, c);
+        a8 = _mm512_fmadd_ps(a8, m, c);
+        a9 = _mm512_fmadd_ps(a9, m, c);
+        a10 = _mm512_fmadd_ps(a10, m, c);
+        a11 = _mm512_fmadd_ps(a11, m, c);
+    }
+    __m512 s = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(a0, a1), _mm512_add_ps(a2, a3)),
+                             _mm512_add_ps(_mm512_add_ps(a4, a5), _mm512_add_ps(a6, a7)));
+    s = _mm512_add_ps(s, _mm512_add_ps(_mm512_add_ps(a8, a9), _mm512_add_ps(a10, a11)));
+    *sink = _mm512_reduce_add_ps(s);
+    return 2.0 * 12 * 16 * static_cast<double>(iterations);
+}
+
+} // namespace
+
+const std::vector<FmaPeakKernel>& avx512_fma_peak_table() {
+    static const std::vector<FmaPeakKernel> table = {
+        {"fma_avx512", "avx512", 512, "12 independent vfmadd chains on zmm registers", fma_peak_avx512},
+    };
+    return table;
+}
+
+#else
+
+const std::vector<FmaPeakKernel>& avx512_fma_peak_table() {
+    static const std::vector<FmaPeakKernel> empty;
+    return empty;
+}
+
+#endif // __AVX512F__
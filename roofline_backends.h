@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+
+#include "roofline.h"
+
+// 峰值 FMA 各后端的内核表；约定同 saxpy_backends.h：
+// 每个表定义在对应 ISA 的翻译单元里，只能在 cpu_features() 确认 CPU 支持后才能调用。
+const std::vector<FmaPeakKernel>& sve_fma_peak_table();
+const std::vector<FmaPeakKernel>& avx512_fma_peak_table();
+const std::vector<FmaPeakKernel>& avx2_fma_peak_table();
+const std::vector<FmaPeakKernel>& neon_fma_peak_table();
@@ -0,0 +1,60 @@
+#include "roofline_backends.h"
+
+// AArch64 基线指令集即包含 NEON(ASIMD)，本文件不需要额外的编译选项
+#if defined(__aarch64__)
+
+#include <arm_neon.h>
+
+namespace {
+
+// 16 个 q 寄存器累加器：常见核心有 2-4 个 128-bit FMA 管线、延迟 4 周期，至少需要 16 个独立链
+double fma_peak_neon(uint64_t iterations, float* sink) {
+    const float32x4_t m = vdupq_n_f32(0.999999f);
+    const float32x4_t c = vdupq_n_f32(1e-6f);
+    float32x4_t a0 = vdupq_n_f32(0.1f), a1 = vdupq_n_f32(0.2f), a2 = vdupq_n_f32(0.3f), a3 = vdupq_n_f32(0.4f);
+    float32x4_t a4 = vdupq_n_f32(0.5f), a5 = vdupq_n_f32(0.6f), a6 = vdupq_n_f32(0.7f), a7 = vdupq_n_f32(0.8f);
+    float32x4_t a8 = vdupq_n_f32(0.9f), a9 = vdupq_n_f32(1.1f), a10 = vdupq_n_f32(1.2f), a11 = vdupq_n_f32(1.3f);
+    float32x4_t a12 = vdupq_n_f32(1.4f), a13 = vdupq_n_f32(1.5f), a14 = vdupq_n_f32(1.6f), a15 = vdupq_n_f32(1.7f);
+    for (uint64_t i = 0; i < iterations; ++i) {
+        a0 = vfmaq_f32(c, a0, m);
+        a1 = vfmaq_f32(c, a1, m);
+        a2 = vfmaq_f32(c, a2, m);
+        a3 = vfmaq_f32(c, a3, m);
+        a4 = vfmaq_f32(c, a4, m);
+        a5 = vfmaq_f32(c, a5, m);
+        a6 = vfmaq_f32(c, a6, m);
+        a7 = vfmaq_f32(c, a7, m);
+        a8 = vfmaq_f32(c, a8, m);
+        a9 = vfmaq_f32(c, a9, m);
+        a10 = vfmaq_f32(c, a10, m);
+        a11 = vfmaq_f32(c, a11, m);
+        a12 = vfmaq_f32(c, a12, m);
+        a13 = vfmaq_f32(c, a13, m);
+        a14 = vfmaq_f32(c, a14, m);
+        a15 = vfmaq_f32(c, a15, m);
+    }
+    float32x4_t s = vaddq_f32(vaddq_f32(vaddq_f32(a0, a1), vaddq_f32(a2, a3)),
+                              vaddq_f32(vaddq_f32(a4, a5), vaddq_f32(a6, a7)));
+    s = vaddq_f32(s, vaddq_f32(vaddq_f32(vaddq_f32(a8, a9), vaddq_f32(a10, a11)),
+                               vaddq_f32(vaddq_f32(a12, a13), vaddq_f32(a14, a15))));
+    *sink = vaddvq_f32(s);
+    return 2.0 * 16 * 4 * static_cast<double>(iterations);
+}
+
+} // namespace
+
+const std::vector<FmaPeakKernel>& neon_fma_peak_table() {
+    static const std::vector<FmaPeakKernel> table = {
+        {"fma_neon", "neon", 128, "16 independent vfmaq_f32 chains on q registers", fma_peak_neon},
+    };
+    return table;
+}
+
+#else
+
+const std::vector<FmaPeakKernel>& neon_fma_peak_table() {
+    static const std::vector<FmaPeakKernel> empty;
+    return empty;
+}
+
+#endif // __aarch64__
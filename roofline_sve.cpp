@@ -0,0 +1,62 @@
+#include "roofline_backends.h"
+
+// 本文件用 -march=armv8.2-a+sve 单独编译
+#if defined(__ARM_FEATURE_SVE)
+
+#include <arm_sve.h>
+
+namespace {
+
+// 16 个 z 寄存器累加器：Neoverse N2 / V2 有 4 个 128-bit FMA 管线、延迟 4 周期，需要 16 个独立链
+double fma_peak_sve(uint64_t iterations, float* sink) {
+    const svbool_t pg = svptrue_b32();
+    const svfloat32_t m = svdup_f32(0.999999f);
+    const svfloat32_t c = svdup_f32(1e-6f);
+    svfloat32_t a0 = svdup_f32(0.1f), a1 = svdup_f32(0.2f), a2 = svdup_f32(0.3f), a3 = svdup_f32(0.4f);
+    svfloat32_t a4 = svdup_f32(0.5f), a5 = svdup_f32(0.6f), a6 = svdup_f32(0.7f), a7 = svdup_f32(0.8f);
+    svfloat32_t a8 = svdup_f32(0.9f), a9 = svdup_f32(1.1f), a10 = svdup_f32(1.2f), a11 = svdup_f32(1.3f);
+    svfloat32_t a12 = svdup_f32(1.4f), a13 = svdup_f32(1.5f), a14 = svdup_f32(1.6f), a15 = svdup_f32(1.7f);
+    for (uint64_t i = 0; i < iterations; ++i) {
+        // svmad: a = a * m + c
+        a0 = svmad_f32_x(pg, a0, m, c);
+        a1 = svmad_f32_x(pg, a1, m, c);
+        a2 = svmad_f32_x(pg, a2, m, c);
+        a3 = svmad_f32_x(pg, a3, m, c);
+        a4 = svmad_f32_x(pg, a4, m, c);
+        a5 = svmad_f32_x(pg, a5, m, c);
+        a6 = svmad_f32_x(pg, a6, m, c);
+        a7 = svmad_f32_x(pg, a7, m, c);
+        a8 = svmad_f32_x(pg, a8, m, c);
+        a9 = svmad_f32_x(pg, a9, m, c);
+        a10 = svmad_f32_x(pg, a10, m, c);
+        a11 = svmad_f32_x(pg, a11, m, c);
+        a12 = svmad_f32_x(pg, a12, m, c);
+        a13 = svmad_f32_x(pg, a13, m, c);
+        a14 = svmad_f32_x(pg, a14, m, c);
+        a15 = svmad_f32_x(pg, a15, m, c);
+    }
+    svfloat32_t s0 = svadd_f32_x(pg, svadd_f32_x(pg, a0, a1), svadd_f32_x(pg, a2, a3));
+    svfloat32_t s1 = svadd_f32_x(pg, svadd_f32_x(pg, a4, a5), svadd_f32_x(pg, a6, a7));
+    svfloat32_t s2 = svadd_f32_x(pg, svadd_f32_x(pg, a8, a9), svadd_f32_x(pg, a10, a11));
+    svfloat32_t s3 = svadd_f32_x(pg, svadd_f32_x(pg, a12, a13), svadd_f32_x(pg, a14, a15));
+    *sink = svaddv_f32(pg, svadd_f32_x(pg, svadd_f32_x(pg, s0, s1), svadd_f32_x(pg, s2, s3)));
+    return 2.0 * 16 * static_cast<double>(svcntw()) * static_cast<double>(iterations);
+}
+
+} // namespace
+
+const std::vector<FmaPeakKernel>& sve_fma_peak_table() {
+    static const std::vector<FmaPeakKernel> table = {
+        {"fma_sve", "sve", 0, "16 independent svmad chains, one per z register", fma_peak_sve},
+    };
+    return table;
+}
+
+#else
+
+const std::vector<FmaPeakKernel>& sve_fma_peak_table() {
+    static const std::vector<FmaPeakKernel> empty;
+    return empty;
+}
+
+#endif // __ARM_FEATURE_SVE
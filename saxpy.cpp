@@ -0,0 +1,183 @@
+#include "saxpy.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "cpu_features.h"
+#include "saxpy_backends.h"
+
+namespace {
+
+struct BackendEntry {
+    SaxpyBackend backend;
+    const std::vector<SaxpyKernel>* kernels;
+};
+
+// 按优先级收集本机可用且编译进来的后端
+std::vector<BackendEntry> detect_backends() {
+    const CpuFeatures& cpu = cpu_features();
+    std::vector<BackendEntry> entries;
+    auto add = [&entries](const char* name, unsigned bits, const std::vector<SaxpyKernel>& table) {
+        if (!table.empty()) {
+            entries.push_back({{name, bits}, &table});
+        }
+    };
+    if (cpu.sve) {
+        const unsigned vl_bits = cpu.sve_vector_bytes * 8;
+        add("sve", vl_bits, sve_kernel_table());
+        // 定长内核假定 svcntw() 是编译期常量，VL 不一致时结果错误，所以只注册宽度匹配的那一个
+        switch (vl_bits) {
+            case 128: add("sve128", 128, sve128_kernel_table()); break;
+            case 256: add("sve256", 256, sve256_kernel_table()); break;
+            case 512: add("sve512", 512, sve512_kernel_table()); break;
+            default: break;
+        }
+    }
+    if (cpu.avx512f) {
+        add("avx512", 512, avx512_kernel_table());
+    }
+    if (cpu.avx2) {
+        add("avx2", 256, avx2_kernel_table());
+    }
+    if (cpu.neon) {
+        add("neon", 128, neon_kernel_table());
+    }
+    add("autovec", autovec_vector_bits(), autovec_kernel_table());
+    add("scalar", 32, scalar_kernel_table());
+    return entries;
+}
+
+// 逐元素的带步长版本：没有 gather / scatter 或步长超出 32 位下标范围时使用
+void saxpy_strided_generic(float a, const float* x, ptrdiff_t incx, float* y, ptrdiff_t incy, uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+        float& yi = y[static_cast<ptrdiff_t>(i) * incy];
+        yi = a * x[static_cast<ptrdiff_t>(i) * incx] + yi;
+    }
+}
+
+// 快速路径使用的函数指针，第一次调用时按 CPU 选定
+struct FastPath {
+    SaxpyFn contiguous;
+    SaxpyGatherFn strided;
+};
+
+const FastPath& fast_path() {
+    static const FastPath path = [] {
+        const CpuFeatures& cpu = cpu_features();
+        FastPath p{saxpy_kernels().front().fn, nullptr};
+        if (cpu.sve) {
+            p.strided = sve_gather_kernel();
+        }
+        if (p.strided == nullptr && cpu.avx512f) {
+            p.strided = avx512_gather_kernel();
+        }
+        return p;
+    }();
+    return path;
+}
+
+const std::vector<BackendEntry>& backend_entries() {
+    static const std::vector<BackendEntry> entries = detect_backends();
+    return entries;
+}
+
+} // namespace
+
+const std::vector<SaxpyBackend>& saxpy_backends() {
+    static const std::vector<SaxpyBackend> backends = [] {
+        std::vector<SaxpyBackend> out;
+        for (const BackendEntry& entry : backend_entries()) {
+            out.push_back(entry.backend);
+        }
+        return out;
+    }();
+    return backends;
+}
+
+const SaxpyBackend* find_saxpy_backend(const std::string& name) {
+    for (const SaxpyBackend& backend : saxpy_backends()) {
+        if (name == backend.name) {
+            return &backend;
+        }
+    }
+    return nullptr;
+}
+
+const std::vector<SaxpyKernel>& saxpy_kernels() {
+    static const std::vector<SaxpyKernel> kernels = [] {
+        std::vector<SaxpyKernel> out;
+        for (const BackendEntry& entry : backend_entries()) {
+            out.insert(out.end(), entry.kernels->begin(), entry.kernels->end());
+        }
+        return out;
+    }();
+    return kernels;
+}
+
+const SaxpyKernel* find_saxpy_kernel(const std::string& name) {
+    for (const SaxpyKernel& kernel : saxpy_kernels()) {
+        if (name == kernel.name) {
+            return &kernel;
+        }
+    }
+    return nullptr;
+}
+
+void saxpy(float a, const float* x, float* y, uint64_t n) noexcept {
+    fast_path().contiguous(a, x, y, y, n);
+}
+
+void saxpy(float a, const float* x, const float* y_in, float* y_out, uint64_t n) noexcept {
+    fast_path().contiguous(a, x, y_in, y_out, n);
+}
+
+void saxpy_strided(float a, const float* x, ptrdiff_t incx, float* y, ptrdiff_t incy, uint64_t n) noexcept {
+    if (incx == 1 && incy == 1) {
+        fast_path().contiguous(a, x, y, y, n);
+        return;
+    }
+    const SaxpyGatherFn gather = fast_path().strided;
+    const bool fits = incx >= -MAX_GATHER_STRIDE && incx <= MAX_GATHER_STRIDE &&
+                      incy >= -MAX_GATHER_STRIDE && incy <= MAX_GATHER_STRIDE;
+    (gather && fits ? gather : saxpy_strided_generic)(a, x, incx, y, incy, n);
+}
+
+const SaxpyKernel& auto_saxpy_kernel(size_t footprint_bytes, size_t llc_bytes) {
+    if (llc_bytes > 0 && footprint_bytes > llc_bytes) {
+        for (const SaxpyKernel& kernel : saxpy_kernels()) {
+            if (kernel.non_temporal) {
+                return kernel;
+            }
+        }
+    }
+    return saxpy_kernels().front();
+}
+
+std::vector<const SaxpyKernel*> parse_kernel_list(const std::string& list) {
+    std::vector<const SaxpyKernel*> selected;
+    if (list == "all") {
+        for (const SaxpyKernel& kernel : saxpy_kernels()) {
+            selected.push_back(&kernel);
+        }
+        return selected;
+    }
+
+    std::stringstream ss(list);
+    std::string name;
+    while (std::getline(ss, name, ',')) {
+        const SaxpyKernel* kernel = find_saxpy_kernel(name);
+        if (kernel == nullptr) {
+            std::string known;
+            for (const SaxpyKernel& k : saxpy_kernels()) {
+                known += known.empty() ? k.name : std::string(", ") + k.name;
+            }
+            throw std::runtime_error("Unknown or unsupported kernel '" + name +
+                                     "' (available on this CPU: " + known + ", all)");
+        }
+        selected.push_back(kernel);
+    }
+    if (selected.empty()) {
+        throw std::runtime_error("Kernel list must not be empty.");
+    }
+    return selected;
+}
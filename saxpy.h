@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__aarch64__)
+/**
+ * @brief SAXPY 的指针版本，只处理 [x, x + n) 这一段
+ *
+ * 多线程模式下每个线程对自己的数据块调用这个函数。
+ * 仅在支持 SVE 的 CPU 上可以调用（见 cpu_features()）。
+ */
+void sve_saxpy_range(float a, const float* x_ptr, float* y_ptr, uint64_t n);
+
+/**
+ * @brief 非原地 SAXPY：Y_out = a * X + Y_in
+ *
+ * 双缓冲测量模式使用：Y_in 保持不变，结果写入另一块缓冲区，
+ * 因此每次迭代前不再需要把 Y 恢复成初始值。
+ */
+void sve_saxpy_out_range(float a, const float* x_ptr, const float* y_in, float* y_out, uint64_t n);
+
+/**
+ * @brief 使用 SVE 指令执行 SAXPY 操作 (Y = a * X + Y)
+ *
+ * 只接受 std::vector；数据在 mmap 缓冲区或内存池里时请用不需要拷贝的 saxpy(a, x, y) 视图版本。
+ * 
+ * @param a 标量乘数
+ * @param x 输入向量 X
+ * @param y 输入/输出向量 Y
+ */
+void sve_saxpy(float a, const std::vector<float>& x, std::vector<float>& y);
+#endif
+
+/**
+ * @brief 统一的内核签名：Y_out = a * X + Y_in
+ *
+ * 原地计算时 y_in 与 y_out 指向同一块内存。
+ */
+using SaxpyFn = void (*)(float a, const float* x, const float* y_in, float* y_out, uint64_t n);
+
+/**
+ * @brief 一个可在运行时按名字选择的 SAXPY 内核
+ */
+struct SaxpyKernel {
+    const char* name;
+    const char* backend;     // 所属后端，例如 "sve"、"neon"、"avx2"
+    const char* description;
+    SaxpyFn fn;
+    bool non_temporal = false; // 流式（non-temporal）存储：写 Y 不经过缓存，也不产生写分配读
+};
+
+/**
+ * @brief 一个指令集后端
+ */
+struct SaxpyBackend {
+    const char* name;
+    unsigned vector_bits;    // 向量寄存器宽度；scalar 为 32
+};
+
+/**
+ * @brief 本机可用的后端，按优先级从高到低排列
+ *
+ * 顺序为 sve > sve<N> > avx512 > avx2 > neon > autovec > scalar，
+ * 编译进来但 CPU 不支持的后端不会出现在这里；定长的 sve<N>（N = 128 / 256 / 512）
+ * 只在硬件 VL 恰好等于 N 时出现，默认内核仍是可变长度的 sve。
+ */
+const std::vector<SaxpyBackend>& saxpy_backends();
+
+/**
+ * @brief 按名字查找本机可用的后端，找不到时返回 nullptr
+ */
+const SaxpyBackend* find_saxpy_backend(const std::string& name);
+
+/**
+ * @brief 本机可用的所有内核，按后端优先级排列；第一个是默认内核
+ */
+const std::vector<SaxpyKernel>& saxpy_kernels();
+
+/**
+ * @brief 按名字查找内核，找不到或本机不支持时返回 nullptr
+ */
+const SaxpyKernel* find_saxpy_kernel(const std::string& name);
+
+/**
+ * @brief 按工作集大小自动选择内核
+ *
+ * 工作集超过末级缓存（llc_bytes > 0）时，普通存储会先把 Y 的缓存行读进来再写回，
+ * 且把 X / Y 挤出缓存也没有意义；此时选择优先级最高的流式存储内核。
+ * 否则（或没有流式内核时）返回默认内核。
+ */
+const SaxpyKernel& auto_saxpy_kernel(size_t footprint_bytes, size_t llc_bytes);
+
+/**
+ * @brief 解析逗号分隔的内核列表；"all" 表示本机可用的全部内核
+ *
+ * 遇到未知名字时抛出 std::runtime_error。
+ */
+std::vector<const SaxpyKernel*> parse_kernel_list(const std::string& list);
+
+/**
+ * @brief 不拥有内存的一维 float 视图（C++17 没有 std::span），可以带步长
+ *
+ * 第 i 个元素位于 data[i * stride]；stride 以元素为单位，可以为负（从 data 向低地址走）。
+ * 可以从指针 + 长度 + 步长，或任何有 data() / size() 的连续容器构造，不拷贝数据。
+ */
+template <typename T>
+struct StridedSpan {
+    T* data = nullptr;
+    size_t size = 0;
+    ptrdiff_t stride = 1;
+
+    StridedSpan() = default;
+    StridedSpan(T* ptr, size_t n, ptrdiff_t step = 1) : data(ptr), size(n), stride(step) {}
+
+    // std::vector、std::array 等连续容器
+    template <typename Container,
+              typename = std::enable_if_t<std::is_convertible<decltype(std::declval<Container&>().data()), T*>::value>>
+    StridedSpan(Container& c) : data(c.data()), size(c.size()) {}
+
+    // float 视图可以当作 const float 视图使用
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+    StridedSpan(const StridedSpan<U>& other) : data(other.data), size(other.size), stride(other.stride) {}
+
+    bool contiguous() const { return stride == 1; }
+};
+
+using FloatSpan = StridedSpan<float>;
+using ConstFloatSpan = StridedSpan<const float>;
+
+/**
+ * @brief 快速路径：y[0, n) = a * x[0, n) + y[0, n)，使用本机默认内核
+ *
+ * 不检查参数、不抛异常、不分配内存；x 与 y 要么完全不重叠，要么是同一个指针。
+ * 内核在第一次调用时选定，之后每次调用只是一次间接调用。
+ */
+void saxpy(float a, const float* x, float* y, uint64_t n) noexcept;
+
+/**
+ * @brief 非原地快速路径：y_out = a * x + y_in，约定同上
+ */
+void saxpy(float a, const float* x, const float* y_in, float* y_out, uint64_t n) noexcept;
+
+/**
+ * @brief 带步长的快速路径：y[i * incy] = a * x[i * incx] + y[i * incy]，i < n
+ *
+ * 步长为 1 时与 saxpy(a, x, y, n) 相同；其他步长在 SVE / AVX-512 上用 gather / scatter，
+ * 否则逐元素计算。incy 不能为 0；不检查参数、不抛异常。
+ */
+void saxpy_strided(float a, const float* x, ptrdiff_t incx, float* y, ptrdiff_t incy, uint64_t n) noexcept;
+
+/**
+ * @brief 检查过的视图版本：长度不同或 y 的步长为 0 时抛出 std::runtime_error
+ *
+ * 检查只在入口做一次，之后直接进入上面的快速路径。
+ */
+inline void saxpy(float a, ConstFloatSpan x, FloatSpan y) {
+    if (x.size != y.size) {
+        throw std::runtime_error("Vector sizes must be equal.");
+    }
+    if (y.stride == 0) {
+        throw std::runtime_error("Output stride must not be zero.");
+    }
+    if (x.contiguous() && y.contiguous()) {
+        saxpy(a, x.data, y.data, y.size);
+    } else {
+        saxpy_strided(a, x.data, x.stride, y.data, y.stride, y.size);
+    }
+}
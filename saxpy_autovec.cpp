@@ -0,0 +1,35 @@
+#include "saxpy_backends.h"
+
+// 本文件用 -O3 -ftree-vectorize 编译，向量宽度由全局的 -march 决定。
+// y_in 和 y_out 在原地模式下相同，所以不能加 __restrict；编译器会生成运行时别名检查。
+
+namespace {
+
+void saxpy_autovec(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+        y_out[i] = a * x[i] + y_in[i];
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyKernel>& autovec_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels = {
+        {"autovec", "autovec", "plain C++ loop, compiler auto-vectorized", saxpy_autovec},
+    };
+    return kernels;
+}
+
+unsigned autovec_vector_bits() {
+#if defined(__AVX512F__)
+    return 512;
+#elif defined(__AVX__)
+    return 256;
+#elif defined(__ARM_FEATURE_SVE_BITS) && __ARM_FEATURE_SVE_BITS > 0
+    return __ARM_FEATURE_SVE_BITS;
+#elif defined(__ARM_FEATURE_SVE)
+    return 0; // 可变长度，由运行时的 VL 决定
+#else
+    return 128; // SSE2 / NEON 基线
+#endif
+}
@@ -0,0 +1,53 @@
+#include "saxpy_backends.h"
+
+// 本文件用 -mavx2 -mfma 单独编译
+#if defined(__AVX2__) && defined(__FMA__)
+
+#include <immintrin.h>
+
+namespace {
+
+// 4 倍展开的 256-bit FMA；尾部用 maskload/maskstore，和 SVE 版本一样只有一段带掩码的收尾
+void saxpy_avx2(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    const __m256 va = _mm256_set1_ps(a);
+    uint64_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256 r0 = _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i),      _mm256_loadu_ps(y_in + i));
+        __m256 r1 = _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i + 8),  _mm256_loadu_ps(y_in + i + 8));
+        __m256 r2 = _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(y_in + i + 16));
+        __m256 r3 = _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(y_in + i + 24));
+        _mm256_storeu_ps(y_out + i,      r0);
+        _mm256_storeu_ps(y_out + i + 8,  r1);
+        _mm256_storeu_ps(y_out + i + 16, r2);
+        _mm256_storeu_ps(y_out + i + 24, r3);
+    }
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y_out + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y_in + i)));
+    }
+    if (i < n) {
+        // 通道 lane 有效当且仅当 lane < n - i
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(n - i)), lanes);
+        __m256 vx = _mm256_maskload_ps(x + i, mask);
+        __m256 vy = _mm256_maskload_ps(y_in + i, mask);
+        _mm256_maskstore_ps(y_out + i, mask, _mm256_fmadd_ps(va, vx, vy));
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyKernel>& avx2_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels = {
+        {"avx2", "avx2", "4x unrolled 256-bit FMA + masked tail", saxpy_avx2},
+    };
+    return kernels;
+}
+
+#else
+
+const std::vector<SaxpyKernel>& avx2_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels;
+    return kernels;
+}
+
+#endif // __AVX2__ && __FMA__
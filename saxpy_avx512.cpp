@@ -0,0 +1,122 @@
+#include "saxpy_backends.h"
+
+// 本文件用 -mavx512f 单独编译
+#if defined(__AVX512F__)
+
+#include <algorithm>
+#include <cstdint>
+
+#include <immintrin.h>
+
+namespace {
+
+// 4 倍展开的 512-bit FMA；尾部用 __mmask16 掩码加载/存储
+void saxpy_avx512(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    const __m512 va = _mm512_set1_ps(a);
+    uint64_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m512 r0 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i),      _mm512_loadu_ps(y_in + i));
+        __m512 r1 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y_in + i + 16));
+        __m512 r2 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(y_in + i + 32));
+        __m512 r3 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(y_in + i + 48));
+        _mm512_storeu_ps(y_out + i,      r0);
+        _mm512_storeu_ps(y_out + i + 16, r1);
+        _mm512_storeu_ps(y_out + i + 32, r2);
+        _mm512_storeu_ps(y_out + i + 48, r3);
+    }
+    for (; i < n; i += 16) {
+        uint64_t left = n - i;
+        __mmask16 m = left >= 16 ? static_cast<__mmask16>(0xFFFF)
+                                 : static_cast<__mmask16>((1u << left) - 1);
+        __m512 vx = _mm512_maskz_loadu_ps(m, x + i);
+        __m512 vy = _mm512_maskz_loadu_ps(m, y_in + i);
+        _mm512_mask_storeu_ps(y_out + i, m, _mm512_fmadd_ps(va, vx, vy));
+    }
+}
+
+// 流式存储版本：先用掩码存储把 y_out 推进到 64 字节边界，主体用 _mm512_stream_ps
+// 绕过缓存整行写入（不产生写分配读），最后的 sfence 保证流式存储在返回前全局可见。
+// 原地计算时 y_in 的行已经读入缓存，流式写会把它们逐出，对下一次调用同样有利
+void saxpy_avx512_nt(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    const __m512 va = _mm512_set1_ps(a);
+    uint64_t i = 0;
+    const uint64_t misaligned = (reinterpret_cast<uintptr_t>(y_out) & 63) / sizeof(float);
+    if (misaligned != 0) {
+        uint64_t head = std::min<uint64_t>(16 - misaligned, n);
+        __mmask16 m = static_cast<__mmask16>((1u << head) - 1);
+        __m512 vx = _mm512_maskz_loadu_ps(m, x);
+        __m512 vy = _mm512_maskz_loadu_ps(m, y_in);
+        _mm512_mask_storeu_ps(y_out, m, _mm512_fmadd_ps(va, vx, vy));
+        i = head;
+    }
+    for (; i + 64 <= n; i += 64) {
+        __m512 r0 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i),      _mm512_loadu_ps(y_in + i));
+        __m512 r1 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y_in + i + 16));
+        __m512 r2 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(y_in + i + 32));
+        __m512 r3 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(y_in + i + 48));
+        _mm512_stream_ps(y_out + i,      r0);
+        _mm512_stream_ps(y_out + i + 16, r1);
+        _mm512_stream_ps(y_out + i + 32, r2);
+        _mm512_stream_ps(y_out + i + 48, r3);
+    }
+    for (; i < n; i += 16) {
+        uint64_t left = n - i;
+        __mmask16 m = left >= 16 ? static_cast<__mmask16>(0xFFFF)
+                                 : static_cast<__mmask16>((1u << left) - 1);
+        __m512 vx = _mm512_maskz_loadu_ps(m, x + i);
+        __m512 vy = _mm512_maskz_loadu_ps(m, y_in + i);
+        _mm512_mask_storeu_ps(y_out + i, m, _mm512_fmadd_ps(va, vx, vy));
+    }
+    _mm_sfence();
+}
+
+// 带步长：lane j 的下标是 j * inc，每 16 个元素把基址前移 16 * inc；尾部用掩码 gather / scatter
+void saxpy_gather_scatter(float a, const float* x, ptrdiff_t incx, float* y, ptrdiff_t incy, uint64_t n) {
+    const __m512i lanes = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m512i ix = _mm512_mullo_epi32(lanes, _mm512_set1_epi32(static_cast<int>(incx)));
+    const __m512i iy = _mm512_mullo_epi32(lanes, _mm512_set1_epi32(static_cast<int>(incy)));
+    const __m512 va = _mm512_set1_ps(a);
+    uint64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const float* xb = x + static_cast<ptrdiff_t>(i) * incx;
+        float* yb = y + static_cast<ptrdiff_t>(i) * incy;
+        __m512 vx = _mm512_i32gather_ps(ix, xb, sizeof(float));
+        __m512 vy = _mm512_i32gather_ps(iy, yb, sizeof(float));
+        _mm512_i32scatter_ps(yb, iy, _mm512_fmadd_ps(va, vx, vy), sizeof(float));
+    }
+    if (i < n) {
+        const __mmask16 m = static_cast<__mmask16>((1u << (n - i)) - 1);
+        const float* xb = x + static_cast<ptrdiff_t>(i) * incx;
+        float* yb = y + static_cast<ptrdiff_t>(i) * incy;
+        __m512 vx = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, ix, xb, sizeof(float));
+        __m512 vy = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, iy, yb, sizeof(float));
+        _mm512_mask_i32scatter_ps(yb, m, iy, _mm512_fmadd_ps(va, vx, vy), sizeof(float));
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyKernel>& avx512_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels = {
+        {"avx512",    "avx512", "4x unrolled 512-bit FMA + masked tail",             saxpy_avx512},
+        {"avx512_nt", "avx512", "4x unrolled FMA, streaming (non-temporal) stores", saxpy_avx512_nt, true},
+    };
+    return kernels;
+}
+
+SaxpyGatherFn avx512_gather_kernel() {
+    return saxpy_gather_scatter;
+}
+
+#else
+
+const std::vector<SaxpyKernel>& avx512_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels;
+    return kernels;
+}
+
+SaxpyGatherFn avx512_gather_kernel() {
+    return nullptr;
+}
+
+#endif // __AVX512F__
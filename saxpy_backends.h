@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "saxpy.h"
+
+// 各后端的内核表。每个表定义在对应 ISA 的翻译单元里，该文件用单独的 -m 选项编译；
+// 目标架构或编译器不支持时，表为空。
+// 注意：只能在 cpu_features() 确认 CPU 支持后才能调用，
+// 否则表的静态初始化本身就可能执行该 ISA 的指令。
+const std::vector<SaxpyKernel>& sve_kernel_table();
+// 定长 SVE（saxpy_sve_vls.cpp 按 -msve-vector-bits=N 编译）；只能在硬件 VL 恰好为 N 时调用
+const std::vector<SaxpyKernel>& sve128_kernel_table();
+const std::vector<SaxpyKernel>& sve256_kernel_table();
+const std::vector<SaxpyKernel>& sve512_kernel_table();
+const std::vector<SaxpyKernel>& avx512_kernel_table();
+const std::vector<SaxpyKernel>& avx2_kernel_table();
+const std::vector<SaxpyKernel>& neon_kernel_table();
+const std::vector<SaxpyKernel>& autovec_kernel_table();
+const std::vector<SaxpyKernel>& scalar_kernel_table();
+
+// 带步长的 SAXPY：y[i * incy] = a * x[i * incx] + y[i * incy]。
+// 用 gather / scatter 实现，lane 偏移是 32 位下标，|inc| 超过 MAX_GATHER_STRIDE 时不能使用；
+// 没有编译进来时返回 nullptr
+using SaxpyGatherFn = void (*)(float a, const float* x, ptrdiff_t incx, float* y, ptrdiff_t incy, uint64_t n);
+constexpr ptrdiff_t MAX_GATHER_STRIDE = INT32_MAX / 64;   // 向量最多 64 个 lane（2048-bit SVE）
+SaxpyGatherFn sve_gather_kernel();
+SaxpyGatherFn avx512_gather_kernel();
+
+// 自动向量化后端的实际向量宽度，取决于编译选项
+unsigned autovec_vector_bits();
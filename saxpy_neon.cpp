@@ -0,0 +1,51 @@
+#include "saxpy_backends.h"
+
+// AArch64 基线指令集即包含 NEON(ASIMD)，本文件不需要额外的编译选项
+#if defined(__aarch64__)
+
+#include <arm_neon.h>
+
+namespace {
+
+// 4 倍展开的 float32x4 FMA；NEON 没有谓词，尾部逐元素处理
+void saxpy_neon(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    uint64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        float32x4_t x0 = vld1q_f32(x + i);
+        float32x4_t x1 = vld1q_f32(x + i + 4);
+        float32x4_t x2 = vld1q_f32(x + i + 8);
+        float32x4_t x3 = vld1q_f32(x + i + 12);
+        float32x4_t y0 = vld1q_f32(y_in + i);
+        float32x4_t y1 = vld1q_f32(y_in + i + 4);
+        float32x4_t y2 = vld1q_f32(y_in + i + 8);
+        float32x4_t y3 = vld1q_f32(y_in + i + 12);
+        vst1q_f32(y_out + i,      vfmaq_n_f32(y0, x0, a));
+        vst1q_f32(y_out + i + 4,  vfmaq_n_f32(y1, x1, a));
+        vst1q_f32(y_out + i + 8,  vfmaq_n_f32(y2, x2, a));
+        vst1q_f32(y_out + i + 12, vfmaq_n_f32(y3, x3, a));
+    }
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(y_out + i, vfmaq_n_f32(vld1q_f32(y_in + i), vld1q_f32(x + i), a));
+    }
+    for (; i < n; ++i) {
+        y_out[i] = __builtin_fmaf(a, x[i], y_in[i]);
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyKernel>& neon_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels = {
+        {"neon", "neon", "4x unrolled float32x4 vfmaq + scalar tail", saxpy_neon},
+    };
+    return kernels;
+}
+
+#else
+
+const std::vector<SaxpyKernel>& neon_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels;
+    return kernels;
+}
+
+#endif // __aarch64__
@@ -0,0 +1,21 @@
+#include "saxpy_backends.h"
+
+// 本文件用 -fno-tree-vectorize 编译：作为任何 CPU 上都能运行的参考实现，
+// 也是衡量向量化收益的基准。
+
+namespace {
+
+void saxpy_scalar(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+        y_out[i] = a * x[i] + y_in[i];
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyKernel>& scalar_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels = {
+        {"scalar", "scalar", "plain C++ loop, vectorization disabled", saxpy_scalar},
+    };
+    return kernels;
+}
@@ -0,0 +1,228 @@
+#include "saxpy_backends.h"
+
+// 本文件用 -march=...+sve 单独编译；编译器不支持 SVE 时整个后端为空
+#if defined(__ARM_FEATURE_SVE)
+
+#include <stdexcept>
+
+// 必须包含此头文件以使用 SVE 内联函数
+#include <arm_sve.h>
+
+void sve_saxpy_range(float a, const float* x_ptr, float* y_ptr, uint64_t n) {
+    // SVE 的循环方式：
+    // 使用一个谓词(predicate)来处理可能不是向量长度整数倍的数组尾部
+    for (uint64_t i = 0; i < n; ) {
+        // svwhilelt_b32: 创建一个谓词(pg)，对于 i+lane < n 的通道(lane)为 true
+        // 这有效地为循环的最后一次迭代创建了一个掩码
+        svbool_t pg = svwhilelt_b32(i, n);
+        
+        // svld1: 根据谓词 pg 从内存加载数据到向量寄存器
+        svfloat32_t vec_x = svld1_f32(pg, x_ptr + i);
+        svfloat32_t vec_y = svld1_f32(pg, y_ptr + i);
+        
+        // svmad_f32_z: 核心计算！执行 "multiply-add" 操作。
+        // result = (a * vec_x) + vec_y
+        // _z 后缀表示 "zeroing"，即谓词为 false 的通道将被置为 0
+        svfloat32_t result = svmad_f32_z(pg, svdup_n_f32(a), vec_x, vec_y);
+        
+        // svst1: 根据谓词 pg 将结果写回内存
+        svst1_f32(pg, y_ptr + i, result);
+        
+        // svcntw(): 获取当前硬件上 SVE 向量寄存器可以容纳的 32-bit 元素数量。
+        // 这是 "Scalable" 的关键！代码无需硬编码向量宽度。
+        i += svcntw();
+    }
+}
+
+void sve_saxpy_out_range(float a, const float* x_ptr, const float* y_in, float* y_out, uint64_t n) {
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, n);
+        svfloat32_t vec_x = svld1_f32(pg, x_ptr + i);
+        svfloat32_t vec_y = svld1_f32(pg, y_in + i);
+        svst1_f32(pg, y_out + i, svmad_f32_z(pg, svdup_n_f32(a), vec_x, vec_y));
+    }
+}
+
+void sve_saxpy(float a, const std::vector<float>& x, std::vector<float>& y) {
+    // 确保向量大小相同
+    if (x.size() != y.size()) {
+        throw std::runtime_error("Vector sizes must be equal.");
+    }
+    
+    sve_saxpy_range(a, x.data(), y.data(), x.size());
+}
+
+namespace {
+
+// 预取提前量（字节）：大约是 DRAM 延迟内能流过的数据量
+constexpr uint64_t PREFETCH_AHEAD_BYTES = 2048;
+
+// 原始内核：与 sve_saxpy_range / sve_saxpy_out_range 完全相同
+void saxpy_baseline(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    if (y_in == y_out) {
+        sve_saxpy_range(a, x, y_out, n);
+    } else {
+        sve_saxpy_out_range(a, x, y_in, y_out, n);
+    }
+}
+
+// svmla 合并形式：非活动通道保留 Y 的值，不需要 _z 形式的清零，
+// 编译器可以直接生成破坏性的 FMLA 而不必插入 MOVPRFX
+void saxpy_mla(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, n);
+        svfloat32_t vec_x = svld1_f32(pg, x + i);
+        svfloat32_t vec_y = svld1_f32(pg, y_in + i);
+        svst1_f32(pg, y_out + i, svmla_n_f32_m(pg, vec_y, vec_x, a));
+    }
+}
+
+// 尾部：剩余不足一个展开步长的元素，用逐向量的 whilelt 谓词处理
+inline void saxpy_tail(svfloat32_t va, const float* x, const float* y_in, float* y_out,
+                       uint64_t i, uint64_t n) {
+    for (; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, n);
+        svfloat32_t vec_x = svld1_f32(pg, x + i);
+        svfloat32_t vec_y = svld1_f32(pg, y_in + i);
+        svst1_f32(pg, y_out + i, svmla_f32_m(pg, vec_y, vec_x, va));
+    }
+}
+
+// 2 倍展开：主体使用全真谓词，循环内没有 whilelt 依赖链
+void saxpy_unroll2(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    const uint64_t vl = svcntw();
+    const svbool_t all = svptrue_b32();
+    const svfloat32_t va = svdup_n_f32(a);
+    uint64_t i = 0;
+    for (; i + 2 * vl <= n; i += 2 * vl) {
+        svfloat32_t x0 = svld1_vnum_f32(all, x + i, 0);
+        svfloat32_t x1 = svld1_vnum_f32(all, x + i, 1);
+        svfloat32_t y0 = svld1_vnum_f32(all, y_in + i, 0);
+        svfloat32_t y1 = svld1_vnum_f32(all, y_in + i, 1);
+        svst1_vnum_f32(all, y_out + i, 0, svmla_f32_x(all, y0, x0, va));
+        svst1_vnum_f32(all, y_out + i, 1, svmla_f32_x(all, y1, x1, va));
+    }
+    saxpy_tail(va, x, y_in, y_out, i, n);
+}
+
+// 4 倍展开：四条独立的 FMA 链，足以覆盖大多数 Neoverse 核心的 FMA 延迟
+void saxpy_unroll4(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    const uint64_t vl = svcntw();
+    const svbool_t all = svptrue_b32();
+    const svfloat32_t va = svdup_n_f32(a);
+    uint64_t i = 0;
+    for (; i + 4 * vl <= n; i += 4 * vl) {
+        svfloat32_t x0 = svld1_vnum_f32(all, x + i, 0);
+        svfloat32_t x1 = svld1_vnum_f32(all, x + i, 1);
+        svfloat32_t x2 = svld1_vnum_f32(all, x + i, 2);
+        svfloat32_t x3 = svld1_vnum_f32(all, x + i, 3);
+        svfloat32_t y0 = svld1_vnum_f32(all, y_in + i, 0);
+        svfloat32_t y1 = svld1_vnum_f32(all, y_in + i, 1);
+        svfloat32_t y2 = svld1_vnum_f32(all, y_in + i, 2);
+        svfloat32_t y3 = svld1_vnum_f32(all, y_in + i, 3);
+        svst1_vnum_f32(all, y_out + i, 0, svmla_f32_x(all, y0, x0, va));
+        svst1_vnum_f32(all, y_out + i, 1, svmla_f32_x(all, y1, x1, va));
+        svst1_vnum_f32(all, y_out + i, 2, svmla_f32_x(all, y2, x2, va));
+        svst1_vnum_f32(all, y_out + i, 3, svmla_f32_x(all, y3, x3, va));
+    }
+    saxpy_tail(va, x, y_in, y_out, i, n);
+}
+
+// 4 倍展开 + 软件预取：每步对 X 和 Y 提前 PREFETCH_AHEAD_BYTES 发出 svprfw
+// （SVE 预取指令不会因越界地址而触发异常，所以末尾不需要特殊处理）
+void saxpy_prefetch(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    const uint64_t vl = svcntw();
+    const uint64_t ahead = PREFETCH_AHEAD_BYTES / sizeof(float);
+    const svbool_t all = svptrue_b32();
+    const svfloat32_t va = svdup_n_f32(a);
+    uint64_t i = 0;
+    for (; i + 4 * vl <= n; i += 4 * vl) {
+        svprfw(all, x + i + ahead, SV_PLDL1STRM);
+        svprfw(all, y_in + i + ahead, SV_PLDL1STRM);
+        svfloat32_t x0 = svld1_vnum_f32(all, x + i, 0);
+        svfloat32_t x1 = svld1_vnum_f32(all, x + i, 1);
+        svfloat32_t x2 = svld1_vnum_f32(all, x + i, 2);
+        svfloat32_t x3 = svld1_vnum_f32(all, x + i, 3);
+        svfloat32_t y0 = svld1_vnum_f32(all, y_in + i, 0);
+        svfloat32_t y1 = svld1_vnum_f32(all, y_in + i, 1);
+        svfloat32_t y2 = svld1_vnum_f32(all, y_in + i, 2);
+        svfloat32_t y3 = svld1_vnum_f32(all, y_in + i, 3);
+        svst1_vnum_f32(all, y_out + i, 0, svmla_f32_x(all, y0, x0, va));
+        svst1_vnum_f32(all, y_out + i, 1, svmla_f32_x(all, y1, x1, va));
+        svst1_vnum_f32(all, y_out + i, 2, svmla_f32_x(all, y2, x2, va));
+        svst1_vnum_f32(all, y_out + i, 3, svmla_f32_x(all, y3, x3, va));
+    }
+    saxpy_tail(va, x, y_in, y_out, i, n);
+}
+
+// 4 倍展开的 non-temporal 版本：svldnt1 / svstnt1 提示这些数据不会很快被复用，
+// 大于末级缓存的工作集上避免把 X / Y 留在缓存里、挤掉其他数据；
+// 尾部仍用普通的谓词访问，只占很小一部分
+void saxpy_stream(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    const uint64_t vl = svcntw();
+    const svbool_t all = svptrue_b32();
+    const svfloat32_t va = svdup_n_f32(a);
+    uint64_t i = 0;
+    for (; i + 4 * vl <= n; i += 4 * vl) {
+        svfloat32_t x0 = svldnt1_vnum_f32(all, x + i, 0);
+        svfloat32_t x1 = svldnt1_vnum_f32(all, x + i, 1);
+        svfloat32_t x2 = svldnt1_vnum_f32(all, x + i, 2);
+        svfloat32_t x3 = svldnt1_vnum_f32(all, x + i, 3);
+        svfloat32_t y0 = svldnt1_vnum_f32(all, y_in + i, 0);
+        svfloat32_t y1 = svldnt1_vnum_f32(all, y_in + i, 1);
+        svfloat32_t y2 = svldnt1_vnum_f32(all, y_in + i, 2);
+        svfloat32_t y3 = svldnt1_vnum_f32(all, y_in + i, 3);
+        svstnt1_vnum_f32(all, y_out + i, 0, svmla_f32_x(all, y0, x0, va));
+        svstnt1_vnum_f32(all, y_out + i, 1, svmla_f32_x(all, y1, x1, va));
+        svstnt1_vnum_f32(all, y_out + i, 2, svmla_f32_x(all, y2, x2, va));
+        svstnt1_vnum_f32(all, y_out + i, 3, svmla_f32_x(all, y3, x3, va));
+    }
+    saxpy_tail(va, x, y_in, y_out, i, n);
+}
+
+// 带步长：lane j 的偏移是 j * inc（svindex），每一步把基址前移 VL * inc 个元素
+void saxpy_gather_scatter(float a, const float* x, ptrdiff_t incx, float* y, ptrdiff_t incy, uint64_t n) {
+    const svint32_t ix = svindex_s32(0, static_cast<int32_t>(incx));
+    const svint32_t iy = svindex_s32(0, static_cast<int32_t>(incy));
+    const svfloat32_t va = svdup_n_f32(a);
+    const uint64_t vl = svcntw();
+    for (uint64_t i = 0; i < n; i += vl) {
+        svbool_t pg = svwhilelt_b32(i, n);
+        const float* xb = x + static_cast<ptrdiff_t>(i) * incx;
+        float* yb = y + static_cast<ptrdiff_t>(i) * incy;
+        svfloat32_t vec_x = svld1_gather_s32index_f32(pg, xb, ix);
+        svfloat32_t vec_y = svld1_gather_s32index_f32(pg, yb, iy);
+        svst1_scatter_s32index_f32(pg, yb, iy, svmla_f32_m(pg, vec_y, vec_x, va));
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyKernel>& sve_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels = {
+        {"baseline", "sve", "whilelt + svmad_z per vector (original loop)", saxpy_baseline},
+        {"mla",      "sve", "whilelt + svmla merging form",                 saxpy_mla},
+        {"unroll2",  "sve", "2x unrolled, svptrue body + predicated tail",  saxpy_unroll2},
+        {"unroll4",  "sve", "4x unrolled, svptrue body + predicated tail",  saxpy_unroll4},
+        {"prefetch", "sve", "4x unrolled with svprfw software prefetch",    saxpy_prefetch},
+        {"stream",   "sve", "4x unrolled, svldnt1 / svstnt1 non-temporal",  saxpy_stream, true},
+    };
+    return kernels;
+}
+
+SaxpyGatherFn sve_gather_kernel() {
+    return saxpy_gather_scatter;
+}
+
+#else
+
+const std::vector<SaxpyKernel>& sve_kernel_table() {
+    static const std::vector<SaxpyKernel> kernels;
+    return kernels;
+}
+
+SaxpyGatherFn sve_gather_kernel() {
+    return nullptr;
+}
+
+#endif // __ARM_FEATURE_SVE
@@ -0,0 +1,86 @@
+#include "saxpy_backends.h"
+
+// 定长 SVE（VLS）后端：本文件由 makefile 以 -DSVE_VLS_BITS=N -msve-vector-bits=N 编译多次，
+// 每个 N 生成一个 sve<N>_kernel_table()。编译器知道 svcntw() == N / 32，
+// 可以把步长、展开和尾部处理都当成常量来调度；代价是只能在 VL 恰好为 N 的硬件上运行，
+// 由 saxpy.cpp 在运行时比较 prctl(PR_SVE_GET_VL) 的结果后才注册。
+#ifndef SVE_VLS_BITS
+#error "SVE_VLS_BITS must be defined (see makefile)"
+#endif
+
+#define VLS_PASTE(a, b, c) a##b##c
+#define VLS_NAME(a, bits, c) VLS_PASTE(a, bits, c)
+#define VLS_TABLE VLS_NAME(sve, SVE_VLS_BITS, _kernel_table)
+#define VLS_STR2(x) #x
+#define VLS_STR(x) VLS_STR2(x)
+#define VLS_BACKEND "sve" VLS_STR(SVE_VLS_BITS)
+
+#if defined(__ARM_FEATURE_SVE) && defined(__ARM_FEATURE_SVE_BITS) && __ARM_FEATURE_SVE_BITS == SVE_VLS_BITS
+
+#include <arm_sve.h>
+
+namespace {
+
+// 定长类型：大小在编译期已知，可以放进数组或结构体
+typedef svfloat32_t vls_f32 __attribute__((arm_sve_vector_bits(SVE_VLS_BITS)));
+typedef svbool_t vls_pred __attribute__((arm_sve_vector_bits(SVE_VLS_BITS)));
+
+constexpr uint64_t LANES = SVE_VLS_BITS / 32;
+
+// 与 VLA 的 saxpy_mla 相同的谓词循环，只是步长是常量
+void saxpy_vls_mla(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    for (uint64_t i = 0; i < n; i += LANES) {
+        vls_pred pg = svwhilelt_b32(i, n);
+        vls_f32 vec_x = svld1_f32(pg, x + i);
+        vls_f32 vec_y = svld1_f32(pg, y_in + i);
+        svst1_f32(pg, y_out + i, svmla_n_f32_m(pg, vec_y, vec_x, a));
+    }
+}
+
+// UNROLL 个向量为一步的主体（全真谓词），尾部最多 UNROLL 个向量，用 whilelt 处理。
+// 累加器放在定长数组里，展开次数在编译期确定，不需要手写每一路
+template <unsigned UNROLL>
+void saxpy_vls_unrolled(float a, const float* x, const float* y_in, float* y_out, uint64_t n) {
+    constexpr uint64_t STEP = UNROLL * LANES;
+    const vls_pred all = svptrue_b32();
+    const vls_f32 va = svdup_n_f32(a);
+    uint64_t i = 0;
+    for (; i + STEP <= n; i += STEP) {
+        vls_f32 vx[UNROLL], vy[UNROLL];
+#pragma GCC unroll 16
+        for (unsigned u = 0; u < UNROLL; ++u) {
+            vx[u] = svld1_f32(all, x + i + u * LANES);
+            vy[u] = svld1_f32(all, y_in + i + u * LANES);
+        }
+#pragma GCC unroll 16
+        for (unsigned u = 0; u < UNROLL; ++u) {
+            svst1_f32(all, y_out + i + u * LANES, svmla_f32_x(all, vy[u], vx[u], va));
+        }
+    }
+    for (; i < n; i += LANES) {
+        vls_pred pg = svwhilelt_b32(i, n);
+        vls_f32 vec_x = svld1_f32(pg, x + i);
+        vls_f32 vec_y = svld1_f32(pg, y_in + i);
+        svst1_f32(pg, y_out + i, svmla_f32_m(pg, vec_y, vec_x, va));
+    }
+}
+
+} // namespace
+
+const std::vector<SaxpyKernel>& VLS_TABLE() {
+    static const std::vector<SaxpyKernel> kernels = {
+        {"vls_mla",     VLS_BACKEND, "fixed-VL svmla, constant step",                      saxpy_vls_mla},
+        {"vls_unroll4", VLS_BACKEND, "fixed-VL 4x unrolled, svptrue body + whilelt tail", saxpy_vls_unrolled<4>},
+        {"vls_unroll8", VLS_BACKEND, "fixed-VL 8x unrolled, svptrue body + whilelt tail", saxpy_vls_unrolled<8>},
+    };
+    return kernels;
+}
+
+#else
+
+const std::vector<SaxpyKernel>& VLS_TABLE() {
+    static const std::vector<SaxpyKernel> kernels;
+    return kernels;
+}
+
+#endif
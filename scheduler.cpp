@@ -0,0 +1,92 @@
+#include "scheduler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+const char* schedule_name(Schedule schedule) {
+    return schedule == Schedule::Steal ? "steal" : "static";
+}
+
+WorkStealingScheduler::WorkStealingScheduler(std::vector<Range> tasks, std::vector<uint64_t> task_elements,
+                                             const std::vector<Range>& owned)
+    : tasks_(std::move(tasks)), task_elements_(std::move(task_elements)), queues_(owned.size()), stats_(owned.size()) {
+    if (tasks_.size() >= (uint64_t(1) << 32)) {
+        throw std::runtime_error("Too many work-stealing tasks.");
+    }
+    if (task_elements_.size() != tasks_.size()) {
+        throw std::runtime_error("Work-stealing task sizes do not match the task list.");
+    }
+    for (size_t tid = 0; tid < owned.size(); ++tid) {
+        queues_[tid].initial = owned[tid];
+    }
+    prepare();
+}
+
+void WorkStealingScheduler::prepare() {
+    // 线程池的分发保证工作线程看到这些写入
+    for (Queue& queue : queues_) {
+        queue.state.store(pack(queue.initial.begin, queue.initial.end), std::memory_order_relaxed);
+    }
+}
+
+std::shared_ptr<WorkStealingScheduler> WorkStealingScheduler::for_chunks(const std::vector<Range>& chunks,
+                                                                         size_t grain, size_t align) {
+    align = std::max<size_t>(align, 1);
+    grain = std::max((grain + align - 1) / align * align, align);
+    std::vector<Range> tasks;
+    std::vector<uint64_t> sizes;
+    std::vector<Range> owned;
+    for (const Range& chunk : chunks) {
+        const size_t first = tasks.size();
+        for (size_t begin = chunk.begin; begin < chunk.end; begin += grain) {
+            tasks.push_back({begin, std::min(chunk.end, begin + grain)});
+            sizes.push_back(tasks.back().size());
+        }
+        owned.push_back({first, tasks.size()});
+    }
+    return std::make_shared<WorkStealingScheduler>(std::move(tasks), std::move(sizes), owned);
+}
+
+void WorkStealingScheduler::reset_stats() {
+    std::fill(stats_.begin(), stats_.end(), StealStats{});
+}
+
+bool WorkStealingScheduler::pop(Queue& queue, size_t& task) {
+    uint64_t state = queue.state.load(std::memory_order_acquire);
+    while (true) {
+        const size_t top = static_cast<size_t>(state >> 32);
+        const size_t bottom = static_cast<size_t>(state & 0xFFFFFFFFu);
+        if (top >= bottom) {
+            return false;
+        }
+        // 失败时 state 被更新为当前值，重新判断
+        if (queue.state.compare_exchange_weak(state, pack(top + 1, bottom), std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+            task = top;
+            return true;
+        }
+    }
+}
+
+bool WorkStealingScheduler::steal(size_t tid, size_t& task, StealStats& stats) {
+    // 从下一个线程开始轮询，避免所有窃取者同时挤向同一个队列
+    const size_t n = queues_.size();
+    for (size_t k = 1; k < n; ++k) {
+        Queue& victim = queues_[(tid + k) % n];
+        uint64_t state = victim.state.load(std::memory_order_acquire);
+        while (true) {
+            const size_t top = static_cast<size_t>(state >> 32);
+            const size_t bottom = static_cast<size_t>(state & 0xFFFFFFFFu);
+            if (top >= bottom) {
+                break;
+            }
+            if (victim.state.compare_exchange_weak(state, pack(top, bottom - 1), std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+                task = bottom - 1;
+                ++stats.stolen;
+                return true;
+            }
+        }
+    }
+    return false;
+}
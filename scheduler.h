@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "thread_pool.h"
+#include "timer.h"
+#include "trace.h"
+
+/**
+ * @brief 并行计算的调度方式
+ *
+ * - Static: 每个线程处理 static_partition 给出的固定数据块（默认）
+ * - Steal:  数据块再切成小任务，放进每个线程自己的双端队列；做完自己的任务后从其他线程的队列尾部窃取，
+ *           慢核（big.LITTLE 的小核、被降频或被抢占的核）和长度不均的批不再决定整次分发的耗时
+ */
+enum class Schedule {
+    Static,
+    Steal,
+};
+
+const char* schedule_name(Schedule schedule);
+
+// 工作窃取的默认任务粒度（元素）：64 KiB 的 X，远大于一次窃取的开销，又足以在线程间均衡
+constexpr size_t DEFAULT_STEAL_GRAIN = 16384;
+
+/**
+ * @brief 每个线程在工作窃取调度下的统计，按缓存行对齐避免伪共享
+ */
+struct alignas(64) StealStats {
+    uint64_t busy_ticks = 0;        // 执行任务的时间（计时器 tick）
+    uint64_t tasks = 0;             // 执行的任务数，含窃取来的
+    uint64_t stolen = 0;            // 其中从其他线程窃取的任务数
+    uint64_t elements = 0;          // 执行的任务的元素数之和
+};
+
+/**
+ * @brief 固定任务集上的工作窃取调度器
+ *
+ * 任务是 [begin, end) 区间（含义由调用方决定：元素或批中的向量编号），构造时按线程连续分配，
+ * 初始分配与静态划分一致，负载均衡时每个线程只处理自己首次访问过的数据。
+ * 每个线程的队列是自己那一段任务下标 [top, bottom)，两个 32 位下标打包在一个 64 位原子变量里：
+ * 所有者用 CAS 从头部按地址顺序取任务（对硬件预取最友好），窃取者用 CAS 从尾部取，无锁。
+ *
+ * 构造后所有队列即为初始分配；之后每次分发前由主线程调用 prepare() 恢复全部队列，
+ * 分发中每个线程调用一次 run(tid, ...)，执行任务直到所有队列为空。
+ * 队列在任何线程开始 run 之前就已恢复，先做完的线程能窃取尚未启动（晚唤醒、被抢占）的线程的任务；
+ * 线程池保证上一次分发的 run 全部返回后才开始下一次，恢复队列与窃取之间不存在 ABA 问题。
+ */
+class WorkStealingScheduler {
+public:
+    // tasks 按线程连续排列：线程 t 初始拥有 tasks[owned[t].begin, owned[t].end)；
+    // task_elements[k] 是第 k 个任务的元素数，只用于统计
+    WorkStealingScheduler(std::vector<Range> tasks, std::vector<uint64_t> task_elements,
+                          const std::vector<Range>& owned);
+
+    /**
+     * @brief 把每个线程的数据块切成不超过 grain 个元素的任务；任务边界按 align 个元素对齐
+     */
+    static std::shared_ptr<WorkStealingScheduler> for_chunks(const std::vector<Range>& chunks, size_t grain,
+                                                             size_t align);
+
+    size_t threads() const { return queues_.size(); }
+    size_t task_count() const { return tasks_.size(); }
+
+    /**
+     * @brief 把所有队列恢复成初始分配；在分发之前、没有线程在 run 中时调用
+     */
+    void prepare();
+
+    /**
+     * @brief 在线程 tid 上执行任务：对领取到的每个任务调用 execute(const Range&)，直到所有队列为空
+     */
+    template <typename F>
+    void run(size_t tid, F&& execute) {
+        Queue& own = queues_[tid];
+        StealStats& stats = stats_[tid];
+        size_t task;
+        while (true) {
+            bool stolen = false;
+            if (!pop(own, task)) {
+                if (!steal(tid, task, stats)) {
+                    break;
+                }
+                stolen = true;
+            }
+            TraceScope scope(stolen ? "stolen task" : "task", "steal", static_cast<long long>(task));
+            const uint64_t t0 = read_ticks();
+            execute(static_cast<const Range&>(tasks_[task]));
+            stats.busy_ticks += read_ticks() - t0;
+            ++stats.tasks;
+            stats.elements += task_elements_[task];
+        }
+    }
+
+    const std::vector<StealStats>& stats() const { return stats_; }
+    void reset_stats();
+
+private:
+    // 一个线程的队列：initial 是构造时分配的任务下标区间
+    struct alignas(64) Queue {
+        std::atomic<uint64_t> state{0};
+        Range initial{0, 0};
+    };
+
+    static uint64_t pack(size_t top, size_t bottom) { return (static_cast<uint64_t>(top) << 32) | bottom; }
+
+    bool pop(Queue& queue, size_t& task);
+    bool steal(size_t tid, size_t& task, StealStats& stats);
+
+    std::vector<Range> tasks_;
+    std::vector<uint64_t> task_elements_;
+    std::vector<Queue> queues_;
+    std::vector<StealStats> stats_;
+};
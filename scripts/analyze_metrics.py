@@ -22,6 +22,7 @@ class PerformanceAnalyzer:
         }
         self.hotspots = []
         self.system_info = {}
+        self.benchmark = None
         
     def extract_value(self, pattern: str, text: str) -> int:
         """Extract numeric value from text using regex pattern"""
@@ -235,6 +236,18 @@ class PerformanceAnalyzer:
         
         self.system_info = info
         return info
+
+    def load_benchmark(self, filepath: str = None) -> Dict[str, Any]:
+        """Load the JSON record written by perf_test --output"""
+        if filepath is None:
+            filepath = f"{self.results_dir}/benchmark.json"
+
+        if not os.path.exists(filepath):
+            return None
+
+        with open(filepath, 'r') as f:
+            self.benchmark = json.load(f)
+        return self.benchmark
     
     def generate_json_report(self, output_file: str = None) -> None:
         """Generate comprehensive JSON report"""
@@ -247,6 +260,8 @@ class PerformanceAnalyzer:
             "metrics": self.metrics,
             "hotspots": self.hotspots
         }
+        if self.benchmark is not None:
+            report["benchmark"] = self.benchmark
         
         with open(output_file, 'w') as f:
             json.dump(report, f, indent=2)
@@ -356,6 +371,7 @@ def main():
     
     if args.all:
         analyzer.analyze_system_info()
+        analyzer.load_benchmark()
         analyzer.generate_json_report()
         analyzer.generate_markdown_report()
         analyzer.print_summary()
@@ -2,18 +2,41 @@
 """
 性能对比脚本 - 比较两次运行的性能指标
 使用方法: python3 compare_performance.py baseline.json current.json
+          python3 compare_performance.py base1.json,base2.json,base3.json cur1.json,cur2.json,cur3.json
+          python3 compare_performance.py --run baseline/perf_test ./perf_test --trials 5 --perf-args "--duration 5"
+
+输入可以是 analyze_metrics.py 生成的 performance_report.json，
+也可以是 perf_test --output 直接写出的基准记录（"benchmark": "saxpy"）。
+
+基准记录的吞吐量按统计检验判定退步，而不是只比较两个数：
+  - 每边至少 5 次运行（逗号分隔的多份记录，或 --run 交替运行两个二进制）时，每次运行的结果是一个样本；
+  - 运行次数更少时，合并各次记录里计时循环各窗口的吞吐量（results[].samples）作为样本；
+  - 单侧 Mann-Whitney U 检验给出 p 值，自助法（bootstrap）给出中位数相对变化的置信区间，
+    Cliff's delta 给出效应量；
+  - 只有 p < --alpha、置信区间整体落在变差一侧、且中位数变差超过 --threshold 时才算退步。
+样本不足（旧记录没有 samples）时退回到只比较阈值，延迟分位数只报告、不参与判定。
 """
 
 import json
+import math
+import os
+import random
+import shlex
+import subprocess
 import sys
 import argparse
-from typing import Dict, Any
+import tempfile
+from typing import Dict, Any, List, Optional, Tuple
 
 def load_report(filepath: str) -> Dict[str, Any]:
     """加载性能报告"""
     with open(filepath, 'r') as f:
         return json.load(f)
 
+def load_reports(spec: str) -> List[Dict[str, Any]]:
+    """加载逗号分隔的一组报告（同一配置的重复运行）"""
+    return [load_report(path) for path in spec.split(',') if path]
+
 def calculate_change(baseline: float, current: float) -> float:
     """计算百分比变化"""
     if baseline == 0:
@@ -38,6 +61,271 @@ def format_change(value: float, higher_is_better: bool = True) -> str:
     
     return f"{color}{symbol} {abs(value):.2f}%\033[0m"
 
+def is_benchmark_record(report: Dict[str, Any]) -> bool:
+    """判断是否为 perf_test 直接输出的 JSON 记录"""
+    return report.get('benchmark') == 'saxpy' and 'results' in report
+
+def benchmark_results(report: Dict[str, Any]) -> Dict[Tuple, Dict[str, Any]]:
+    """按 (op, kernel, elements, threads, mode) 索引结果；旧记录没有 op 字段，视为 saxpy"""
+    if not is_benchmark_record(report):
+        report = report.get('benchmark', {})
+    config = report.get('config', {})
+    indexed = {}
+    for result in report.get('results', []):
+        kernel = result['kernel']
+        # 批量 SAXPY 的同一内核按形状和布局区分
+        if result.get('shape'):
+            kernel = f"{kernel}@{result['shape']}/{result.get('layout', 'items')}"
+        key = (result.get('op', 'saxpy'), kernel, result['elements'], config.get('threads', 1), config.get('mode', 'kernel'))
+        indexed[key] = result
+    return indexed
+
+# ---------------------------------------------------------------------------
+# 统计检验：只用标准库，CI 上不需要额外安装 scipy
+# ---------------------------------------------------------------------------
+
+# 少于这么多个样本时不做检验，只比较阈值
+MIN_SAMPLES = 3
+
+# 至少这么多次运行时用运行级样本（每次运行一个）；5 对 5 时单侧精确检验的最小 p 值约为 0.004
+MIN_RUNS = 5
+
+def median(values: List[float]) -> float:
+    ordered = sorted(values)
+    n = len(ordered)
+    mid = n // 2
+    return ordered[mid] if n % 2 else (ordered[mid - 1] + ordered[mid]) / 2
+
+def rank_with_ties(values: List[float]) -> List[float]:
+    """平均秩（从 1 开始），相同值取其所占位置的平均"""
+    order = sorted(range(len(values)), key=lambda i: values[i])
+    ranks = [0.0] * len(values)
+    i = 0
+    while i < len(order):
+        j = i
+        while j + 1 < len(order) and values[order[j + 1]] == values[order[i]]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[order[k]] = (i + j) / 2 + 1
+        i = j + 1
+    return ranks
+
+def exact_u_cdf(u: int, n1: int, n2: int) -> float:
+    """无相同值时 U <= u 的精确概率：按 (n1, n2) 递推计数"""
+    # counts[i][j][k]: i 个 a、j 个 b 的排列中 U == k 的个数，只保留当前 i 一层
+    prev = [[1] for _ in range(n2 + 1)]  # i == 0：U 恒为 0
+    for i in range(1, n1 + 1):
+        cur = [[1]]  # j == 0：U 恒为 0
+        for j in range(1, n2 + 1):
+            # 最大的元素来自 a（贡献 j）或来自 b（贡献 0）
+            size = i * j + 1
+            row = [0] * size
+            for k, c in enumerate(prev[j]):
+                row[k + j] += c
+            for k, c in enumerate(cur[j - 1]):
+                row[k] += c
+            cur.append(row)
+        prev = cur
+    dist = prev[n2]
+    total = sum(dist)
+    return sum(dist[:u + 1]) / total
+
+def mann_whitney_less(a: List[float], b: List[float]) -> float:
+    """单侧 p 值：a 的分布整体小于 b 的概率不显著的程度（H1: a < b）
+
+    样本少且没有相同值时用精确分布，否则用带连续性校正和相同值校正的正态近似。
+    """
+    n1, n2 = len(a), len(b)
+    ranks = rank_with_ties(list(a) + list(b))
+    r1 = sum(ranks[:n1])
+    u1 = r1 - n1 * (n1 + 1) / 2   # a 中元素大于 b 中元素的对数（相同记 0.5）
+    if n1 + n2 <= 20 and len(set(a) | set(b)) == n1 + n2:
+        return exact_u_cdf(int(round(u1)), n1, n2)
+    n = n1 + n2
+    ties = {}
+    for v in list(a) + list(b):
+        ties[v] = ties.get(v, 0) + 1
+    tie_term = sum(t ** 3 - t for t in ties.values()) / (n * (n - 1))
+    sigma = math.sqrt(n1 * n2 / 12 * ((n + 1) - tie_term))
+    if sigma == 0:
+        return 1.0
+    z = (u1 - n1 * n2 / 2 + 0.5) / sigma
+    return 0.5 * math.erfc(-z / math.sqrt(2))
+
+def cliffs_delta(a: List[float], b: List[float]) -> float:
+    """P(a > b) - P(a < b)，范围 [-1, 1]"""
+    greater = sum(1 for x in a for y in b if x > y)
+    less = sum(1 for x in a for y in b if x < y)
+    return (greater - less) / (len(a) * len(b))
+
+def effect_label(delta: float) -> str:
+    """Cliff's delta 的常用分级（Romano et al. 2006）"""
+    d = abs(delta)
+    if d < 0.147:
+        return "negligible"
+    if d < 0.33:
+        return "small"
+    if d < 0.474:
+        return "medium"
+    return "large"
+
+def bootstrap_change_ci(base: List[float], curr: List[float], confidence: float,
+                        resamples: int = 2000, seed: int = 12345) -> Tuple[float, float]:
+    """中位数相对变化（%）的百分位自助法置信区间；固定种子，同样的输入总是同样的结论"""
+    rng = random.Random(seed)
+    changes = []
+    for _ in range(resamples):
+        b = median([rng.choice(base) for _ in base])
+        c = median([rng.choice(curr) for _ in curr])
+        changes.append(calculate_change(b, c))
+    changes.sort()
+    tail = (1 - confidence) / 2
+    lo = changes[int(math.floor(tail * (resamples - 1)))]
+    hi = changes[int(math.ceil((1 - tail) * (resamples - 1)))]
+    return lo, hi
+
+def assess(base: List[float], curr: List[float], higher_is_better: bool,
+           alpha: float, threshold: float) -> Dict[str, Any]:
+    """比较两组样本；返回中位数变化、置信区间、p 值、效应量和是否判定为退步"""
+    change = calculate_change(median(base), median(curr))
+    out = {'change': change, 'n': (len(base), len(curr)), 'tested': False, 'regression': False}
+    worse = -change if higher_is_better else change
+    if len(base) < MIN_SAMPLES or len(curr) < MIN_SAMPLES:
+        # 样本不足：与旧版一样只看阈值
+        out['regression'] = worse > threshold
+        return out
+    # 把"变差"统一成"当前值更小"：越低越好的指标取相反数
+    sign = 1 if higher_is_better else -1
+    p = mann_whitney_less([sign * v for v in curr], [sign * v for v in base])
+    lo, hi = bootstrap_change_ci(base, curr, 1 - alpha)
+    delta = cliffs_delta(curr, base) * sign
+    ci_worse = hi < 0 if higher_is_better else lo > 0
+    out.update({'tested': True, 'p': p, 'ci': (lo, hi), 'delta': delta,
+                'regression': p < alpha and ci_worse and worse > threshold})
+    return out
+
+def format_assessment(a: Dict[str, Any]) -> str:
+    if not a['tested']:
+        return f"(n={a['n'][0]}/{a['n'][1]}, threshold only)"
+    lo, hi = a['ci']
+    return (f"CI [{lo:+.2f}%, {hi:+.2f}%]  p={a['p']:.4f}  "
+            f"δ={a['delta']:+.2f} ({effect_label(a['delta'])})  n={a['n'][0]}/{a['n'][1]}")
+
+def collect_results(reports: List[Dict[str, Any]]) -> Dict[Tuple, List[Dict[str, Any]]]:
+    """把多份记录按 benchmark_results 的键合并：每个键对应各次运行的结果列表"""
+    merged: Dict[Tuple, List[Dict[str, Any]]] = {}
+    for report in reports:
+        for key, result in benchmark_results(report).items():
+            merged.setdefault(key, []).append(result)
+    return merged
+
+def window_samples(result: Dict[str, Any], field) -> List[float]:
+    """一次运行中计时循环各窗口的吞吐量；记录里没有窗口样本时为空"""
+    windows = result.get('samples', {})
+    if field in ('gflops', 'bandwidth_gbs'):
+        return [v for v in windows.get(field, []) if v > 0]
+    if field == 'vectors_per_second' and result.get('vectors_per_second') and result.get('bandwidth_gbs'):
+        # 同一形状下每秒向量数与带宽成正比
+        scale = result['vectors_per_second'] / result['bandwidth_gbs']
+        return [v * scale for v in windows.get('bandwidth_gbs', []) if v > 0]
+    return []
+
+def metric_samples(results: List[Dict[str, Any]], field, get) -> List[float]:
+    """一个指标的样本：至少 MIN_RUNS 次运行时每次运行一个，否则合并各次运行的窗口样本
+
+    窗口之间的波动只反映运行内的噪声，看不到每次启动进程时频率、页面布局等的变化，
+    所以运行次数足够时优先用运行级样本；3 对 3 次运行时单侧检验的最小 p 值就是 0.05，无法判定。
+    """
+    if len(results) < MIN_RUNS:
+        windows = [window_samples(r, field) for r in results]
+        if all(windows):
+            return [v for w in windows for v in w]
+    return [get(r, field) for r in results]
+
+def compare_benchmark(baseline: List[Dict], current: List[Dict], threshold: float, alpha: float) -> List[str]:
+    """比较两组基准记录（各自是同一配置的一次或多次运行），返回判定为退步的列表"""
+    print("\n" + "="*60)
+    print("SAXPY Benchmark Comparison")
+    print("="*60)
+    print(f"baseline runs: {len(baseline)}, current runs: {len(current)}; "
+          f"regression = p < {alpha} and CI below 0 and median worse than {threshold:.1f}%")
+
+    # (字段, 显示名, 越高越好, 参与判定)：延迟分位数对调度噪声太敏感，只报告
+    fields = [
+        ('gflops', 'GFLOPS', True, True),
+        ('bandwidth_gbs', 'GB/s', True, True),
+        ('vectors_per_second', 'vectors/s', True, True),
+        (('latency_ns', 'median'), 'median ns', False, False),
+        (('latency_ns', 'p99'), 'p99 ns', False, False),
+        (('latency_ns', 'p99_9'), 'p99.9 ns', False, False),
+    ]
+
+    def get(result, field):
+        if isinstance(field, tuple):
+            return result.get(field[0], {}).get(field[1], 0) or 0
+        return result.get(field, 0) or 0
+
+    base = collect_results(baseline)
+    curr = collect_results(current)
+    regressions = []
+
+    for key in sorted(set(base) & set(curr)):
+        op, kernel, elements, threads, mode = key
+        # SAXPY 结果按内核名区分，套件结果的内核名就是操作名
+        label = kernel if op in ('saxpy', kernel) else f"{op}/{kernel}"
+        print(f"\n### {label}  n={elements}  threads={threads}  mode={mode}")
+        print("-" * 40)
+        for field, name, higher_is_better, gated in fields:
+            b = metric_samples(base[key], field, get)
+            c = metric_samples(curr[key], field, get)
+            if not any(b) and not any(c):
+                continue
+            if not gated:
+                b_med, c_med = median(b), median(c)
+                change = calculate_change(b_med, c_med)
+                print(f"{name:16} {b_med:12.3f} → {c_med:12.3f}  {format_change(change, higher_is_better)}  (info)")
+                continue
+            result = assess(b, c, higher_is_better, alpha, threshold)
+            print(f"{name:16} {median(b):12.3f} → {median(c):12.3f}  "
+                  f"{format_change(result['change'], higher_is_better)}  {format_assessment(result)}")
+            if result['regression']:
+                worse = -result['change'] if higher_is_better else result['change']
+                how = f"p={result['p']:.4f}, {effect_label(result['delta'])} effect" if result['tested'] \
+                    else "threshold only"
+                regressions.append(f"{label} n={elements} {name} worse by {worse:.1f}% ({how})")
+
+    for key in sorted(set(base) ^ set(curr)):
+        where = "baseline" if key in base else "current"
+        print(f"\n(only in {where}: {key[1]} n={key[2]} threads={key[3]} mode={key[4]})")
+
+    print("\n" + "="*60)
+    if regressions:
+        print("⚠️  Significant regressions:")
+        for reg in regressions:
+            print(f"  • {reg}")
+    else:
+        print("→ No significant regressions")
+    print()
+    return regressions
+
+def run_trials(baseline_bin: str, current_bin: str, trials: int, perf_args: str,
+               trial_dir: str) -> Tuple[List[Dict], List[Dict]]:
+    """交替运行两个 perf_test，每次交换先后顺序（ABBA），抵消机器状态随时间的漂移"""
+    os.makedirs(trial_dir, exist_ok=True)
+    args = shlex.split(perf_args)
+    baseline, current = [], []
+    for k in range(trials):
+        order = [('baseline', baseline_bin, baseline), ('current', current_bin, current)]
+        if k % 2:
+            order.reverse()
+        for tag, binary, runs in order:
+            path = os.path.join(trial_dir, f"{tag}_{k}.json")
+            cmd = [binary] + args + ['--output', path]
+            print(f"[trial {k + 1}/{trials}] {' '.join(shlex.quote(c) for c in cmd)}")
+            subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+            runs.append(load_report(path))
+    return baseline, current
+
 def compare_metrics(baseline: Dict, current: Dict) -> None:
     """比较性能指标"""
     
@@ -157,17 +445,36 @@ def compare_metrics(baseline: Dict, current: Dict) -> None:
 
 def main():
     parser = argparse.ArgumentParser(description='Compare performance reports')
-    parser.add_argument('baseline', help='Baseline performance report (JSON)')
-    parser.add_argument('current', help='Current performance report (JSON)')
+    parser.add_argument('baseline', help='Baseline report (JSON), comma-separated repeated runs, or a perf_test binary with --run')
+    parser.add_argument('current', help='Current report (JSON), comma-separated repeated runs, or a perf_test binary with --run')
     parser.add_argument('--threshold', type=float, default=5.0,
-                       help='Threshold for significant change (default: 5%%)')
+                       help='Smallest change that counts as a regression (default: 5%%)')
+    parser.add_argument('--alpha', type=float, default=0.05,
+                       help='Significance level of the Mann-Whitney test; the CI is 1 - alpha (default: 0.05)')
+    parser.add_argument('--run', action='store_true',
+                       help='Treat baseline / current as perf_test binaries and run them alternately --trials times')
+    parser.add_argument('--trials', type=int, default=5,
+                       help='Runs per binary with --run (default: 5)')
+    parser.add_argument('--perf-args', default='',
+                       help='Arguments passed to both binaries with --run, e.g. "--duration 5 --threads 0"')
+    parser.add_argument('--trial-dir', default=None,
+                       help='Where --run writes the per-trial records (default: a temporary directory)')
+    parser.add_argument('--fail-on-regression', action='store_true',
+                       help='Exit with status 2 if any throughput metric regresses significantly')
     
     args = parser.parse_args()
     
     try:
-        baseline = load_report(args.baseline)
-        current = load_report(args.current)
-        compare_metrics(baseline, current)
+        if args.run:
+            trial_dir = args.trial_dir or tempfile.mkdtemp(prefix='perf_trials_')
+            baselines, currents = run_trials(args.baseline, args.current, args.trials, args.perf_args, trial_dir)
+        else:
+            baselines, currents = load_reports(args.baseline), load_reports(args.current)
+        regressions = []
+        if collect_results(baselines) and collect_results(currents):
+            regressions = compare_benchmark(baselines, currents, args.threshold, args.alpha)
+        if not is_benchmark_record(baselines[0]) and not is_benchmark_record(currents[0]):
+            compare_metrics(baselines[0], currents[0])
         
     except FileNotFoundError as e:
         print(f"Error: Could not find file - {e}")
@@ -175,9 +482,15 @@ def main():
     except json.JSONDecodeError as e:
         print(f"Error: Invalid JSON format - {e}")
         sys.exit(1)
+    except subprocess.CalledProcessError as e:
+        print(f"Error: perf_test failed - {e}")
+        sys.exit(1)
     except Exception as e:
         print(f"Error: {e}")
         sys.exit(1)
 
+    if regressions and args.fail_on_regression:
+        sys.exit(2)
+
 if __name__ == "__main__":
-    main()
\ No newline at end of file
+    main()
@@ -30,7 +30,82 @@ class DashboardGenerator:
         with open(self.report_file, 'r') as f:
             self.data = json.load(f)
         return True
+
+    def benchmark_record(self) -> Dict[str, Any]:
+        """Return the perf_test record, either embedded or loaded directly"""
+        if self.data.get('benchmark') == 'saxpy':
+            return self.data
+        embedded = self.data.get('benchmark')
+        return embedded if isinstance(embedded, dict) else {}
+
+    def create_benchmark_chart(self, output_file: str) -> None:
+        """Plot per-kernel throughput; sweeps are plotted against footprint"""
+        results = self.benchmark_record().get('results', [])
+        if not results:
+            return
+
+        fig = make_subplots(rows=1, cols=2, subplot_titles=('GFLOPS', 'Bandwidth (GB/s)'))
+        sweep = len({r['elements'] for r in results}) > 1
+
+        for kernel in dict.fromkeys(r['kernel'] for r in results):
+            rows = sorted((r for r in results if r['kernel'] == kernel),
+                          key=lambda r: r['footprint_bytes'])
+            if sweep:
+                x = [r['footprint_bytes'] for r in rows]
+                fig.add_trace(go.Scatter(x=x, y=[r['gflops'] for r in rows],
+                                         mode='lines+markers', name=kernel), row=1, col=1)
+                fig.add_trace(go.Scatter(x=x, y=[r['bandwidth_gbs'] for r in rows],
+                                         mode='lines+markers', name=kernel,
+                                         showlegend=False), row=1, col=2)
+            else:
+                fig.add_trace(go.Bar(x=[kernel], y=[rows[0]['gflops']], name=kernel), row=1, col=1)
+                fig.add_trace(go.Bar(x=[kernel], y=[rows[0]['bandwidth_gbs']], name=kernel,
+                                     showlegend=False), row=1, col=2)
+
+        if sweep:
+            fig.update_xaxes(type='log', title_text='Working set (bytes)')
+
+        fig.update_layout(title={'text': 'SAXPY Benchmark', 'x': 0.5, 'xanchor': 'center'},
+                          height=500, font=dict(family="Arial, sans-serif"))
+        fig.write_html(output_file, config={'displayModeBar': True, 'displaylogo': False})
+        print(f"Benchmark chart created: {output_file}")
     
+    def create_roofline_chart(self, output_file: str) -> None:
+        """Plot results on the roofline measured by perf_test --roofline (log-log)"""
+        record = self.benchmark_record()
+        peaks = record.get('system', {}).get('roofline')
+        results = [r for r in record.get('results', []) if r.get('roofline')]
+        if not peaks or not results:
+            return
+
+        peak_gflops = peaks['peak_gflops']
+        peak_bw = peaks['peak_bandwidth_gbs']
+        ridge = peaks['ridge_intensity']
+        intensities = [r['roofline']['arithmetic_intensity'] for r in results]
+        lo = min(min(intensities), ridge) / 4
+        hi = max(max(intensities), ridge) * 4
+        xs = [lo * (hi / lo) ** (k / 63) for k in range(64)]
+
+        fig = go.Figure()
+        fig.add_trace(go.Scatter(x=xs, y=[min(peak_gflops, x * peak_bw) for x in xs], mode='lines',
+                                 name=f"roof ({peak_bw:.1f} GB/s {peaks['bandwidth_kernel']}, "
+                                      f"{peak_gflops:.1f} GFLOPS {peaks['fma_kernel']})",
+                                 line=dict(color='black')))
+        for kernel in dict.fromkeys(f"{r['op']}/{r['kernel']}" for r in results):
+            rows = [r for r in results if f"{r['op']}/{r['kernel']}" == kernel]
+            fig.add_trace(go.Scatter(
+                x=[r['roofline']['arithmetic_intensity'] for r in rows],
+                y=[r['gflops'] for r in rows], mode='markers', name=kernel, marker=dict(size=10),
+                text=[f"{r['elements']} elements, {r['roofline']['percent_of_roof']:.1f}% of roof" for r in rows],
+                hovertemplate='%{y:.3f} GFLOPS at %{x:.3f} flop/B<br>%{text}'))
+
+        fig.update_xaxes(type='log', title_text='Arithmetic intensity (flop/byte)')
+        fig.update_yaxes(type='log', title_text='GFLOPS')
+        fig.update_layout(title={'text': 'Roofline', 'x': 0.5, 'xanchor': 'center'},
+                          height=500, font=dict(family="Arial, sans-serif"))
+        fig.write_html(output_file, config={'displayModeBar': True, 'displaylogo': False})
+        print(f"Roofline chart created: {output_file}")
+
     def create_dashboard(self, output_file: str = "results/dashboard.html") -> None:
         """Create interactive HTML dashboard"""
         
@@ -250,6 +325,9 @@ class DashboardGenerator:
         )
         
         print(f"Dashboard created: {output_file}")
+
+        self.create_benchmark_chart(output_file.replace('.html', '_benchmark.html'))
+        self.create_roofline_chart(output_file.replace('.html', '_roofline.html'))
     
     def create_simple_dashboard(self, output_file: str = "results/simple_dashboard.html") -> None:
         """Create a simple text-based dashboard if plotly fails"""
@@ -333,6 +411,23 @@ class DashboardGenerator:
             for h in hotspots:
                 html_content += f'<li>{h["percentage"]}% - {h["function"]}</li>'
             html_content += '</ol></div>'
+
+        # Add perf_test results
+        results = self.benchmark_record().get('results', [])
+        if results:
+            html_content += '<div class="metric-group"><h2>Benchmark Results</h2><table>'
+            html_content += ('<tr><th>Kernel</th><th>Elements</th><th>GFLOPS</th>'
+                             '<th>GB/s</th><th>Median ns</th><th>p99 ns</th><th>% of roof</th></tr>')
+            for r in results:
+                latency = r.get('latency_ns', {})
+                roof = r.get('roofline')
+                percent = f"{roof['percent_of_roof']:.1f}" if roof else '-'
+                html_content += (f'<tr><td>{r["kernel"]}</td><td>{r["elements"]}</td>'
+                                 f'<td>{r["gflops"]:.3f}</td><td>{r["bandwidth_gbs"]:.3f}</td>'
+                                 f'<td>{latency.get("median", 0):.0f}</td>'
+                                 f'<td>{latency.get("p99", 0):.0f}</td>'
+                                 f'<td>{percent}</td></tr>')
+            html_content += '</table></div>'
         
         html_content += """
     </div>
@@ -61,7 +61,7 @@ if [ $? -eq 0 ]; then
     echo "✅ Setup complete!"
     echo ""
     echo "You can now run:"
-    echo "  ./perf_test                    # Run the test program"
+    echo "  ./perf_test                    # Run the test program (./perf_test --help for options)"
     echo "  make perf-record               # Record performance data"
     echo "  make flamegraph                # Generate flame graph"
     echo "  make cache-analysis            # Analyze cache performance"
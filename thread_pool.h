@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "topology.h"
+
+/**
+ * @brief 半开区间 [begin, end)，单位为元素
+ */
+struct Range {
+    size_t begin;
+    size_t end;
+
+    size_t size() const { return end - begin; }
+};
+
+/**
+ * @brief 把 [0, n) 静态划分为 parts 个连续块
+ *
+ * 块边界按 align 个元素对齐（最后一块除外），
+ * 避免相邻线程写同一条缓存行造成伪共享。
+ */
+std::vector<Range> static_partition(size_t n, size_t parts, size_t align);
+
+/**
+ * @brief 常驻的绑核线程池
+ *
+ * 每个工作线程在启动时绑定到构造时给定的 CPU 上，
+ * 之后反复执行 run() 分发下来的任务，避免每次迭代都创建线程。
+ *
+ * 分发和完成都不加锁：run() 发布任务后递增一个 32 位的代数（generation），
+ * 工作线程先自旋等它变化，超过自旋上限后在这个字上 futex 睡眠；
+ * 完成时每个线程递减 pending 计数，主线程同样先自旋、再在 pending 上睡眠，由最后一个线程唤醒。
+ * 只有确实有线程睡眠时才调用 futex_wake，正常的紧凑迭代里一次分发 + 屏障没有系统调用。
+ *
+ * 自旋只在不会抢走别人 CPU 时才有意义：默认只有每个工作线程独占一个 CPU、
+ * 且还有空闲的 CPU 留给（不绑核的）主线程时才自旋，否则直接 futex 睡眠。
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(const std::vector<CpuSlot>& cpus);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return slots_.size(); }
+    const CpuSlot& slot(size_t tid) const { return slots_[tid]; }
+
+    // 绑核失败的线程数（例如容器限制了 CPU 集合）
+    size_t pin_failures() const { return pin_failures_; }
+
+    /**
+     * @brief 在每个工作线程上执行 task(tid)，阻塞直到全部完成
+     */
+    void run(const std::function<void(size_t)>& task);
+
+    /**
+     * @brief 睡眠前最多自旋多久（纳秒）；0 表示不自旋，直接 futex 等待
+     *
+     * 默认值按上面的规则由构造函数选定；不能与 run() 并发调用。
+     */
+    uint64_t worker_spin_ns() const { return worker_spin_ns_; }
+    uint64_t main_spin_ns() const { return main_spin_ns_; }
+    void set_spin(uint64_t worker_ns, uint64_t main_ns);
+
+private:
+    void worker_loop(size_t tid);
+    uint32_t wait_for_generation(uint32_t seen);
+
+    std::vector<CpuSlot> slots_;
+    std::vector<std::thread> workers_;
+
+    // 分发：task_ 由 generation_ 的递增发布；sleeping_workers_ 是正在 futex 上睡眠（或即将睡眠）的线程数
+    alignas(64) std::atomic<uint32_t> generation_{0};
+    std::atomic<uint32_t> sleeping_workers_{0};
+    std::atomic<bool> stop_{false};
+    const std::function<void(size_t)>* task_ = nullptr;
+    std::atomic<uint64_t> worker_spin_ticks_{0};    // 空闲的工作线程在等待中随时读取
+    uint64_t worker_spin_ns_ = 0;
+
+    // 完成：pending_ 归零时若主线程在睡眠则由最后一个线程唤醒；与分发字分开，避免在同一缓存行上来回争用
+    alignas(64) std::atomic<uint32_t> pending_{0};
+    std::atomic<uint32_t> main_sleeping_{0};
+    uint64_t main_spin_ticks_ = 0;
+    uint64_t main_spin_ns_ = 0;
+
+    // 只在构造时使用：等待所有线程完成绑核
+    std::mutex mutex_;
+    std::condition_variable started_cv_;
+    size_t started_ = 0;
+    size_t pin_failures_ = 0;
+};
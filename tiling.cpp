@@ -0,0 +1,200 @@
+#include "tiling.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+
+#include "cpu_features.h"
+#include "saxpy.h"
+#include "tiling_backends.h"
+
+namespace {
+
+constexpr uint64_t CACHE_LINE_FLOATS = 64 / sizeof(float);
+
+// 候选的预取提前量：0（只靠硬件预取）和 256 B .. 8 KiB
+const uint64_t PREFETCH_CANDIDATES[] = {0, 256, 512, 1024, 2048, 4096, 8192};
+
+// 最小的候选分块：每个数组 4 KiB，X 和 Y 合起来也放得进最小的 L1
+constexpr uint64_t MIN_TILE_BYTES = 4096;
+
+double measure(ThreadPool& pool, Workspace& ws, const BenchConfig& cfg, const TileConfig& tile) {
+    return run_workload(pool, tiled_saxpy_workload(ws, cfg, tile), cfg).bandwidth_gbs();
+}
+
+} // namespace
+
+const std::vector<PrefetchSaxpyKernel>& prefetch_saxpy_kernels() {
+    static const std::vector<PrefetchSaxpyKernel> kernels = [] {
+        const CpuFeatures& cpu = cpu_features();
+        std::vector<PrefetchSaxpyKernel> out;
+        if (cpu.sve) {
+            out.insert(out.end(), sve_prefetch_saxpy_table().begin(), sve_prefetch_saxpy_table().end());
+        }
+        if (cpu.avx512f) {
+            out.insert(out.end(), avx512_prefetch_saxpy_table().begin(), avx512_prefetch_saxpy_table().end());
+        }
+        out.insert(out.end(), autovec_prefetch_saxpy_table().begin(), autovec_prefetch_saxpy_table().end());
+        return out;
+    }();
+    return kernels;
+}
+
+std::string describe_tile(const TileConfig& tile) {
+    return "tile " + (tile.tile_bytes ? format_size(tile.tile_bytes) : std::string("none")) + ", prefetch " +
+           (tile.prefetch_bytes ? format_size(tile.prefetch_bytes) : std::string("none"));
+}
+
+Workload tiled_saxpy_workload(Workspace& ws, const BenchConfig& config, const TileConfig& tile) {
+    // 流量、拷贝阶段与普通 SAXPY 完全相同，只替换计算阶段
+    Workload work = saxpy_workload(ws, config);
+    // 分块按线程自己的数据块进行，只支持静态划分
+    work.scheduler.reset();
+    // 分块内核用普通存储：非原地写 Y 时有写分配读
+    work.write_allocate_bytes_per_element = config.mode == MeasureMode::DoubleBuffer ? sizeof(float) : 0.0;
+
+    const PrefetchSaxpyFn fn = prefetch_saxpy_kernels().front().fn;
+    const float a = config.a;
+    const MeasureMode mode = config.mode;
+    // 按缓存行对齐的小块，小块之间不共享缓存行；不足一行时按一行算
+    const uint64_t tile_elements =
+        tile.tile_bytes ? std::max(tile.tile_elements() / CACHE_LINE_FLOATS * CACHE_LINE_FLOATS, CACHE_LINE_FLOATS) : 0;
+    const uint64_t prefetch = tile.prefetch_bytes;
+    work.body = [&ws, fn, a, mode, tile_elements, prefetch](size_t tid, size_t reps) {
+        const Range& r = ws.chunks()[tid];
+        const uint64_t step = tile_elements ? tile_elements : r.size();
+        // 每次调用都是整个数据块的一遍扫描，小块只切分这一遍内的循环和预取
+        for (size_t rep = 0; rep < reps; ++rep) {
+            for (uint64_t begin = r.begin; begin < r.end; begin += step) {
+                const uint64_t n = std::min<uint64_t>(step, r.end - begin);
+                const float* x = ws.x() + begin;
+                float* y = ws.y() + begin;
+                const float* src = mode == MeasureMode::Kernel ? y : ws.y_original() + begin;
+                fn(a, x, src, y, n, prefetch);
+            }
+        }
+    };
+    return work;
+}
+
+BenchResult run_tiled_benchmark(ThreadPool& pool, Workspace& ws, const BenchConfig& config, const TileConfig& tile) {
+    return run_workload(pool, tiled_saxpy_workload(ws, config, tile), config);
+}
+
+TileTuning tune_tiling(ThreadPool& pool, Workspace& ws, const BenchConfig& config, double seconds_per_trial,
+                       std::ostream* progress) {
+    // 只沿用决定测量形状的字段；计数器和进度行不适用于一次次短测量
+    BenchConfig cfg;
+    cfg.a = config.a;
+    cfg.mode = config.mode;
+    cfg.inner_reps = config.inner_reps;
+    cfg.target_seconds = seconds_per_trial;
+    cfg.warmup_iterations = std::min<long long>(config.warmup_iterations, 2);
+
+    size_t chunk_bytes = 0;
+    for (const Range& r : ws.chunks()) {
+        chunk_bytes = std::max(chunk_bytes, r.size() * sizeof(float));
+    }
+    std::vector<uint64_t> tiles = {0};
+    for (uint64_t bytes = MIN_TILE_BYTES; bytes < chunk_bytes; bytes *= 2) {
+        tiles.push_back(bytes);
+    }
+
+    TileTuning tuning;
+    auto trial = [&](const TileConfig& tile) {
+        for (const TileTrial& t : tuning.trials) {
+            if (t.tile.tile_bytes == tile.tile_bytes && t.tile.prefetch_bytes == tile.prefetch_bytes) {
+                return; // 坐标搜索的第三轮会重复第一轮已经测过的点
+            }
+        }
+        TileTrial t;
+        t.tile = tile;
+        t.gbs = measure(pool, ws, cfg, tile);
+        tuning.trials.push_back(t);
+        if (tile.tile_bytes == 0 && tile.prefetch_bytes == 0) {
+            tuning.baseline_gbs = t.gbs;
+        }
+        if (t.gbs > tuning.best_gbs) {
+            tuning.best_gbs = t.gbs;
+            tuning.best = tile;
+        }
+        if (progress) {
+            *progress << "  " << std::left << std::setw(36) << describe_tile(tile) << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(10) << t.gbs << " GB/s" << std::defaultfloat
+                      << std::setprecision(6) << std::endl;
+        }
+    };
+
+    // 坐标搜索：先在不分块时选预取距离，再按选定的预取选分块，最后在选定的分块上再调一次预取。
+    // 两个参数的影响大体可分离，这样只需要约 2 * 7 + 分块个数 次测量，而不是完整的网格
+    for (uint64_t prefetch : PREFETCH_CANDIDATES) {
+        trial(TileConfig{0, prefetch});
+    }
+    const uint64_t first_prefetch = tuning.best.prefetch_bytes;
+    for (size_t k = 1; k < tiles.size(); ++k) {
+        trial(TileConfig{tiles[k], first_prefetch});
+    }
+    const uint64_t chosen_tile = tuning.best.tile_bytes;
+    if (chosen_tile != 0) {
+        for (uint64_t prefetch : PREFETCH_CANDIDATES) {
+            trial(TileConfig{chosen_tile, prefetch});
+        }
+    }
+    return tuning;
+}
+
+std::string tiling_cache_key(const BenchConfig& config, size_t elements, size_t threads) {
+    const CpuFeatures& cpu = cpu_features();
+    const PrefetchSaxpyKernel& kernel = prefetch_saxpy_kernels().front();
+    const SaxpyBackend* backend = find_saxpy_backend(kernel.backend);
+    const unsigned vector_bits = cpu.sve ? cpu.sve_vector_bytes * 8 : backend ? backend->vector_bits : 0;
+    return "tiling cpu=" + cpu.model + "; isa=" + kernel.backend + "; vl=" + std::to_string(vector_bits) +
+           "; threads=" + std::to_string(threads) + "; mode=" + measure_mode_name(config.mode) +
+           "; footprint=" + footprint_key(elements * footprint_bytes_per_element(config.mode)) + "; reps=" + std::to_string(config.inner_reps);
+}
+
+bool load_tile_config(const TuningCache& cache, const std::string& key, TileConfig& tile) {
+    const auto* entries = cache.find(key);
+    if (!entries) {
+        return false;
+    }
+    bool have_tile = false;
+    bool have_prefetch = false;
+    TileConfig parsed;
+    for (const auto& entry : *entries) {
+        char* end = nullptr;
+        const unsigned long long value = std::strtoull(entry.second.c_str(), &end, 10);
+        if (entry.second.empty() || *end != '\0') {
+            continue;
+        }
+        if (entry.first == "tile_bytes") {
+            parsed.tile_bytes = value;
+            have_tile = true;
+        } else if (entry.first == "prefetch_bytes") {
+            parsed.prefetch_bytes = value;
+            have_prefetch = true;
+        }
+    }
+    if (!have_tile || !have_prefetch) {
+        return false;
+    }
+    tile = parsed;
+    return true;
+}
+
+void store_tile_config(TuningCache& cache, const std::string& key, const TileTuning& tuning) {
+    char gbs[32];
+    char baseline[32];
+    std::snprintf(gbs, sizeof(gbs), "%.3f", tuning.best_gbs);
+    std::snprintf(baseline, sizeof(baseline), "%.3f", tuning.baseline_gbs);
+    cache.set(key, {
+        {"tile_bytes", std::to_string(tuning.best.tile_bytes)},
+        {"prefetch_bytes", std::to_string(tuning.best.prefetch_bytes)},
+        {"kernel", prefetch_saxpy_kernels().front().name},
+        {"gbs", gbs},
+        {"baseline_gbs", baseline},
+        {"trials", std::to_string(tuning.trials.size())},
+    });
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "thread_pool.h"
+#include "tuning_cache.h"
+
+/**
+ * @brief 带可调预取距离的 SAXPY：Y_out = a * X + Y_in，每步对 X / Y_in 提前 prefetch_bytes 字节发出软件预取
+ *
+ * prefetch_bytes 为 0 时不预取，与普通的 4 倍展开内核相同。原地计算时 y_in 与 y_out 指向同一块内存。
+ * 预取指令不会因越界地址触发异常，末尾不需要特殊处理。
+ */
+using PrefetchSaxpyFn = void (*)(float a, const float* x, const float* y_in, float* y_out, uint64_t n,
+                                 uint64_t prefetch_bytes);
+
+struct PrefetchSaxpyKernel {
+    const char* name;
+    const char* backend;
+    const char* description;
+    PrefetchSaxpyFn fn;
+};
+
+/**
+ * @brief 本机可用的可调预取 SAXPY 内核，按后端优先级排列（sve > avx512 > autovec）；第一个是默认内核
+ */
+const std::vector<PrefetchSaxpyKernel>& prefetch_saxpy_kernels();
+
+/**
+ * @brief 分块执行的配置
+ *
+ * 每个线程把自己的数据块切成 tile_bytes（每个数组的字节数）大小的小块，每次调用按地址顺序
+ * 依次处理各个小块，仍是对整个数据块的一遍流式扫描；一次分发中的 inner_reps 次调用各自完整扫描一遍，
+ * 不在调用之间复用缓存中的小块，结果与不分块逐元素完全相同。
+ * prefetch_bytes 是小块内软件预取的提前量。
+ */
+struct TileConfig {
+    uint64_t tile_bytes = 0;        // 0 = 不分块：整个数据块是一个小块
+    uint64_t prefetch_bytes = 0;    // 0 = 不预取
+
+    uint64_t tile_elements() const { return tile_bytes / sizeof(float); }
+};
+
+// 例如 "tile 64.0 KiB, prefetch 1.0 KiB"；不分块 / 不预取时写 none
+std::string describe_tile(const TileConfig& tile);
+
+/**
+ * @brief 分块 SAXPY 的 Workload：按 config.a / mode 在 ws 上计算，使用 prefetch_saxpy_kernels() 的默认内核
+ *
+ * 流量与普通 SAXPY 相同（每次调用 3 个 float / 元素），GB/s 与其他内核直接可比。
+ * tile_bytes 向下取整到缓存行的整数倍。
+ */
+Workload tiled_saxpy_workload(Workspace& ws, const BenchConfig& config, const TileConfig& tile);
+
+/**
+ * @brief 按配置运行分块 SAXPY；返回时 Y 恰好等于一次调用的结果，可以直接用 verify_saxpy 验证
+ */
+BenchResult run_tiled_benchmark(ThreadPool& pool, Workspace& ws, const BenchConfig& config, const TileConfig& tile);
+
+/**
+ * @brief 一个候选配置的调优结果
+ */
+struct TileTrial {
+    TileConfig tile;
+    double gbs = 0.0;
+};
+
+struct TileTuning {
+    TileConfig best;
+    double best_gbs = 0.0;
+    double baseline_gbs = 0.0;          // 不分块、不预取
+    std::vector<TileTrial> trials;
+};
+
+/**
+ * @brief 在 ws 上按 config（inner_reps、mode、a）逐个测量候选配置，每个 seconds_per_trial 秒，取 GB/s 最高者
+ *
+ * 候选分块从 4 KiB 按 2 倍增长到每个线程的数据块大小，外加不分块；预取距离为 0 和 256 B .. 8 KiB。
+ * 按坐标搜索：先在不分块时选预取，再选分块，最后在选定的分块上重新选预取。progress 非空时打印每个候选的结果。
+ */
+TileTuning tune_tiling(ThreadPool& pool, Workspace& ws, const BenchConfig& config, double seconds_per_trial,
+                       std::ostream* progress = nullptr);
+
+/**
+ * @brief 调优缓存中分块配置的键：CPU 型号、向量宽度、线程数、测量模式、工作集（按 2 的幂取整）和 inner_reps
+ *
+ * 同一台机器上相同形状的运行共用一个结果。
+ */
+std::string tiling_cache_key(const BenchConfig& config, size_t elements, size_t threads);
+
+// 从缓存中读取 key 对应的分块配置；不存在或格式不对时返回 false
+bool load_tile_config(const TuningCache& cache, const std::string& key, TileConfig& tile);
+
+// 把调优结果写入缓存的 key 节（不落盘，需要再调用 save()）
+void store_tile_config(TuningCache& cache, const std::string& key, const TileTuning& tuning);
@@ -0,0 +1,44 @@
+#include "tiling_backends.h"
+
+// 本文件和 saxpy_autovec.cpp 一样用 -O3 -ftree-vectorize 编译；y_in 和 y_out 在原地模式下相同，不能加 __restrict
+
+namespace {
+
+// 每次处理一个缓存行（16 个 float），行首用 __builtin_prefetch 预取提前 ahead 个元素的 X / Y_in；
+// 行内的固定长度循环由编译器向量化
+template <bool PREFETCH>
+void saxpy_tiled(float a, const float* x, const float* y_in, float* y_out, uint64_t n, uint64_t ahead) {
+    constexpr uint64_t LINE = 64 / sizeof(float);
+    uint64_t i = 0;
+    for (; i + LINE <= n; i += LINE) {
+        if (PREFETCH) {
+            __builtin_prefetch(x + i + ahead, 0, 3);
+            __builtin_prefetch(y_in + i + ahead, 0, 3);
+        }
+        for (uint64_t j = 0; j < LINE; ++j) {
+            y_out[i + j] = a * x[i + j] + y_in[i + j];
+        }
+    }
+    for (; i < n; ++i) {
+        y_out[i] = a * x[i] + y_in[i];
+    }
+}
+
+void saxpy_tiled_autovec(float a, const float* x, const float* y_in, float* y_out, uint64_t n,
+                         uint64_t prefetch_bytes) {
+    if (prefetch_bytes > 0) {
+        saxpy_tiled<true>(a, x, y_in, y_out, n, prefetch_bytes / sizeof(float));
+    } else {
+        saxpy_tiled<false>(a, x, y_in, y_out, n, 0);
+    }
+}
+
+} // namespace
+
+const std::vector<PrefetchSaxpyKernel>& autovec_prefetch_saxpy_table() {
+    static const std::vector<PrefetchSaxpyKernel> table = {
+        {"tiled_autovec", "autovec", "compiler-vectorized loop, __builtin_prefetch at a tunable distance",
+         saxpy_tiled_autovec},
+    };
+    return table;
+}
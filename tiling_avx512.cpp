@@ -0,0 +1,66 @@
+#include "tiling_backends.h"
+
+// 本文件用 -mavx512f 单独编译
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+namespace {
+
+// 与 saxpy_avx512.cpp 相同的 4 倍展开；每步正好 4 个缓存行，对 X / Y_in 各预取提前 ahead 个元素的 4 行
+template <bool PREFETCH>
+void saxpy_tiled(float a, const float* x, const float* y_in, float* y_out, uint64_t n, uint64_t ahead) {
+    const __m512 va = _mm512_set1_ps(a);
+    uint64_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        if (PREFETCH) {
+            for (int k = 0; k < 64; k += 16) {
+                _mm_prefetch(reinterpret_cast<const char*>(x + i + ahead + k), _MM_HINT_T0);
+                _mm_prefetch(reinterpret_cast<const char*>(y_in + i + ahead + k), _MM_HINT_T0);
+            }
+        }
+        __m512 r0 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i),      _mm512_loadu_ps(y_in + i));
+        __m512 r1 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y_in + i + 16));
+        __m512 r2 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(y_in + i + 32));
+        __m512 r3 = _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(y_in + i + 48));
+        _mm512_storeu_ps(y_out + i,      r0);
+        _mm512_storeu_ps(y_out + i + 16, r1);
+        _mm512_storeu_ps(y_out + i + 32, r2);
+        _mm512_storeu_ps(y_out + i + 48, r3);
+    }
+    for (; i < n; i += 16) {
+        uint64_t left = n - i;
+        __mmask16 m = left >= 16 ? static_cast<__mmask16>(0xFFFF)
+                                 : static_cast<__mmask16>((1u << left) - 1);
+        __m512 vx = _mm512_maskz_loadu_ps(m, x + i);
+        __m512 vy = _mm512_maskz_loadu_ps(m, y_in + i);
+        _mm512_mask_storeu_ps(y_out + i, m, _mm512_fmadd_ps(va, vx, vy));
+    }
+}
+
+void saxpy_tiled_avx512(float a, const float* x, const float* y_in, float* y_out, uint64_t n,
+                        uint64_t prefetch_bytes) {
+    if (prefetch_bytes > 0) {
+        saxpy_tiled<true>(a, x, y_in, y_out, n, prefetch_bytes / sizeof(float));
+    } else {
+        saxpy_tiled<false>(a, x, y_in, y_out, n, 0);
+    }
+}
+
+} // namespace
+
+const std::vector<PrefetchSaxpyKernel>& avx512_prefetch_saxpy_table() {
+    static const std::vector<PrefetchSaxpyKernel> table = {
+        {"tiled_avx512", "avx512", "4x unrolled vfmadd, prefetcht0 at a tunable distance", saxpy_tiled_avx512},
+    };
+    return table;
+}
+
+#else
+
+const std::vector<PrefetchSaxpyKernel>& avx512_prefetch_saxpy_table() {
+    static const std::vector<PrefetchSaxpyKernel> empty;
+    return empty;
+}
+
+#endif // __AVX512F__
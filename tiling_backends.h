@@ -0,0 +1,11 @@
+#pragma once
+
+#include <vector>
+
+#include "tiling.h"
+
+// 可调预取 SAXPY 各后端的表；约定同 saxpy_backends.h：
+// 每个表定义在对应 ISA 的翻译单元里，只能在 cpu_features() 确认 CPU 支持后才能调用。
+const std::vector<PrefetchSaxpyKernel>& sve_prefetch_saxpy_table();
+const std::vector<PrefetchSaxpyKernel>& avx512_prefetch_saxpy_table();
+const std::vector<PrefetchSaxpyKernel>& autovec_prefetch_saxpy_table();
@@ -0,0 +1,72 @@
+#include "timer.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#if defined(__x86_64__)
+// CPUID.80000007H:EDX[8]：TSC 频率恒定，不随 P-state / C-state 变化
+bool invariant_tsc() {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (edx & (1u << 8)) != 0;
+}
+
+// 对照 steady_clock 在约 20ms 内标定 TSC 频率
+double measure_tsc_frequency() {
+    auto c0 = Clock::now();
+    uint64_t t0 = read_ticks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto c1 = Clock::now();
+    uint64_t t1 = read_ticks();
+    double seconds = std::chrono::duration<double>(c1 - c0).count();
+    return (t1 - t0) / seconds;
+}
+#endif
+
+uint64_t measure_overhead() {
+    constexpr int SAMPLES = 1000;
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < SAMPLES; ++i) {
+        uint64_t t0 = read_ticks();
+        uint64_t t1 = read_ticks();
+        best = std::min(best, t1 - t0);
+    }
+    return best;
+}
+
+TimerInfo calibrate() {
+    TimerInfo info;
+#if defined(__aarch64__)
+    uint64_t freq;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    info.source = "cntvct_el0";
+    info.ticks_per_second = static_cast<double>(freq);
+#elif defined(__x86_64__)
+    info.source = "rdtsc";
+    info.reliable = invariant_tsc();
+    info.ticks_per_second = measure_tsc_frequency();
+#else
+    info.source = "steady_clock";
+    info.ticks_per_second = 1e9;
+#endif
+    info.seconds_per_tick = 1.0 / info.ticks_per_second;
+    info.overhead_ticks = measure_overhead();
+    return info;
+}
+
+} // namespace
+
+const TimerInfo& timer_info() {
+    static const TimerInfo info = calibrate();
+    return info;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief 低开销计时：直接读硬件计数器，换算和开销校准只做一次
+ *
+ * - aarch64: 通用定时器 cntvct_el0，频率来自 cntfrq_el0。前置 isb 防止读数被提前执行。
+ * - x86_64:  rdtsc（要求 invariant TSC），频率对照 steady_clock 标定。前置 lfence。
+ * - 其他:    退回 std::chrono::steady_clock，一个 tick 为 1ns。
+ *
+ * 测量循环里只调用 read_ticks()，差值在计时区间结束后再减去读数开销并换算成秒。
+ */
+inline uint64_t read_ticks() {
+#if defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks) : : "memory");
+    return ticks;
+#elif defined(__x86_64__)
+    _mm_lfence();
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+struct TimerInfo {
+    const char* source = "";          // cntvct_el0 / rdtsc / steady_clock
+    double ticks_per_second = 1e9;
+    double seconds_per_tick = 1e-9;
+    uint64_t overhead_ticks = 0;      // 连续两次 read_ticks() 的最小差值
+    bool reliable = true;             // x86 上 TSC 不是 invariant 时为 false
+
+    double overhead_ns() const { return overhead_ticks * seconds_per_tick * 1e9; }
+    double resolution_ns() const { return seconds_per_tick * 1e9; }
+
+    // 一个计时区间 [start, end) 的净时长：减去读数开销，不会小于 0
+    uint64_t net_ticks(uint64_t start, uint64_t end) const {
+        uint64_t raw = end - start;
+        return raw > overhead_ticks ? raw - overhead_ticks : 0;
+    }
+    double seconds(uint64_t ticks) const { return ticks * seconds_per_tick; }
+};
+
+/**
+ * @brief 计时器参数；第一次调用时完成频率和开销校准（约 20ms），之后直接返回
+ */
+const TimerInfo& timer_info();
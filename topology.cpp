@@ -0,0 +1,225 @@
+#include "topology.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <dirent.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace {
+
+// 解析形如 "0-3,8-11" 的 cpulist 格式
+std::vector<int> parse_cpulist(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item == "\n") {
+            continue;
+        }
+        size_t dash = item.find('-');
+        try {
+            if (dash == std::string::npos) {
+                cpus.push_back(std::stoi(item));
+            } else {
+                int lo = std::stoi(item.substr(0, dash));
+                int hi = std::stoi(item.substr(dash + 1));
+                for (int c = lo; c <= hi; ++c) {
+                    cpus.push_back(c);
+                }
+            }
+        } catch (const std::exception&) {
+            // 格式异常时忽略该段
+        }
+    }
+    return cpus;
+}
+
+// CPU -> NUMA 节点映射；读取 sysfs 失败时返回空表（调用方视为节点 0）
+std::map<int, int> cpu_to_node_map() {
+    std::map<int, int> mapping;
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (dir == nullptr) {
+        return mapping;
+    }
+    while (dirent* entry = readdir(dir)) {
+        int node = 0;
+        if (std::sscanf(entry->d_name, "node%d", &node) != 1) {
+            continue;
+        }
+        std::ifstream in(std::string("/sys/devices/system/node/") + entry->d_name + "/cpulist");
+        std::string line;
+        if (!std::getline(in, line)) {
+            continue;
+        }
+        for (int cpu : parse_cpulist(line)) {
+            mapping[cpu] = node;
+        }
+    }
+    closedir(dir);
+    return mapping;
+}
+
+// 读取 sysfs 中的一行文本，失败时返回空串
+std::string read_line(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+// "48K" / "32M" 形式的缓存大小
+size_t parse_cache_size(const std::string& text) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str()) {
+        return 0;
+    }
+    switch (*end) {
+        case 'K': return static_cast<size_t>(value) << 10;
+        case 'M': return static_cast<size_t>(value) << 20;
+        case 'G': return static_cast<size_t>(value) << 30;
+        default: return static_cast<size_t>(value);
+    }
+}
+
+} // namespace
+
+std::vector<CpuSlot> allowed_cpus() {
+    std::map<int, int> node_of = cpu_to_node_map();
+
+    std::vector<CpuSlot> slots;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                auto it = node_of.find(cpu);
+                slots.push_back({cpu, it == node_of.end() ? 0 : it->second});
+            }
+        }
+    }
+
+    std::sort(slots.begin(), slots.end(), [](const CpuSlot& l, const CpuSlot& r) {
+        return l.node != r.node ? l.node < r.node : l.cpu < r.cpu;
+    });
+    return slots;
+}
+
+std::vector<CpuSlot> select_cpus(size_t count) {
+    return select_cpus(count, allowed_cpus());
+}
+
+std::vector<CpuSlot> select_cpus(size_t count, const std::vector<CpuSlot>& cpus) {
+    std::vector<CpuSlot> selected;
+    if (cpus.empty() || count == 0) {
+        return selected;
+    }
+
+    // 按节点分组
+    std::vector<std::vector<CpuSlot>> by_node;
+    for (const CpuSlot& slot : cpus) {
+        if (by_node.empty() || by_node.back().front().node != slot.node) {
+            by_node.emplace_back();
+        }
+        by_node.back().push_back(slot);
+    }
+
+    // 把线程均匀分配到各节点，前 remainder 个节点多分一个
+    size_t nodes = by_node.size();
+    for (size_t n = 0; n < nodes; ++n) {
+        size_t share = count / nodes + (n < count % nodes ? 1 : 0);
+        for (size_t i = 0; i < share; ++i) {
+            selected.push_back(by_node[n][i % by_node[n].size()]);
+        }
+    }
+    return selected;
+}
+
+std::vector<CpuSlot> partition_cpus(const std::vector<CpuSlot>& cpus, size_t parts, size_t index) {
+    if (cpus.empty() || parts <= 1) {
+        return cpus;
+    }
+    if (cpus.size() < parts) {
+        return {cpus[index % cpus.size()]};
+    }
+    return std::vector<CpuSlot>(cpus.begin() + cpus.size() * index / parts,
+                                cpus.begin() + cpus.size() * (index + 1) / parts);
+}
+
+std::string format_cpu_list(const std::vector<CpuSlot>& cpus) {
+    std::vector<int> ids;
+    for (const CpuSlot& slot : cpus) {
+        ids.push_back(slot.cpu);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    std::string text;
+    for (size_t i = 0; i < ids.size();) {
+        size_t j = i;
+        while (j + 1 < ids.size() && ids[j + 1] == ids[j] + 1) {
+            ++j;
+        }
+        text += (text.empty() ? "" : ",") + std::to_string(ids[i]);
+        if (j > i) {
+            text += "-" + std::to_string(ids[j]);
+        }
+        i = j + 1;
+    }
+    return text;
+}
+
+int numa_node_count() {
+    int count = 1;
+    for (const auto& entry : cpu_to_node_map()) {
+        count = std::max(count, entry.second + 1);
+    }
+    return count;
+}
+
+size_t last_level_cache_bytes(const std::vector<CpuSlot>& cpus) {
+    // 每个 CPU 的末级缓存：(级别, 共享该缓存的 CPU 列表) -> 大小
+    int top_level = 0;
+    std::map<std::string, size_t> instances;
+    for (const CpuSlot& slot : cpus) {
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(slot.cpu) + "/cache/index";
+        for (int index = 0;; ++index) {
+            const std::string dir = base + std::to_string(index) + "/";
+            const std::string level_text = read_line(dir + "level");
+            if (level_text.empty()) {
+                break;
+            }
+            if (read_line(dir + "type") == "Instruction") {
+                continue;
+            }
+            const int level = std::atoi(level_text.c_str());
+            if (level < top_level) {
+                continue;
+            }
+            if (level > top_level) {
+                top_level = level;
+                instances.clear();
+            }
+            instances[read_line(dir + "shared_cpu_list")] = parse_cache_size(read_line(dir + "size"));
+        }
+    }
+
+    size_t total = 0;
+    for (const auto& entry : instances) {
+        total += entry.second;
+    }
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    // 没有 sysfs 缓存信息（部分容器 / 虚拟机）时退回 glibc 的值，只计一个实例
+    if (total == 0) {
+        long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        total = l3 > 0 ? static_cast<size_t>(l3) : 0;
+    }
+#endif
+    return total;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 一个逻辑 CPU 及其所属的 NUMA 节点
+ */
+struct CpuSlot {
+    int cpu;   // 逻辑 CPU 编号
+    int node;  // NUMA 节点编号（无 NUMA 信息时为 0）
+};
+
+/**
+ * @brief 返回当前进程允许运行的所有 CPU（按 NUMA 节点、CPU 编号排序）
+ *
+ * 数据来自 sched_getaffinity 和 /sys/devices/system/node/node<N>/cpulist，
+ * 不依赖 libnuma。
+ */
+std::vector<CpuSlot> allowed_cpus();
+
+/**
+ * @brief 为 count 个线程挑选绑核位置
+ *
+ * 线程按节点均匀分布，并且同一节点上的线程编号连续，
+ * 这样静态划分出的连续数据块也会落在同一个节点上。
+ * count 大于可用 CPU 数时会循环复用（超额订阅）。
+ */
+std::vector<CpuSlot> select_cpus(size_t count);
+
+// 同上，但只在 cpus（按 allowed_cpus() 的顺序排列）中挑选
+std::vector<CpuSlot> select_cpus(size_t count, const std::vector<CpuSlot>& cpus);
+
+/**
+ * @brief 把 cpus 切成 parts 个互不重叠的连续段，返回第 index 段
+ *
+ * cpus 按节点排序，连续段尽量落在同一个节点上；CPU 数少于 parts 时每段只有一个 CPU（循环复用）。
+ */
+std::vector<CpuSlot> partition_cpus(const std::vector<CpuSlot>& cpus, size_t parts, size_t index);
+
+// 按 cpulist 格式输出 CPU 编号，例如 "0-3,8"
+std::string format_cpu_list(const std::vector<CpuSlot>& cpus);
+
+/**
+ * @brief 系统中的 NUMA 节点数量（至少为 1）
+ */
+int numa_node_count();
+
+/**
+ * @brief 这些 CPU 可以使用的末级缓存总容量（字节），未知时返回 0
+ *
+ * 读取 /sys/devices/system/cpu/cpu<N>/cache 中级别最高的数据 / 统一缓存，
+ * 按 shared_cpu_list 去重后求和：两个插槽各 32 MiB 的 L3 计为 64 MiB。
+ */
+size_t last_level_cache_bytes(const std::vector<CpuSlot>& cpus);
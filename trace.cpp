@@ -0,0 +1,171 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    uint64_t begin;
+    uint64_t end;
+    long long arg;
+};
+
+// 一个线程的环形缓冲区；只有所属线程写入，导出时由主线程读取
+struct ThreadBuffer {
+    size_t id = 0;
+    std::string name;
+    std::vector<TraceEvent> events;
+    size_t next = 0;               // 下一个写入位置
+    uint64_t recorded = 0;         // 累计记录的事件数（含被覆盖的）
+};
+
+// 所有线程的缓冲区：由注册表持有，线程退出（例如调优时临时建立的线程池）后事件仍然保留
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    size_t capacity = 0;
+    uint64_t origin = 0;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+thread_local ThreadBuffer* local_buffer = nullptr;
+thread_local std::string local_name;
+
+ThreadBuffer* create_buffer() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->id = r.buffers.size();
+    buffer->name = local_name.empty() ? "thread " + std::to_string(buffer->id) : local_name;
+    buffer->events.resize(r.capacity);
+    r.buffers.push_back(std::move(buffer));
+    return r.buffers.back().get();
+}
+
+// JSON 字符串转义：事件名都是字面量，线程名来自本程序，只需处理引号、反斜杠和控制字符
+std::string quoted(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+} // namespace
+
+namespace trace_detail {
+
+std::atomic<bool> enabled{false};
+
+void record(const char* name, const char* category, uint64_t begin, uint64_t end, long long arg) {
+    ThreadBuffer* buffer = local_buffer;
+    if (!buffer) {
+        buffer = local_buffer = create_buffer();
+    }
+    buffer->events[buffer->next] = TraceEvent{name, category, begin, end, arg};
+    buffer->next = buffer->next + 1 == buffer->events.size() ? 0 : buffer->next + 1;
+    ++buffer->recorded;
+}
+
+} // namespace trace_detail
+
+void trace_enable(size_t events_per_thread) {
+    Registry& r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.capacity = std::max<size_t>(events_per_thread, 1);
+        if (r.origin == 0) {
+            r.origin = read_ticks();
+        }
+    }
+    trace_detail::enabled.store(true, std::memory_order_release);
+}
+
+void trace_set_thread_name(const std::string& name) {
+    local_name = name;
+    if (local_buffer) {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        local_buffer->name = name;
+    }
+}
+
+TraceStats trace_stats() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    TraceStats stats;
+    stats.threads = r.buffers.size();
+    for (const auto& buffer : r.buffers) {
+        const size_t kept = static_cast<size_t>(std::min<uint64_t>(buffer->recorded, buffer->events.size()));
+        stats.events += kept;
+        stats.dropped += static_cast<size_t>(buffer->recorded - kept);
+    }
+    return stats;
+}
+
+void write_chrome_trace(const std::string& path) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const TimerInfo& timer = timer_info();
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot write trace file: " + path);
+    }
+    // 微秒时间戳保留三位小数（纳秒精度）
+    auto us = [&](uint64_t ticks) { return timer.seconds(ticks) * 1e6; };
+    out.precision(3);
+    out << std::fixed;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& buffer : r.buffers) {
+        // 元数据事件：线程名和排序（按注册顺序，主线程通常在最前面）
+        out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"name\":\"thread_name\",\"args\":{\"name\":" << quoted(buffer->name) << "}},\n"
+            << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":" << buffer->id << "}}";
+        first = false;
+
+        const size_t kept = static_cast<size_t>(std::min<uint64_t>(buffer->recorded, buffer->events.size()));
+        std::vector<TraceEvent> events;
+        events.reserve(kept);
+        // 环形缓冲区里最旧的事件在 next 处（写满之后）
+        const size_t start = buffer->recorded > buffer->events.size() ? buffer->next : 0;
+        for (size_t k = 0; k < kept; ++k) {
+            events.push_back(buffer->events[(start + k) % buffer->events.size()]);
+        }
+        // 嵌套的作用域先结束的先记录；按开始时间排序，外层在前
+        std::stable_sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+            return a.begin != b.begin ? a.begin < b.begin : a.end > b.end;
+        });
+        for (const TraceEvent& e : events) {
+            const uint64_t begin = e.begin > r.origin ? e.begin - r.origin : 0;
+            out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id << ",\"name\":" << quoted(e.name)
+                << ",\"cat\":" << quoted(e.category) << ",\"ts\":" << us(begin) << ",\"dur\":" << us(e.end - e.begin);
+            if (e.arg != TRACE_NO_ARG) {
+                out << ",\"args\":{\"value\":" << e.arg << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    if (!out) {
+        throw std::runtime_error("Cannot write trace file: " + path);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "timer.h"
+
+/**
+ * @brief 进程内的阶段跟踪：作用域标记写入每个线程自己的环形缓冲区，结束时导出 Chrome trace JSON
+ *
+ * 用法：在需要观察的阶段开头构造一个 TraceScope，离开作用域时记录一个完整事件（"ph": "X"）。
+ * 未开启跟踪时一个标记只是一次 relaxed 读；开启后是两次 read_ticks() 和一次写入本线程的缓冲区，
+ * 不加锁、不分配内存（缓冲区在线程第一次记录时分配一次），可以放在逐次迭代的计时循环里。
+ * 缓冲区写满后覆盖最旧的事件，导出时报告丢弃的个数。
+ *
+ * 导出的文件可以直接在 chrome://tracing 或 ui.perfetto.dev 中打开，每个线程一行时间线。
+ */
+
+namespace trace_detail {
+extern std::atomic<bool> enabled;
+void record(const char* name, const char* category, uint64_t begin, uint64_t end, long long arg);
+} // namespace trace_detail
+
+// 没有参数的事件在导出时不带 args；预热迭代的序号为负，哨兵取不会用到的最小值
+constexpr long long TRACE_NO_ARG = LLONG_MIN;
+
+inline bool trace_enabled() { return trace_detail::enabled.load(std::memory_order_relaxed); }
+
+/**
+ * @brief 开启跟踪；每个线程最多保留 events_per_thread 个最近的事件。只应在主线程上、开始测量前调用
+ */
+void trace_enable(size_t events_per_thread);
+
+/**
+ * @brief 本线程在时间线上显示的名字，例如 "worker 3 (cpu 12)"；可以在开启跟踪之前调用
+ */
+void trace_set_thread_name(const std::string& name);
+
+/**
+ * @brief 把所有线程的事件写成 Chrome trace JSON（按时间排序，时间戳以第一次 trace_enable 为零点）
+ *
+ * 应在没有线程还在记录时调用。写入失败时抛出 std::runtime_error。
+ */
+void write_chrome_trace(const std::string& path);
+
+// 导出时的统计：记录的事件数和因缓冲区写满被覆盖的事件数
+struct TraceStats {
+    size_t threads = 0;
+    size_t events = 0;
+    size_t dropped = 0;
+};
+TraceStats trace_stats();
+
+/**
+ * @brief 作用域标记：构造时取时间戳，析构时记录事件。name / category 必须是字符串字面量
+ *
+ * arg 不为 TRACE_NO_ARG 时作为 args.value 导出，例如迭代序号或任务编号。
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, const char* category = "phase", long long arg = TRACE_NO_ARG)
+        : name_(name), category_(category), arg_(arg), begin_(trace_enabled() ? read_ticks() : 0) {}
+    ~TraceScope() {
+        if (begin_ != 0) {
+            trace_detail::record(name_, category_, begin_, read_ticks(), arg_);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    long long arg_;
+    uint64_t begin_;
+};
@@ -0,0 +1,253 @@
+#include "tuner.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+
+#include "benchmark.h"
+#include "cpu_features.h"
+#include "saxpy.h"
+#include "thread_pool.h"
+#include "timer.h"
+#include "topology.h"
+
+namespace {
+
+// 除默认页面外依次尝试的页面类型；1g 需要预留大页，几乎总是退回，不在候选里
+const PageMode PAGE_CANDIDATES[] = {PageMode::Transparent, PageMode::Huge2M};
+
+// 无 SVE 时取优先级最高的定宽后端
+unsigned host_vector_bits() {
+    const CpuFeatures& cpu = cpu_features();
+    if (cpu.sve) {
+        return cpu.sve_vector_bytes * 8;
+    }
+    return saxpy_backends().empty() ? 0 : saxpy_backends().front().vector_bits;
+}
+
+// 与 main 中单次运行的规则相同：每批至少是计时开销的 1000 倍，且不少于 10us
+double min_batch_seconds() {
+    return std::max(10e-6, 1000 * timer_info().overhead_ns() * 1e-9);
+}
+
+double measure_kernel(ThreadPool& pool, Workspace& ws, BenchConfig cfg, const SaxpyKernel& kernel, size_t batch,
+                      size_t& inner_reps) {
+    cfg.kernel = &kernel;
+    cfg.inner_reps = batch ? batch : calibrate_inner_reps(pool, ws, cfg, min_batch_seconds());
+    inner_reps = cfg.inner_reps;
+    return run_benchmark(pool, ws, cfg).bandwidth_gbs();
+}
+
+std::string threads_text(size_t threads) {
+    return std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+}
+
+} // namespace
+
+std::string host_tuning_key(const Options& opts) {
+    const size_t cores = std::max<size_t>(allowed_cpus().size(), 1);
+    return "host cpu=" + cpu_features().model + "; vl=" + std::to_string(host_vector_bits()) +
+           "; cores=" + std::to_string(cores) + "; mode=" + measure_mode_name(opts.mode) +
+           "; footprint=" + footprint_key(opts.elements * footprint_bytes_per_element(opts.mode)) +
+           "; batch=" + (opts.batch ? std::to_string(opts.batch) : std::string("auto"));
+}
+
+HostTuning tune_host(const Options& opts, double seconds_per_trial, std::ostream* progress) {
+    BenchConfig cfg;
+    cfg.a = opts.a;
+    cfg.mode = opts.mode;
+    cfg.target_seconds = seconds_per_trial;
+    cfg.warmup_iterations = std::min<long long>(opts.warmup, 2);
+
+    HostTuning tuning;
+    auto trial = [&](const char* stage, const std::string& description, double gbs, const TunedConfig& candidate) {
+        tuning.trials.push_back({stage, description, gbs});
+        if (tuning.trials.size() == 1) {
+            tuning.baseline_gbs = gbs;
+        }
+        if (gbs > tuning.best.gbs) {
+            tuning.best = candidate;
+            tuning.best.gbs = gbs;
+        }
+        if (progress) {
+            *progress << "  " << std::left << std::setw(9) << stage << std::setw(28) << description << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(10) << gbs << " GB/s" << std::defaultfloat
+                      << std::setprecision(6) << std::endl;
+        }
+    };
+
+    AllocPolicy alloc = opts.alloc;
+    alloc.pages = PageMode::Default;
+    const SaxpyKernel& default_kernel = saxpy_kernels().front();
+
+    // 1. 线程数：默认内核、默认页面。带宽通常在核数用满之前就饱和
+    const size_t cores = std::max<size_t>(allowed_cpus().size(), 1);
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < cores; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(cores);
+    for (size_t n : counts) {
+        ThreadPool pool(select_cpus(n));
+        Workspace ws(pool, opts.elements, alloc);
+        TunedConfig candidate;
+        candidate.kernel = default_kernel.name;
+        candidate.threads = n;
+        const double gbs = measure_kernel(pool, ws, cfg, default_kernel, opts.batch, candidate.inner_reps);
+        trial("threads", threads_text(n), gbs, candidate);
+    }
+
+    // 后面几级都在选定线程数的同一个线程池上进行
+    ThreadPool pool(select_cpus(tuning.best.threads));
+
+    // 2. 内核：本机全部 SAXPY 内核（含流式存储和定长 SVE 变体）
+    {
+        Workspace ws(pool, opts.elements, alloc);
+        const TunedConfig base = tuning.best;
+        for (const SaxpyKernel& kernel : saxpy_kernels()) {
+            if (&kernel == &default_kernel) {
+                continue; // 第一级已经测过
+            }
+            TunedConfig candidate = base;
+            candidate.kernel = kernel.name;
+            const double gbs = measure_kernel(pool, ws, cfg, kernel, opts.batch, candidate.inner_reps);
+            trial("kernel", kernel.name, gbs, candidate);
+        }
+    }
+
+    // 3. 页面类型：分配没有得到所请求的页面（退回）时跳过，避免把退回后的结果记在大页名下
+    {
+        const TunedConfig base = tuning.best;
+        const SaxpyKernel* kernel = find_saxpy_kernel(base.kernel);
+        for (PageMode pages : PAGE_CANDIDATES) {
+            alloc.pages = pages;
+            Workspace ws(pool, opts.elements, alloc);
+            if (ws.memory().effective != pages) {
+                if (progress) {
+                    *progress << "  " << std::left << std::setw(9) << "pages" << std::setw(28) << page_mode_name(pages)
+                              << std::right << "   skipped (" << ws.memory().note << ")" << std::endl;
+                }
+                continue;
+            }
+            TunedConfig candidate = base;
+            candidate.pages = pages;
+            const double gbs = measure_kernel(pool, ws, cfg, *kernel, opts.batch, candidate.inner_reps);
+            trial("pages", std::string(page_mode_name(pages)) + " pages", gbs, candidate);
+        }
+    }
+
+    // 4. 分块 SAXPY：在选定的线程数和页面上调分块和预取，只有整体更快时才采用。
+    // 分块内核每次调用也是整个向量的一遍扫描，不在调用之间复用缓存，GB/s 与前几级的候选可比
+    {
+        const TunedConfig base = tuning.best;
+        alloc.pages = base.pages;
+        Workspace ws(pool, opts.elements, alloc);
+        cfg.inner_reps = opts.batch ? opts.batch
+                                    : calibrate_workload_reps(pool, tiled_saxpy_workload(ws, cfg, TileConfig{}),
+                                                              min_batch_seconds());
+        const TileTuning tiles = tune_tiling(pool, ws, cfg, seconds_per_trial);
+        TunedConfig candidate = base;
+        candidate.kernel = prefetch_saxpy_kernels().front().name;
+        candidate.tiled = true;
+        candidate.tile = tiles.best;
+        candidate.inner_reps = cfg.inner_reps;
+        trial("tiling", describe_tile(tiles.best), tiles.best_gbs, candidate);
+    }
+    return tuning;
+}
+
+bool load_tuned_config(const TuningCache& cache, const std::string& key, TunedConfig& config) {
+    const auto* entries = cache.find(key);
+    if (!entries) {
+        return false;
+    }
+    TunedConfig parsed;
+    bool have_kernel = false;
+    for (const auto& entry : *entries) {
+        const std::string& name = entry.first;
+        const std::string& value = entry.second;
+        if (name == "kernel") {
+            parsed.kernel = value;
+            have_kernel = !value.empty();
+        } else if (name == "pages") {
+            if (!parse_page_mode(value, parsed.pages)) {
+                return false;
+            }
+        } else if (name == "tiled") {
+            parsed.tiled = value == "1";
+        } else if (name == "gbs") {
+            parsed.gbs = std::strtod(value.c_str(), nullptr);
+        } else if (name == "threads" || name == "inner_reps" || name == "tile_bytes" || name == "prefetch_bytes") {
+            char* end = nullptr;
+            const unsigned long long n = std::strtoull(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0') {
+                return false;
+            }
+            if (name == "threads") {
+                parsed.threads = static_cast<size_t>(n);
+            } else if (name == "inner_reps") {
+                parsed.inner_reps = static_cast<size_t>(n);
+            } else if (name == "tile_bytes") {
+                parsed.tile.tile_bytes = n;
+            } else {
+                parsed.tile.prefetch_bytes = n;
+            }
+        }
+    }
+    // 内核名来自另一个构建时可能已经不存在；这种缓存项当作没有
+    const bool kernel_ok = parsed.tiled ? parsed.kernel == prefetch_saxpy_kernels().front().name
+                                        : find_saxpy_kernel(parsed.kernel) != nullptr;
+    if (!have_kernel || !kernel_ok || parsed.threads == 0 || parsed.inner_reps == 0) {
+        return false;
+    }
+    config = parsed;
+    return true;
+}
+
+void store_tuned_config(TuningCache& cache, const std::string& key, const HostTuning& tuning) {
+    const TunedConfig& best = tuning.best;
+    char gbs[32];
+    char baseline[32];
+    std::snprintf(gbs, sizeof(gbs), "%.3f", best.gbs);
+    std::snprintf(baseline, sizeof(baseline), "%.3f", tuning.baseline_gbs);
+    cache.set(key, {
+        {"kernel", best.kernel},
+        {"threads", std::to_string(best.threads)},
+        {"pages", page_mode_name(best.pages)},
+        {"tiled", best.tiled ? "1" : "0"},
+        {"tile_bytes", std::to_string(best.tile.tile_bytes)},
+        {"prefetch_bytes", std::to_string(best.tile.prefetch_bytes)},
+        {"inner_reps", std::to_string(best.inner_reps)},
+        {"gbs", gbs},
+        {"baseline_gbs", baseline},
+        {"trials", std::to_string(tuning.trials.size())},
+    });
+}
+
+void apply_tuned_config(Options& opts, const TunedConfig& config) {
+    opts.threads = config.threads;
+    opts.alloc.pages = config.pages;
+    opts.tile_auto = false;
+    opts.tiled = config.tiled;
+    if (config.tiled) {
+        opts.kernels = "auto";
+        opts.tile_bytes = config.tile.tile_bytes;
+        opts.prefetch_bytes = config.tile.prefetch_bytes;
+        opts.batch = config.inner_reps;
+    } else {
+        opts.kernels = config.kernel;
+        opts.tile_bytes = 0;
+        opts.prefetch_bytes = 0;
+    }
+}
+
+std::string describe_tuned_config(const TunedConfig& config) {
+    std::string text = config.kernel + ", " + threads_text(config.threads) + ", " + page_mode_name(config.pages) +
+                       " pages";
+    if (config.tiled) {
+        text += ", " + describe_tile(config.tile) + ", batch " + std::to_string(config.inner_reps);
+    }
+    return text;
+}
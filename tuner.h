@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "allocator.h"
+#include "cli.h"
+#include "tiling.h"
+#include "tuning_cache.h"
+
+/**
+ * @brief 本机上单个 SAXPY 运行的最佳配置
+ *
+ * tiled 为 true 时使用分块 SAXPY（kernel 为 tiled_* 内核名，tile 为其分块 / 预取配置），
+ * 否则 kernel 是 saxpy_kernels() 中的内核名。
+ */
+struct TunedConfig {
+    std::string kernel;
+    size_t threads = 1;
+    PageMode pages = PageMode::Default;
+    bool tiled = false;
+    TileConfig tile;
+    size_t inner_reps = 1;          // 调优时校准（或 --batch 给出）的每次分发调用次数
+    double gbs = 0.0;
+};
+
+/**
+ * @brief 调优中测过的一个候选
+ */
+struct TuningTrial {
+    std::string stage;              // threads / kernel / pages / tiling
+    std::string description;        // 候选的简短描述，例如 "4 threads"、"avx512_nt"
+    double gbs = 0.0;
+};
+
+struct HostTuning {
+    TunedConfig best;
+    double baseline_gbs = 0.0;      // 第一个候选：1 线程、默认内核、默认页面
+    std::vector<TuningTrial> trials;
+};
+
+/**
+ * @brief 调优缓存中主机配置的键：CPU 型号、向量宽度（SVE 为实际 VL）、可用核数，
+ *        加上决定最佳配置的运行形状（测量模式、按 2 的幂取整的工作集、--batch）
+ */
+std::string host_tuning_key(const Options& opts);
+
+/**
+ * @brief 按 opts 的向量长度、测量模式和 --batch，用短时测量逐级搜索最佳配置
+ *
+ * 依次确定：线程数（1、2、4 ... 直到全部可用核）→ 内核（本机全部 SAXPY 内核）→
+ * 页面类型（default / thp / 2m，实际退回为其他类型的候选跳过）→ 分块 SAXPY 的分块和预取（tune_tiling），
+ * 每一级固定前面已选定的维度，按 GB/s 取最高者。每个候选测量 seconds_per_trial 秒。
+ * 线程数不同的候选各自新建线程池和工作区，保证首次访问的 NUMA 位置与正式运行一致。
+ */
+HostTuning tune_host(const Options& opts, double seconds_per_trial, std::ostream* progress = nullptr);
+
+// 从缓存读取 key 对应的主机配置；不存在、格式不对或内核在本机不可用时返回 false
+bool load_tuned_config(const TuningCache& cache, const std::string& key, TunedConfig& config);
+
+// 把调优结果写入缓存的 key 节（不落盘，需要再调用 save()）
+void store_tuned_config(TuningCache& cache, const std::string& key, const HostTuning& tuning);
+
+/**
+ * @brief 用调优结果覆盖 opts 的线程数、内核、页面类型和分块配置
+ *
+ * 分块 SAXPY 胜出时同时固定 --batch，正式运行与调优时的每次分发调用次数相同。
+ */
+void apply_tuned_config(Options& opts, const TunedConfig& config);
+
+// 例如 "avx512_nt, 4 threads, thp pages"；分块时追加分块描述
+std::string describe_tuned_config(const TunedConfig& config);
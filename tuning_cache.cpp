@@ -0,0 +1,142 @@
+#include "tuning_cache.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    const size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    const size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// mkdir -p：逐级创建 path 所在的目录
+void make_parent_directories(const std::string& path) {
+    for (size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+        const std::string dir = path.substr(0, slash);
+        if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            throw std::runtime_error("Cannot create directory " + dir + ": " + std::strerror(errno));
+        }
+    }
+}
+
+} // namespace
+
+TuningCache TuningCache::load(const std::string& path) {
+    TuningCache cache;
+    cache.path_ = path;
+    std::ifstream in(path);
+    if (!in) {
+        return cache; // 还没有缓存文件
+    }
+    std::string line;
+    size_t number = 0;
+    while (std::getline(in, line)) {
+        ++number;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line.front() == '[' && line.back() == ']') {
+            cache.sections_.emplace_back(trim(line.substr(1, line.size() - 2)),
+                                         std::vector<std::pair<std::string, std::string>>{});
+            continue;
+        }
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos || cache.sections_.empty()) {
+            throw std::runtime_error("Malformed tuning cache " + path + " at line " + std::to_string(number));
+        }
+        cache.sections_.back().second.emplace_back(trim(line.substr(0, eq)), trim(line.substr(eq + 1)));
+    }
+    return cache;
+}
+
+void TuningCache::save() const {
+    make_parent_directories(path_);
+    // 先写临时文件再改名：并发运行的另一个进程要么看到旧文件，要么看到完整的新文件
+    const std::string tmp = path_ + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream out(tmp);
+        if (!out) {
+            throw std::runtime_error("Cannot write tuning cache: " + tmp);
+        }
+        out << "# perf_test tuning cache; delete an entry (or the file) to re-tune\n";
+        for (const auto& section : sections_) {
+            out << "\n[" << section.first << "]\n";
+            for (const auto& entry : section.second) {
+                out << entry.first << " = " << entry.second << "\n";
+            }
+        }
+        if (!out) {
+            throw std::runtime_error("Cannot write tuning cache: " + tmp);
+        }
+    }
+    if (std::rename(tmp.c_str(), path_.c_str()) != 0) {
+        const std::string reason = std::strerror(errno);
+        std::remove(tmp.c_str());
+        throw std::runtime_error("Cannot replace tuning cache " + path_ + ": " + reason);
+    }
+}
+
+const std::vector<std::pair<std::string, std::string>>* TuningCache::find(const std::string& section) const {
+    for (const auto& s : sections_) {
+        if (s.first == section) {
+            return &s.second;
+        }
+    }
+    return nullptr;
+}
+
+void TuningCache::set(const std::string& section, const std::vector<std::pair<std::string, std::string>>& values) {
+    for (auto& s : sections_) {
+        if (s.first == section) {
+            s.second = values;
+            return;
+        }
+    }
+    sections_.emplace_back(section, values);
+}
+
+std::string default_tuning_file() {
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) {
+        return std::string(xdg) + "/perf_test/tuning.ini";
+    }
+    const char* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::string(home) + "/.cache/perf_test/tuning.ini";
+    }
+    return "perf_test_tuning.ini";
+}
+
+std::string format_size(uint64_t bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB"};
+    int unit = 0;
+    double value = static_cast<double>(bytes);
+    while (value >= 1024.0 && unit < 3) {
+        value /= 1024.0;
+        ++unit;
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%g %s", value, units[unit]);
+    return buf;
+}
+
+std::string footprint_key(uint64_t bytes) {
+    uint64_t footprint = 1;
+    while (footprint < bytes) {
+        footprint *= 2;
+    }
+    return format_size(footprint);
+}
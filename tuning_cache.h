@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 调优缓存文件：INI 风格的文本，每个 [键] 一节，节内为 name = value
+ *
+ * 文件不存在时为空；写入时先写临时文件再改名，并创建所在目录。
+ * 读写失败时抛出 std::runtime_error。
+ */
+class TuningCache {
+public:
+    static TuningCache load(const std::string& path);
+    void save() const;
+
+    const std::string& path() const { return path_; }
+
+    // 节不存在时返回 nullptr
+    const std::vector<std::pair<std::string, std::string>>* find(const std::string& section) const;
+    // 替换整个节
+    void set(const std::string& section, const std::vector<std::pair<std::string, std::string>>& values);
+
+private:
+    std::string path_;
+    std::vector<std::pair<std::string, std::vector<std::pair<std::string, std::string>>>> sections_;
+};
+
+/**
+ * @brief 默认的调优缓存路径：$XDG_CACHE_HOME/perf_test/tuning.ini，没有时为 ~/.cache/perf_test/tuning.ini，
+ *        连 $HOME 也没有时为当前目录下的 perf_test_tuning.ini
+ */
+std::string default_tuning_file();
+
+// 2 的幂字节数的简短写法：256 B、64 KiB、2 MiB
+std::string format_size(uint64_t bytes);
+
+/**
+ * @brief 缓存键中的 footprint 字段：工作集字节数向上取整到 2 的幂，按 format_size 写出
+ *
+ * 规模相近的运行共用一个结果；主机调优和分块调优的键用同一种写法。
+ */
+std::string footprint_key(uint64_t bytes);
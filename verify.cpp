@@ -0,0 +1,54 @@
+#include "verify.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "timer.h"
+#include "trace.h"
+
+namespace {
+
+inline float reference(float a, float x, float y0) {
+    return static_cast<float>(static_cast<double>(a) * x + y0);
+}
+
+} // namespace
+
+size_t merge_ulp_scans(const std::vector<UlpScan>& partial, VerifyResult& result) {
+    size_t first = SIZE_MAX;
+    for (const UlpScan& c : partial) {
+        result.mismatches += c.mismatches;
+        result.max_ulp = std::max(result.max_ulp, c.max_ulp);
+        first = std::min(first, c.first_index);
+    }
+    if (first != SIZE_MAX) {
+        result.first_index = first;
+    }
+    return first;
+}
+
+VerifyResult verify_saxpy(ThreadPool& pool, Workspace& ws, float a, uint32_t tolerance_ulp) {
+    const uint64_t t0 = read_ticks();
+    std::vector<UlpScan> partial(pool.size());
+
+    pool.run([&](size_t tid) {
+        TraceScope scope("verify", "verify");
+        const Range& r = ws.chunks()[tid];
+        const float* x = ws.x();
+        const float* y = ws.y();
+        const float* y0 = ws.y_original();
+        partial[tid].scan(r.begin, r.end, tolerance_ulp,
+                          [&](size_t i) { return ulp_distance(reference(a, x[i], y0[i]), y[i]); });
+    });
+
+    VerifyResult result;
+    result.checked = ws.size();
+    result.tolerance_ulp = tolerance_ulp;
+    const size_t first = merge_ulp_scans(partial, result);
+    if (first != SIZE_MAX) {
+        result.first_expected = reference(a, ws.x()[first], ws.y_original()[first]);
+        result.first_got = ws.y()[first];
+    }
+    result.seconds = timer_info().seconds(read_ticks() - t0);
+    return result;
+}
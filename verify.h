@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "benchmark.h"
+#include "thread_pool.h"
+
+/**
+ * @brief 两个同一格式的浮点数按位模式相隔的可表示值个数，超过 UINT32_MAX 时饱和
+ *
+ * Bits 是与格式同宽的无符号整数（fp16 / bf16 为 uint16_t）。符号-数值表示映射成单调的整数，
+ * +0 与 -0 重合；不识别 NaN，由调用方处理。
+ */
+template <typename Bits>
+inline uint32_t ulp_between_bits(Bits a, Bits b) {
+    static_assert(std::is_unsigned<Bits>::value, "Bits must be an unsigned integer type");
+    const Bits sign = Bits(Bits(1) << (sizeof(Bits) * 8 - 1));
+    auto ordered = [sign](Bits bits) {
+        const Bits magnitude = Bits(bits & Bits(~sign));
+        return bits & sign ? Bits(sign - magnitude) : Bits(sign + magnitude);
+    };
+    const Bits oa = ordered(a), ob = ordered(b);
+    const uint64_t d = oa > ob ? oa - ob : ob - oa;
+    return d > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(d);
+}
+
+/**
+ * @brief float / double 的 ULP 距离；+0 与 -0 距离为 0，NaN 视为无穷远
+ */
+template <typename T>
+inline uint32_t ulp_distance_of(T a, T b) {
+    static_assert(std::is_floating_point<T>::value && (sizeof(T) == 4 || sizeof(T) == 8),
+                  "ulp_distance_of takes float or double");
+    using Bits = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+    Bits ba, bb;
+    std::memcpy(&ba, &a, sizeof(ba));
+    std::memcpy(&bb, &b, sizeof(bb));
+    return a != a || b != b ? UINT32_MAX : ulp_between_bits(ba, bb);
+}
+
+inline uint32_t ulp_distance(float a, float b) {
+    return ulp_distance_of(a, b);
+}
+
+/**
+ * @brief 一个线程的逐元素检查结果，按缓存行对齐避免伪共享
+ *
+ * scan() 按 4096 个元素分块：第一遍无分支地求距离、计数和最大值，便于向量化；
+ * 只有第一个出错的块才再扫一遍块内的距离找出第一个坏元素。ulp(i) 对每个元素恰好调用一次，
+ * 可以顺带累加别的参考值（例如点积）。
+ */
+struct alignas(64) UlpScan {
+    size_t mismatches = 0;           // ULP 距离超过容差的元素个数
+    uint32_t max_ulp = 0;
+    size_t first_index = SIZE_MAX;   // 第一个坏元素，没有时为 SIZE_MAX
+
+    template <typename UlpFn>
+    void scan(size_t begin, size_t end, uint32_t tolerance_ulp, UlpFn&& ulp) {
+        constexpr size_t BLOCK = 4096;
+        uint32_t d[BLOCK];
+        for (size_t block = begin; block < end; block += BLOCK) {
+            const size_t n = std::min(end - block, BLOCK);
+            uint32_t block_max = 0;
+            size_t block_bad = 0;
+            for (size_t i = 0; i < n; ++i) {
+                d[i] = ulp(block + i);
+                block_max = std::max(block_max, d[i]);
+                block_bad += d[i] > tolerance_ulp;
+            }
+            if (block_bad && first_index == SIZE_MAX) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (d[i] > tolerance_ulp) {
+                        first_index = block + i;
+                        break;
+                    }
+                }
+            }
+            max_ulp = std::max(max_ulp, block_max);
+            mismatches += block_bad;
+        }
+    }
+};
+
+struct VerifyResult {
+    size_t checked = 0;
+    size_t mismatches = 0;           // ULP 距离超过容差的元素个数
+    uint32_t max_ulp = 0;            // 全部元素中最大的 ULP 距离
+    uint32_t tolerance_ulp = 0;
+    double seconds = 0.0;
+    // 第一个不匹配的元素；mismatches == 0 时无意义
+    size_t first_index = 0;
+    double first_expected = 0.0;
+    double first_got = 0.0;
+    // 流水线的 Dot 阶段（verify_fusion）：超出误差上界的点积个数，以及第一个的阶段序号和数值；
+    // 与上面的元素字段分开，first_index 始终是元素下标
+    size_t dot_mismatches = 0;
+    size_t first_dot = 0;
+    double dot_expected = 0.0;
+    double dot_got = 0.0;
+
+    bool passed() const { return mismatches == 0 && dot_mismatches == 0; }
+};
+
+/**
+ * @brief 把各线程的结果合并进 result：mismatches 求和、max_ulp 取最大、first_index 取最小
+ *
+ * 返回第一个坏元素的下标（同时写入 result.first_index），没有时返回 SIZE_MAX；
+ * first_expected / first_got 由调用方按自己的参考值填写。
+ */
+size_t merge_ulp_scans(const std::vector<UlpScan>& partial, VerifyResult& result);
+
+/**
+ * @brief 逐元素检查整个 Y 是否等于 a * X + Y_original
+ *
+ * 参考值用 double 计算后舍入到 float（即正确舍入的结果），因此 FMA 与 乘+加 两种实现
+ * 通常都在 1 ULP 以内；a 为负、出现相消时非 FMA 实现的误差会变大，需要放宽 tolerance_ulp。
+ * 由线程池按计算阶段的划分并行检查，内层循环无分支，可被编译器向量化；不计入任何计时。
+ */
+VerifyResult verify_saxpy(ThreadPool& pool, Workspace& ws, float a, uint32_t tolerance_ulp);